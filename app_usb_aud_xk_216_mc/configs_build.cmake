@@ -43,4 +43,8 @@ set(APP_COMPILER_FLAGS_2AMi32o32xxsxxx_tdm8 ${SW_USB_AUDIO_FLAGS} -DI2S_CHANS_AD
 set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_tdm8 ${SW_USB_AUDIO_FLAGS} -DXUA_PCM_FORMAT=XUA_PCM_FORMAT_TDM
                                                                 -DMAX_FREQ=96000)
 
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, direct monitor mix and event trace, both over vendor requests
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_mon_trace ${SW_USB_AUDIO_FLAGS} -DDIRECT_MONITOR_ENABLE=1
+                                                                     -DEVENT_TRACE_ENABLE=1)
+
 endif()
@@ -43,4 +43,7 @@ set(APP_COMPILER_FLAGS_2AMi16o16xxxaax ${SW_USB_AUDIO_FLAGS} -DXUA_ADAT_RX_EN=1
                                                              -DXUA_ADAT_TX_EN=1
                                                              -DMAX_FREQ=96000)
 
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, zero-latency direct monitor mix (no mixes)
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_mon ${SW_USB_AUDIO_FLAGS} -DDIRECT_MONITOR_ENABLE=1)
+
 endif()
@@ -6,11 +6,63 @@
 #if HID_CONTROLS > 0
 void UserHIDPoll();
 
-#define USER_MAIN_CORES on tile[XUD_TILE]: {\
+#define HID_CORES on tile[XUD_TILE]: {\
                                         UserHIDPoll();\
                                     }
+#else
+#define HID_CORES
 #endif  // HID_CONTROLS > 0
 
+#if (DIRECT_MONITOR_ENABLE)
+extern unsafe chanend uc_directMonitor;
+
+/* The other end of c_directMonitor is passed to VendorRequests() (see VENDOR_REQUESTS_PARAMS) */
+#define DIRECT_MONITOR_DECLARATIONS chan c_directMonitor;
+
+#define DIRECT_MONITOR_CORES on tile[AUDIO_IO_TILE]: {\
+                                        unsafe\
+                                        {\
+                                            uc_directMonitor = (chanend) c_directMonitor;\
+                                        }\
+                                    }
+#else
+#define DIRECT_MONITOR_DECLARATIONS
+#define DIRECT_MONITOR_CORES
+#endif
+
+#if (EVENT_TRACE_ENABLE)
+/* Endpoint 0 reads the event trace of XUD_TILE itself and that of the other tile from
+ * AudioHwService(), which answers EventTraceCommand() between configuration sequences rather
+ * than taking a logical core for EventTraceTask() (shared/event_trace.h). The other end of
+ * c_eventTrace is passed to VendorRequests() (see VENDOR_REQUESTS_PARAMS) */
+#define EVENT_TRACE_DECLARATIONS chan c_eventTrace;
+#define EVENT_TRACE_SERVICE c_eventTrace
+#else
+#define EVENT_TRACE_DECLARATIONS
+#define EVENT_TRACE_SERVICE null
+#endif
+
+/* Codec service, owns the I2C bus. AudioHwInit() and AudioHwConfig() send it configuration
+ * sequences over c_audiohw. It also serves the event trace of its tile over c_eventTrace, if
+ * not null */
+void AudioHwService(chanend c, chanend ?c_eventTrace);
+
+extern unsafe chanend uc_audiohw;
+
+#define USER_MAIN_DECLARATIONS chan c_audiohw;\
+                               DIRECT_MONITOR_DECLARATIONS\
+                               EVENT_TRACE_DECLARATIONS
+
+#define USER_MAIN_CORES on tile[AUDIO_IO_TILE]: {\
+                                        unsafe\
+                                        {\
+                                            uc_audiohw = (chanend) c_audiohw;\
+                                        }\
+                                    }\
+                        on tile[AUDIO_IO_TILE]: AudioHwService(c_audiohw, EVENT_TRACE_SERVICE);\
+                        HID_CORES\
+                        DIRECT_MONITOR_CORES
+
 #endif
 
 #endif
@@ -53,6 +53,42 @@
 #define MAX_MIX_COUNT      (0)
 #endif
 
+/* Enable/Disable the zero-latency direct monitor mix (shared/direct_monitor.h) - Default is off */
+#ifndef DIRECT_MONITOR_ENABLE
+#define DIRECT_MONITOR_ENABLE (0)
+#endif
+
+/* Enable/Disable the event trace (shared/event_trace.h), read over a vendor request - Default is off */
+#ifndef EVENT_TRACE_ENABLE
+#define EVENT_TRACE_ENABLE (0)
+#endif
+
+/* Direct monitor and event trace are handled by VendorRequests(), which needs their control channels. Each enabled
+ * feature adds ", <channel>" to the list, the leading comma is dropped */
+#if (DIRECT_MONITOR_ENABLE)
+#define VENDOR_REQUESTS_DIRECT_MONITOR      , c_directMonitor
+#define VENDOR_REQUESTS_DIRECT_MONITOR_DEC  , chanend c_directMonitor
+#else
+#define VENDOR_REQUESTS_DIRECT_MONITOR
+#define VENDOR_REQUESTS_DIRECT_MONITOR_DEC
+#endif
+
+#if (EVENT_TRACE_ENABLE)
+#define VENDOR_REQUESTS_EVENT_TRACE         , c_eventTrace
+#define VENDOR_REQUESTS_EVENT_TRACE_DEC     , chanend c_eventTrace
+#else
+#define VENDOR_REQUESTS_EVENT_TRACE
+#define VENDOR_REQUESTS_EVENT_TRACE_DEC
+#endif
+
+#define VENDOR_REQUESTS_DROP_FIRST(first, ...)  __VA_ARGS__
+#define VENDOR_REQUESTS_LIST(...)               VENDOR_REQUESTS_DROP_FIRST(__VA_ARGS__)
+
+#if (DIRECT_MONITOR_ENABLE) || (EVENT_TRACE_ENABLE)
+#define VENDOR_REQUESTS_PARAMS      VENDOR_REQUESTS_LIST(VENDOR_REQUESTS_DIRECT_MONITOR VENDOR_REQUESTS_EVENT_TRACE)
+#define VENDOR_REQUESTS_PARAMS_DEC  VENDOR_REQUESTS_LIST(VENDOR_REQUESTS_DIRECT_MONITOR_DEC VENDOR_REQUESTS_EVENT_TRACE_DEC)
+#endif
+
 /* Audio Class version - Default is 2.0 */
 #ifndef AUDIO_CLASS
 #define AUDIO_CLASS        (2)
@@ -27,4 +27,49 @@ set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_mix8_vol_before ${SW_USB_AUDIO_FLAGS} -DMAX
                                                                            -DIN_VOLUME_IN_MIXER=1
                                                                            -DOUT_VOLUME_AFTER_MIX=0
                                                                            -DIN_VOLUME_AFTER_MIX=0)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, block DSP transport to dsp_main() (4 frame blocks)
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_dsp ${SW_USB_AUDIO_FLAGS} -DDSP_ENABLE=1
+                                                               -DDSP_BLOCK_SIZE=4)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, block DSP transport to dsp_main(), DSP channels split over 4 threads
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_dsp_par4 ${SW_USB_AUDIO_FLAGS} -DDSP_ENABLE=1
+                                                                    -DDSP_BLOCK_SIZE=4
+                                                                    -DDSP_NUM_THREADS=4)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, block DSP transport to dsp_main(), biquad EQ on outputs
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_dsp_eq ${SW_USB_AUDIO_FLAGS} -DDSP_ENABLE=1
+                                                                  -DDSP_BLOCK_SIZE=4
+                                                                  -DDSP_EQ_ENABLE=1)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, block DSP transport to dsp_main(), 4k tap FIR on outputs 1-2 (48kHz max)
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_dsp_conv ${SW_USB_AUDIO_FLAGS} -DDSP_ENABLE=1
+                                                                    -DDSP_BLOCK_SIZE=4
+                                                                    -DDSP_NUM_THREADS=4
+                                                                    -DDSP_CONV_ENABLE=1
+                                                                    -DMAX_FREQ=48000)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, block DSP transport to dsp_main(), look-ahead compressor/limiter on DAC outputs
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_dsp_dyn ${SW_USB_AUDIO_FLAGS} -DDSP_ENABLE=1
+                                                                   -DDSP_BLOCK_SIZE=4
+                                                                   -DDSP_DYN_ENABLE=1)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, DSP channels split over 4 threads, core load over a vendor request and xSCOPE
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_dsp_par4_load ${SW_USB_AUDIO_FLAGS} -DDSP_ENABLE=1
+                                                                         -DDSP_BLOCK_SIZE=4
+                                                                         -DDSP_NUM_THREADS=4
+                                                                         -DCORE_LOAD_ENABLE=1)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, block DSP transport to dsp_main(), UserBufferManagement() timing over xSCOPE
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_dsp_ubm ${SW_USB_AUDIO_FLAGS} -DDSP_ENABLE=1
+                                                                   -DDSP_BLOCK_SIZE=4
+                                                                   -DUBM_TIMING_ENABLE=1)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, event trace over a vendor request and xSCOPE
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_trace ${SW_USB_AUDIO_FLAGS} -DEVENT_TRACE_ENABLE=1
+                                                                 -DEVENT_TRACE_XSCOPE=1)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, channel metering over a vendor request and xSCOPE, clips on the LEDs
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_meter ${SW_USB_AUDIO_FLAGS} -DMETER_ENABLE=1
+                                                                 -DMETER_CLIP_LEDS=1)
 endif()
@@ -39,4 +39,36 @@ set(APP_COMPILER_FLAGS_2AMi10o8xsxxxx ${SW_USB_AUDIO_FLAGS} -DXUA_SPDIF_RX_EN=1)
 set(APP_COMPILER_FLAGS_2AMi8o10xxsxxx_mix8 ${SW_USB_AUDIO_FLAGS} -DXUA_SPDIF_TX_EN=1
                                                                  -DMAX_MIX_COUNT=8)
 
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, zero-latency direct monitor mix (no mixes)
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_mon ${SW_USB_AUDIO_FLAGS} -DDIRECT_MONITOR_ENABLE=1)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, dropout counters over a vendor request
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_xrun ${SW_USB_AUDIO_FLAGS} -DXRUN_ENABLE=1)
+
+# Audio Class 2, Async, I2S Master, 8xInput, 8xOutput, latency measurement over a vendor request
+set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_latency ${SW_USB_AUDIO_FLAGS} -DLATENCY_ENABLE=1)
+
+# MCLK recovery on the AppPLL (SW_PLL_ENABLE) takes the reference on X0D12, which a stock board does
+# not connect. Only for boards with X0D00 linked to X0D12: configure with -DSW_PLL_REF_LINK=ON
+if(SW_PLL_REF_LINK)
+
+# Audio Class 2, Sync, I2S Master, 8xInput, 8xOutput, MCLK recovery on the AppPLL (no CS2100)
+set(APP_COMPILER_FLAGS_2SMi8o8xxxxxx_swpll ${SW_USB_AUDIO_FLAGS} -DXUA_SYNCMODE=XUA_SYNCMODE_SYNC
+                                                                 -DSW_PLL_ENABLE=1
+                                                                 -DSW_PLL_REF_LINK=1)
+
+# Audio Class 2, Async, I2S Master, 10xInput, 10xOutput, S/PDIF Tx, S/PDIF Rx, MCLK recovery on the AppPLL (no CS2100)
+set(APP_COMPILER_FLAGS_2AMi10o10xssxxx_swpll ${SW_USB_AUDIO_FLAGS} -DXUA_SPDIF_TX_EN=1
+                                                                   -DXUA_SPDIF_RX_EN=1
+                                                                   -DSW_PLL_ENABLE=1
+                                                                   -DSW_PLL_REF_LINK=1)
+
+# Audio Class 2, Sync, I2S Master, 8xInput, 8xOutput, MCLK recovery on the AppPLL (no CS2100), dropout counters over a vendor request
+set(APP_COMPILER_FLAGS_2SMi8o8xxxxxx_swpll_xrun ${SW_USB_AUDIO_FLAGS} -DXUA_SYNCMODE=XUA_SYNCMODE_SYNC
+                                                                      -DSW_PLL_ENABLE=1
+                                                                      -DSW_PLL_REF_LINK=1
+                                                                      -DXRUN_ENABLE=1)
+
+endif()
+
 endif()
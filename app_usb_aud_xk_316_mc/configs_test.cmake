@@ -15,4 +15,7 @@ set(APP_COMPILER_FLAGS_upgrade2 ${SW_USB_AUDIO_FLAGS} -DBCD_DEVICE_J=0x99
 # Windows testing with the built-in driver relies on using product IDs that the Thesycon driver won't bind to
 set(APP_COMPILER_FLAGS_2AMi8o8xxxxxx_winbuiltin ${SW_USB_AUDIO_FLAGS} -DPID_AUDIO_2=0x001a)
 
+# Boot phase timestamps printed over xSCOPE for start-up time testing
+set(APP_COMPILER_FLAGS_boottime ${SW_USB_AUDIO_FLAGS} -DBOOT_TIME_REPORT=1)
+
 endif()
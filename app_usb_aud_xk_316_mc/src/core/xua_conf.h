@@ -53,6 +53,114 @@
 #define MAX_MIX_COUNT      (0)
 #endif
 
+/* Enable/Disable block DSP transport to dsp_main() - Default is off */
+#ifndef DSP_ENABLE
+#define DSP_ENABLE         (0)
+#endif
+
+/* Enable/Disable the example biquad EQ on the output channels (requires DSP_ENABLE) - Default is off */
+#ifndef DSP_EQ_ENABLE
+#define DSP_EQ_ENABLE      (0)
+#endif
+
+/* Enable/Disable the example FIR convolution on the first output channels (requires DSP_ENABLE) - Default is off */
+#ifndef DSP_CONV_ENABLE
+#define DSP_CONV_ENABLE    (0)
+#endif
+
+/* Enable/Disable the example look-ahead compressor/limiter on the DAC outputs (requires DSP_ENABLE) - Default is off */
+#ifndef DSP_DYN_ENABLE
+#define DSP_DYN_ENABLE     (0)
+#endif
+
+/* Enable/Disable runtime DSP parameters over a vendor request (DspSetParam()) - Default is on with DSP_DYN_ENABLE */
+#ifndef DSP_CONTROL_ENABLE
+#define DSP_CONTROL_ENABLE (DSP_ENABLE && DSP_DYN_ENABLE)
+#endif
+
+/* Enable/Disable the zero-latency direct monitor mix (shared/direct_monitor.h) - Default is off */
+#ifndef DIRECT_MONITOR_ENABLE
+#define DIRECT_MONITOR_ENABLE (0)
+#endif
+
+/* Enable/Disable MCLK recovery on the xCORE AppPLL (extensions/sw_pll.h) in place of the external CS2100, for sync
+ * mode and digital inputs - Default is off */
+#ifndef SW_PLL_ENABLE
+#define SW_PLL_ENABLE      (0)
+#endif
+
+/* Enable/Disable the logical core load profiler (extensions/core_load.h), read over a vendor request - Default is off */
+#ifndef CORE_LOAD_ENABLE
+#define CORE_LOAD_ENABLE   (0)
+#endif
+
+/* Enable/Disable the event trace (shared/event_trace.h), read over a vendor request - Default is off */
+#ifndef EVENT_TRACE_ENABLE
+#define EVENT_TRACE_ENABLE (0)
+#endif
+
+/* Enable/Disable per-channel level metering (extensions/meter.h), read over a vendor request - Default is off */
+#ifndef METER_ENABLE
+#define METER_ENABLE       (0)
+#endif
+
+/* Enable/Disable the dropout counters (extensions/xrun.h), read and reset over a vendor request - Default is off */
+#ifndef XRUN_ENABLE
+#define XRUN_ENABLE        (0)
+#endif
+
+/* Enable/Disable latency measurement (extensions/latency.h), armed and read over a vendor request - Default is off */
+#ifndef LATENCY_ENABLE
+#define LATENCY_ENABLE     (0)
+#endif
+
+/* Direct monitor, DSP controls, core load, event trace, metering, dropout counters and latency measurement are handled
+ * by VendorRequests(), which needs their control channels. Each enabled feature adds ", <channel>" to the list, the leading comma is
+ * dropped */
+#if (DIRECT_MONITOR_ENABLE)
+#define VENDOR_REQUESTS_DIRECT_MONITOR      , c_directMonitor
+#define VENDOR_REQUESTS_DIRECT_MONITOR_DEC  , chanend c_directMonitor
+#else
+#define VENDOR_REQUESTS_DIRECT_MONITOR
+#define VENDOR_REQUESTS_DIRECT_MONITOR_DEC
+#endif
+
+#if (DSP_CONTROL_ENABLE)
+#define VENDOR_REQUESTS_DSP_CTRL            , c_dspCtrl
+#define VENDOR_REQUESTS_DSP_CTRL_DEC        , chanend c_dspCtrl
+#else
+#define VENDOR_REQUESTS_DSP_CTRL
+#define VENDOR_REQUESTS_DSP_CTRL_DEC
+#endif
+
+#if (CORE_LOAD_ENABLE)
+#define VENDOR_REQUESTS_CORE_LOAD           , c_coreLoad
+#define VENDOR_REQUESTS_CORE_LOAD_DEC       , chanend c_coreLoad
+#else
+#define VENDOR_REQUESTS_CORE_LOAD
+#define VENDOR_REQUESTS_CORE_LOAD_DEC
+#endif
+
+/* One channel to DiagTask() (extensions/diag.h) for the event trace, metering, dropout counters and latency measurement */
+#if (EVENT_TRACE_ENABLE) || (METER_ENABLE) || (XRUN_ENABLE) || (LATENCY_ENABLE)
+#define VENDOR_REQUESTS_DIAG                , c_diag
+#define VENDOR_REQUESTS_DIAG_DEC            , chanend c_diag
+#else
+#define VENDOR_REQUESTS_DIAG
+#define VENDOR_REQUESTS_DIAG_DEC
+#endif
+
+#define VENDOR_REQUESTS_DROP_FIRST(first, ...)  __VA_ARGS__
+#define VENDOR_REQUESTS_LIST(...)               VENDOR_REQUESTS_DROP_FIRST(__VA_ARGS__)
+
+#if (DIRECT_MONITOR_ENABLE) || (DSP_CONTROL_ENABLE) || (CORE_LOAD_ENABLE) || (EVENT_TRACE_ENABLE) || (METER_ENABLE) \
+    || (XRUN_ENABLE) || (LATENCY_ENABLE)
+#define VENDOR_REQUESTS_PARAMS      VENDOR_REQUESTS_LIST(VENDOR_REQUESTS_DIRECT_MONITOR VENDOR_REQUESTS_DSP_CTRL \
+                                        VENDOR_REQUESTS_CORE_LOAD VENDOR_REQUESTS_DIAG)
+#define VENDOR_REQUESTS_PARAMS_DEC  VENDOR_REQUESTS_LIST(VENDOR_REQUESTS_DIRECT_MONITOR_DEC VENDOR_REQUESTS_DSP_CTRL_DEC \
+                                        VENDOR_REQUESTS_CORE_LOAD_DEC VENDOR_REQUESTS_DIAG_DEC)
+#endif
+
 /* Audio Class version - Default is 2.0 */
 #ifndef AUDIO_CLASS
 #define AUDIO_CLASS        (2)
@@ -134,6 +242,11 @@
 #define AUDIO_IO_TILE      (1)
 #define MIDI_TILE          (1)
 
+/* Tile running dsp_main() - Default is the non-USB tile */
+#ifndef DSP_TILE
+#define DSP_TILE           (!XUD_TILE)
+#endif
+
 /*** Defines relating to USB descriptor strings and ID's ***/
 #define VENDOR_ID          (0x20B1) /* XMOS VID */
 #ifndef PID_AUDIO_2
@@ -0,0 +1,312 @@
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include "xua_conf.h"
+#include "conv.h"
+
+#if (DSP_CONV_ENABLE)
+
+static void conv_fft_init(conv_t *conv)
+{
+    for(unsigned i = 0; i < CONV_FFT_SIZE; i++)
+    {
+        unsigned r = 0;
+        for(unsigned b = 1; b < CONV_FFT_SIZE; b <<= 1)
+        {
+            r = (r << 1) | ((i & b) != 0);
+        }
+        conv->bitrev[i] = r;
+    }
+
+    for(unsigned i = 0; i < CONV_FFT_SIZE / 2; i++)
+    {
+        double w = (-2.0 * M_PI * i) / CONV_FFT_SIZE;
+        conv->twiddle[i].re = (float) cos(w);
+        conv->twiddle[i].im = (float) sin(w);
+    }
+}
+
+/* In-place radix-2 forward FFT of conv->fft */
+static void conv_fft(conv_t *conv)
+{
+    conv_complex_t *x = conv->fft;
+
+    for(unsigned i = 0; i < CONV_FFT_SIZE; i++)
+    {
+        unsigned j = conv->bitrev[i];
+        if(j > i)
+        {
+            conv_complex_t t = x[i];
+            x[i] = x[j];
+            x[j] = t;
+        }
+    }
+
+    for(unsigned half = 1; half < CONV_FFT_SIZE; half <<= 1)
+    {
+        const unsigned step = CONV_FFT_SIZE / (2 * half);
+
+        for(unsigned k = 0; k < CONV_FFT_SIZE; k += 2 * half)
+        {
+            for(unsigned j = 0; j < half; j++)
+            {
+                const conv_complex_t w = conv->twiddle[j * step];
+                conv_complex_t *a = &x[k + j];
+                conv_complex_t *b = &x[k + j + half];
+                float tr = (b->re * w.re) - (b->im * w.im);
+                float ti = (b->re * w.im) + (b->im * w.re);
+                b->re = a->re - tr;
+                b->im = a->im - ti;
+                a->re += tr;
+                a->im += ti;
+            }
+        }
+    }
+}
+
+/* Spectrum of CONV_FFT_SIZE real samples, bins 0 to CONV_PART_SIZE */
+static void conv_real_fft(conv_t *conv, const float in[], conv_complex_t out[CONV_BINS], float scale)
+{
+    for(unsigned i = 0; i < CONV_FFT_SIZE; i++)
+    {
+        conv->fft[i].re = in[i];
+        conv->fft[i].im = 0;
+    }
+
+    conv_fft(conv);
+
+    for(unsigned b = 0; b < CONV_BINS; b++)
+    {
+        out[b].re = conv->fft[b].re * scale;
+        out[b].im = conv->fft[b].im * scale;
+    }
+}
+
+/* Last CONV_PART_SIZE samples of the inverse transform of a real signal's spectrum (bins 0 to
+ * CONV_PART_SIZE). Unscaled, the 1/N is folded into the coefficients */
+static void conv_real_ifft_tail(conv_t *conv, const conv_complex_t in[CONV_BINS], float out[CONV_PART_SIZE])
+{
+    /* ifft(X) = conj(fft(conj(X))), only the real part is needed */
+    conv->fft[0].re = in[0].re;
+    conv->fft[0].im = 0;
+    for(unsigned b = 1; b < CONV_PART_SIZE; b++)
+    {
+        conv->fft[b].re = in[b].re;
+        conv->fft[b].im = -in[b].im;
+        conv->fft[CONV_FFT_SIZE - b].re = in[b].re;
+        conv->fft[CONV_FFT_SIZE - b].im = in[b].im;
+    }
+    conv->fft[CONV_PART_SIZE].re = in[CONV_PART_SIZE].re;
+    conv->fft[CONV_PART_SIZE].im = 0;
+
+    conv_fft(conv);
+
+    for(unsigned i = 0; i < CONV_PART_SIZE; i++)
+    {
+        out[i] = conv->fft[CONV_PART_SIZE + i].re;
+    }
+}
+
+void conv_reset(conv_t *conv)
+{
+    memset(conv->hist, 0, sizeof(conv->hist));
+    memset(conv->spec, 0, sizeof(conv->spec));
+    memset(conv->tail, 0, sizeof(conv->tail));
+    conv->hist_idx = 0;
+    conv->pos = 0;
+    conv->work_done = 0;
+    conv->spec_idx = 0;
+    conv->tail_cur = 0;
+}
+
+void conv_init(conv_t *conv)
+{
+    memset(conv, 0, sizeof(conv_t));
+    conv_fft_init(conv);
+
+    /* Unit impulse */
+    conv->head[CONV_HEAD_TAPS - 1] = 1.0f;
+    conv->num_tail_parts = 0;
+}
+
+void conv_load(conv_t *conv, const float taps[], unsigned num_taps)
+{
+    assert(num_taps <= CONV_MAX_TAPS);
+
+    conv->load_taps = taps;
+    conv->load_num_taps = num_taps;
+
+    /* Publish the request after its parameters */
+    asm volatile("" ::: "memory");
+    conv->load_seq++;
+}
+
+unsigned conv_loading(conv_t *conv)
+{
+    return conv->loading || (conv->load_seq != conv->load_seen);
+}
+
+static inline unsigned conv_num_tail_parts(unsigned numTaps)
+{
+    return (numTaps > CONV_HEAD_TAPS) ? ((numTaps - CONV_HEAD_TAPS + CONV_PART_SIZE - 1) / CONV_PART_SIZE) : 0;
+}
+
+/* Load work unit u: 0 is the head, then one FFT per tail partition */
+static void conv_load_unit(conv_t *conv, unsigned u)
+{
+    const float *taps = conv->load_src;
+    const unsigned numTaps = conv->load_src_taps;
+
+    if(u == 0)
+    {
+        for(unsigned i = 0; i < CONV_HEAD_TAPS; i++)
+        {
+            conv->head[CONV_HEAD_TAPS - 1 - i] = (i < numTaps) ? taps[i] : 0.0f;
+        }
+    }
+    else
+    {
+        const unsigned first = CONV_HEAD_TAPS + ((u - 1) * CONV_PART_SIZE);
+        float part[CONV_FFT_SIZE];
+
+        for(unsigned i = 0; i < CONV_PART_SIZE; i++)
+        {
+            part[i] = ((first + i) < numTaps) ? taps[first + i] : 0.0f;
+            part[CONV_PART_SIZE + i] = 0.0f;
+        }
+
+        conv_real_fft(conv, part, conv->coef[u - 1], 1.0f / CONV_FFT_SIZE);
+    }
+}
+
+/* Tail work unit u for this period: transform the newest input frame, multiply-accumulate one
+ * partition per unit, then the inverse transform into next period's tail[] */
+static void conv_tail_unit(conv_t *conv, unsigned u)
+{
+    const unsigned numParts = conv->num_tail_parts;
+
+    if(u == 0)
+    {
+        conv->spec_idx = (conv->spec_idx + 1) % CONV_MAX_TAIL_PARTS;
+        conv_real_fft(conv, &conv->hist[conv->frame_start], conv->spec[conv->spec_idx], 1.0f);
+        memset(conv->acc, 0, sizeof(conv->acc));
+    }
+    else if(u <= numParts)
+    {
+        const unsigned p = u - 1;
+        const conv_complex_t *x = conv->spec[(conv->spec_idx + CONV_MAX_TAIL_PARTS - p) % CONV_MAX_TAIL_PARTS];
+        const conv_complex_t *h = conv->coef[p];
+        conv_complex_t *acc = conv->acc;
+
+        for(unsigned b = 0; b < CONV_BINS; b++)
+        {
+            acc[b].re += (x[b].re * h[b].re) - (x[b].im * h[b].im);
+            acc[b].im += (x[b].re * h[b].im) + (x[b].im * h[b].re);
+        }
+    }
+    else
+    {
+        conv_real_ifft_tail(conv, conv->acc, conv->tail[!conv->tail_cur]);
+    }
+}
+
+static inline int32_t conv_sat(float y)
+{
+    if(y >= 2147483648.0f)
+        return INT32_MAX;
+    if(y < -2147483648.0f)
+        return INT32_MIN;
+    return (int32_t) y;
+}
+
+void conv_process(conv_t *conv, int32_t samples[], unsigned num_frames, unsigned frame_stride)
+{
+    assert((CONV_PART_SIZE % num_frames) == 0);
+
+    if(conv->pos == 0)
+    {
+        /* Start of a partition period */
+        if(!conv->loading && (conv->load_seq != conv->load_seen))
+        {
+            conv->load_seen = conv->load_seq;
+            conv->load_src = (const float *) conv->load_taps;
+            conv->load_src_taps = conv->load_num_taps;
+            conv->load_num_tail_parts = conv_num_tail_parts(conv->load_src_taps);
+            conv->load_done = 0;
+            conv->loading = 1;
+        }
+
+        conv->tail_cur = !conv->tail_cur;
+        conv->work_done = 0;
+        conv->frame_start = (conv->hist_idx + CONV_HIST_SIZE - CONV_FFT_SIZE) % CONV_HIST_SIZE;
+    }
+
+    const unsigned pos = conv->pos;
+    conv->pos += num_frames;
+
+    if(conv->loading)
+    {
+        for(unsigned f = 0; f < num_frames; f++)
+        {
+            samples[f * frame_stride] = 0;
+        }
+
+        /* Spread the load over the period, as for the tail work below */
+        const unsigned units = conv->load_num_tail_parts + 1;
+        const unsigned target = ((units * conv->pos) + CONV_PART_SIZE - 1) / CONV_PART_SIZE;
+        while(conv->load_done < target)
+        {
+            conv_load_unit(conv, conv->load_done++);
+        }
+    }
+    else
+    {
+        const float *tail = &conv->tail[conv->tail_cur][pos];
+
+        for(unsigned f = 0; f < num_frames; f++)
+        {
+            const float x = (float) samples[f * frame_stride];
+            const unsigned idx = conv->hist_idx;
+
+            conv->hist[idx] = x;
+            conv->hist[idx + CONV_HIST_SIZE] = x;
+            conv->hist_idx = (idx + 1) % CONV_HIST_SIZE;
+
+            /* Head: the newest CONV_HEAD_TAPS samples end at hist[idx + CONV_HIST_SIZE] */
+            const float *h = conv->head;
+            const float *in = &conv->hist[idx + CONV_HIST_SIZE + 1 - CONV_HEAD_TAPS];
+            float y = tail[f];
+            for(unsigned k = 0; k < CONV_HEAD_TAPS; k++)
+            {
+                y += h[k] * in[k];
+            }
+
+            samples[f * frame_stride] = conv_sat(y);
+        }
+
+        if(conv->num_tail_parts)
+        {
+            const unsigned units = conv->num_tail_parts + 2;
+            const unsigned target = ((units * conv->pos) + CONV_PART_SIZE - 1) / CONV_PART_SIZE;
+            while(conv->work_done < target)
+            {
+                conv_tail_unit(conv, conv->work_done++);
+            }
+        }
+    }
+
+    if(conv->pos == CONV_PART_SIZE)
+    {
+        conv->pos = 0;
+
+        if(conv->loading && (conv->load_done == (conv->load_num_tail_parts + 1)))
+        {
+            /* New filter starts from silence with the next period */
+            conv->num_tail_parts = conv->load_num_tail_parts;
+            conv->loading = 0;
+            conv_reset(conv);
+        }
+    }
+}
+
+#endif
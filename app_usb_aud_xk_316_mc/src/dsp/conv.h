@@ -0,0 +1,116 @@
+#ifndef _CONV_H_
+#define _CONV_H_
+
+#include <stdint.h>
+
+/*
+ * Long FIR filter (room correction) for one channel using uniformly partitioned convolution.
+ *
+ * The first CONV_HEAD_TAPS taps (the "head") are applied directly in the time domain, sample by
+ * sample. The remaining taps are split into partitions of CONV_PART_SIZE taps and applied in
+ * the frequency domain (overlap-save, FFT size 2 * CONV_PART_SIZE). Because the head covers
+ * the first two partitions, the frequency domain work for a partition can be spread over the
+ * following partition period and still be ready in time, so:
+ *
+ *   - conv_process() adds no latency, the output for a frame includes all taps
+ *   - the cost of each conv_process() call is roughly constant
+ *
+ * The number of frames per conv_process() call must divide CONV_PART_SIZE.
+ *
+ * Memory is about 16 bytes per tap (coefficient and input spectra), so CONV_MAX_TAPS and the
+ * number of instances are limited by the tile's RAM rather than by the engine: a 512KB tile
+ * has room for something like 16k taps in total, for example 4 channels of 4k taps.
+ *
+ * Cost per sample is CONV_HEAD_TAPS multiply-accumulates plus roughly 4 * (taps / CONV_PART_SIZE)
+ * for the tail; a larger CONV_PART_SIZE makes long filters cheaper but the head dearer.
+ */
+
+/* Taps per partition - must be a power of 2 */
+#ifndef CONV_PART_SIZE
+#define CONV_PART_SIZE      (128)
+#endif
+
+#ifndef CONV_MAX_TAPS
+#define CONV_MAX_TAPS       (4096)
+#endif
+
+#if (CONV_PART_SIZE & (CONV_PART_SIZE - 1)) || (CONV_PART_SIZE < 4)
+#error CONV_PART_SIZE must be a power of 2
+#endif
+
+#define CONV_HEAD_TAPS      (2 * CONV_PART_SIZE)
+#define CONV_FFT_SIZE       (2 * CONV_PART_SIZE)
+#define CONV_BINS           (CONV_PART_SIZE + 1)
+#define CONV_HIST_SIZE      (4 * CONV_PART_SIZE)
+
+#if (CONV_MAX_TAPS > CONV_HEAD_TAPS)
+#define CONV_MAX_TAIL_PARTS ((CONV_MAX_TAPS - CONV_HEAD_TAPS + CONV_PART_SIZE - 1) / CONV_PART_SIZE)
+#else
+#define CONV_MAX_TAIL_PARTS (1)
+#endif
+
+typedef struct
+{
+    float re;
+    float im;
+} conv_complex_t;
+
+typedef struct
+{
+    /* Active filter */
+    unsigned num_tail_parts;
+    float head[CONV_HEAD_TAPS];                                 /* Head taps, reversed */
+    conv_complex_t coef[CONV_MAX_TAIL_PARTS][CONV_BINS];        /* Tail partition spectra */
+
+    /* Input history, each sample stored twice so the last CONV_HIST_SIZE are contiguous */
+    float hist[2 * CONV_HIST_SIZE];
+    unsigned hist_idx;
+
+    /* Partition period state */
+    unsigned pos;                                               /* Frames into the current period */
+    unsigned frame_start;                                       /* hist[] index of the frame to transform */
+    unsigned work_done;                                         /* Tail work units done this period */
+    unsigned spec_idx;                                          /* Newest entry of spec[] */
+    conv_complex_t spec[CONV_MAX_TAIL_PARTS][CONV_BINS];        /* Input spectra, newest first from spec_idx */
+    conv_complex_t acc[CONV_BINS];
+    float tail[2][CONV_PART_SIZE];                              /* Tail output for this period and the next */
+    unsigned tail_cur;
+
+    /* Coefficient loading */
+    const float * volatile load_taps;
+    volatile unsigned load_num_taps;
+    volatile unsigned load_seq;
+    unsigned load_seen;
+    unsigned loading;
+    unsigned load_done;                                         /* Load work units done */
+    unsigned load_num_tail_parts;
+    const float *load_src;
+    unsigned load_src_taps;
+
+    conv_complex_t twiddle[CONV_FFT_SIZE / 2];
+    uint16_t bitrev[CONV_FFT_SIZE];
+    conv_complex_t fft[CONV_FFT_SIZE];
+} conv_t;
+
+/* Initialises the engine with a pass-through filter */
+void conv_init(conv_t *conv);
+
+/* Clears the filter state (not the taps), for example on a sample rate change */
+void conv_reset(conv_t *conv);
+
+/* Requests a new set of num_taps taps (num_taps <= CONV_MAX_TAPS). May be called from another
+ * thread on the same tile. taps[] must stay valid until conv_loading() returns 0.
+ *
+ * The coefficients are transformed by conv_process() a few partitions per call so as not to
+ * disturb its timing. The new filter is in place after at most two partition periods
+ * (2 * CONV_PART_SIZE frames), the output is muted for the second of these */
+void conv_load(conv_t *conv, const float taps[], unsigned num_taps);
+
+/* Returns non-zero while a conv_load() request is outstanding */
+unsigned conv_loading(conv_t *conv);
+
+/* Filters num_frames frames in place. samples[] points to the channel in the first frame,
+ * consecutive frames are frame_stride words apart */
+void conv_process(conv_t *conv, int32_t samples[], unsigned num_frames, unsigned frame_stride);
+
+#endif
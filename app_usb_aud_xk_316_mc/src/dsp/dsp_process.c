@@ -0,0 +1,196 @@
+#include "dsp_workers.h"
+
+#if (DSP_ENABLE)
+
+#if (DSP_EQ_ENABLE)
+#include "eq.h"
+
+/* Per-thread share of the output channels must fit one EQ instance */
+#if ((DSP_CHANS_OUT + DSP_NUM_THREADS - 1) / DSP_NUM_THREADS) > EQ_MAX_CHANS
+#error Too many output channels per DSP thread for EQ_MAX_CHANS
+#endif
+
+/* Example EQ settings, all bands 0dB so the output is unchanged. Edit to taste */
+static const eq_band_t g_eqBandsMain[] =
+{
+    {EQ_HIGHPASS,   20.0f,    0.707f, 0.0f},
+    {EQ_LOWSHELF,   120.0f,   0.707f, 0.0f},
+    {EQ_PEAKING,    1000.0f,  1.0f,   0.0f},
+    {EQ_PEAKING,    4000.0f,  1.0f,   0.0f},
+    {EQ_HIGHSHELF,  10000.0f, 0.707f, 0.0f},
+};
+
+static const eq_band_t g_eqBandsSub[] =
+{
+    {EQ_LOWPASS,    80.0f,    0.707f, 0.0f},
+    {EQ_LOWPASS,    80.0f,    0.707f, 0.0f},
+};
+
+/* Output channels 0-1 main pair, 2 sub, remainder flat */
+static eq_chan_conf_t EqChanConf(unsigned ch)
+{
+    eq_chan_conf_t conf = {0, 0};
+
+    if(ch < 2)
+    {
+        conf.num_bands = sizeof(g_eqBandsMain) / sizeof(g_eqBandsMain[0]);
+        conf.bands = g_eqBandsMain;
+    }
+    else if(ch == 2)
+    {
+        conf.num_bands = sizeof(g_eqBandsSub) / sizeof(g_eqBandsSub[0]);
+        conf.bands = g_eqBandsSub;
+    }
+    return conf;
+}
+
+static eq_t g_eq[DSP_NUM_THREADS];
+#endif
+
+#if (DSP_CONV_ENABLE)
+#include "conv.h"
+
+/* Number of output channels, from channel 0, with a convolution filter */
+#ifndef DSP_CONV_CHANS
+#define DSP_CONV_CHANS      (2)
+#endif
+
+#if (DSP_CONV_CHANS > DSP_CHANS_OUT)
+#error DSP_CONV_CHANS must not exceed the number of output channels
+#endif
+
+#if (CONV_PART_SIZE % DSP_BLOCK_SIZE)
+#error DSP_BLOCK_SIZE must divide CONV_PART_SIZE
+#endif
+
+/* Pass-through until taps are loaded. To change a filter at runtime call
+ * conv_load(&g_conv[ch], taps, numTaps) from any thread on DSP_TILE, for example after
+ * receiving the taps from the host; taps[] must remain valid until conv_loading() is 0 */
+static conv_t g_conv[DSP_CONV_CHANS];
+#endif
+
+#if (DSP_DYN_ENABLE)
+#include <assert.h>
+#include "dynamics.h"
+
+/* Number of output channels, from channel 0, through the compressor/limiter */
+#ifndef DSP_DYN_CHANS
+#define DSP_DYN_CHANS       (I2S_CHANS_DAC)
+#endif
+
+#if (DSP_DYN_CHANS > DSP_CHANS_OUT)
+#error DSP_DYN_CHANS must not exceed the number of output channels
+#endif
+
+#if ((DSP_CHANS_OUT + DSP_NUM_THREADS - 1) / DSP_NUM_THREADS) > DYN_MAX_CHANS
+#error Too many output channels per DSP thread for DYN_MAX_CHANS
+#endif
+
+/* One instance per thread for the thread's share of the channels. All instances have the same
+ * parameters, set by DspSetParam() */
+static dyn_t g_dyn[DSP_NUM_THREADS];
+
+static unsigned DynNumChans(unsigned thread)
+{
+    const unsigned first = DSP_OUT_CHAN_START(thread);
+    const unsigned end = (DSP_OUT_CHAN_END(thread) < DSP_DYN_CHANS) ? DSP_OUT_CHAN_END(thread) : DSP_DYN_CHANS;
+
+    return (end > first) ? (end - first) : 0;
+}
+#endif
+
+/* Example processing: passes the input path through unchanged and, if DSP_EQ_ENABLE,
+ * DSP_CONV_ENABLE or DSP_DYN_ENABLE is set, applies EQ, FIR convolution and/or the
+ * compressor/limiter (in that order) to the output path. Replace with
+ * your own DspInit()/DspSetSampFreq()/DspProcessBlock(). All are called on every DSP thread;
+ * each thread should only touch its own channels, for example:
+ *
+ *   for(int f = 0; f < DSP_BLOCK_SIZE; f++)
+ *       for(int ch = DSP_OUT_CHAN_START(thread); ch < DSP_OUT_CHAN_END(thread); ch++)
+ *           samples[DSP_OUT_IDX(f, ch)] = ...;
+ */
+
+void DspInit(unsigned thread)
+{
+#if (DSP_EQ_ENABLE)
+    eq_chan_conf_t conf[EQ_MAX_CHANS];
+    const unsigned first = DSP_OUT_CHAN_START(thread);
+    const unsigned numChans = DSP_OUT_CHAN_END(thread) - first;
+
+    for(unsigned i = 0; i < numChans; i++)
+    {
+        conf[i] = EqChanConf(first + i);
+    }
+
+    eq_init(&g_eq[thread], numChans, conf);
+#endif
+#if (DSP_CONV_ENABLE)
+    for(unsigned ch = DSP_OUT_CHAN_START(thread); (ch < DSP_OUT_CHAN_END(thread)) && (ch < DSP_CONV_CHANS); ch++)
+    {
+        conv_init(&g_conv[ch]);
+    }
+#endif
+#if (DSP_DYN_ENABLE)
+    /* Linked channel groups must not be split between threads */
+    assert(((DSP_OUT_CHAN_START(thread) % DYN_LINK_CHANS) == 0) || (DynNumChans(thread) == 0));
+
+    dyn_init(&g_dyn[thread], DynNumChans(thread), 0);
+#endif
+}
+
+void DspSetSampFreq(unsigned samFreq, unsigned thread)
+{
+#if (DSP_EQ_ENABLE)
+    eq_set_samp_freq(&g_eq[thread], samFreq);
+#endif
+#if (DSP_CONV_ENABLE)
+    for(unsigned ch = DSP_OUT_CHAN_START(thread); (ch < DSP_OUT_CHAN_END(thread)) && (ch < DSP_CONV_CHANS); ch++)
+    {
+        conv_reset(&g_conv[ch]);
+    }
+#endif
+#if (DSP_DYN_ENABLE)
+    dyn_set_samp_freq(&g_dyn[thread], samFreq);
+#endif
+}
+
+void DspProcessBlock(int *samples, unsigned thread)
+{
+#if (DSP_EQ_ENABLE)
+    eq_process(&g_eq[thread], &samples[DSP_OUT_IDX(0, DSP_OUT_CHAN_START(thread))], DSP_BLOCK_SIZE, DSP_FRAME_WORDS);
+#endif
+#if (DSP_CONV_ENABLE)
+    for(unsigned ch = DSP_OUT_CHAN_START(thread); (ch < DSP_OUT_CHAN_END(thread)) && (ch < DSP_CONV_CHANS); ch++)
+    {
+        conv_process(&g_conv[ch], &samples[DSP_OUT_IDX(0, ch)], DSP_BLOCK_SIZE, DSP_FRAME_WORDS);
+    }
+#endif
+#if (DSP_DYN_ENABLE)
+    dyn_process(&g_dyn[thread], &samples[DSP_OUT_IDX(0, DSP_OUT_CHAN_START(thread))], DSP_BLOCK_SIZE, DSP_FRAME_WORDS);
+#endif
+}
+
+unsigned DspSetParam(unsigned id, int value)
+{
+#if (DSP_DYN_ENABLE)
+    unsigned ok = 1;
+    for(unsigned t = 0; t < DSP_NUM_THREADS; t++)
+    {
+        ok &= dyn_set_param(&g_dyn[t], id, value);
+    }
+    return ok;
+#else
+    return 0;
+#endif
+}
+
+unsigned DspGetParam(unsigned id, int *value)
+{
+#if (DSP_DYN_ENABLE)
+    return dyn_get_param(&g_dyn[0], id, value);
+#else
+    return 0;
+#endif
+}
+
+#endif
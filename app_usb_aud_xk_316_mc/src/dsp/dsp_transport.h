@@ -0,0 +1,76 @@
+#ifndef _DSP_TRANSPORT_H_
+#define _DSP_TRANSPORT_H_
+
+#include "xua_conf.h"
+
+/*
+ * Block-batched transport of audio frames between UserBufferManagement() (audio thread)
+ * and dsp_main() (DSP task, normally on DSP_TILE).
+ *
+ * Frames are collected into blocks of DSP_BLOCK_SIZE frames. Once per block the audio thread
+ * sends the raw block and receives the block that dsp_main() processed during the previous
+ * block period (double buffered). This costs one channel handshake per block rather than
+ * several per frame.
+ *
+ * Block layout is frame-major, each frame holding the USB->audio (output) samples followed
+ * by the audio->USB (input) samples:
+ *
+ *   [frame 0: out 0 .. out N-1, in 0 .. in M-1][frame 1: ...] ...
+ */
+
+/* Number of frames per block - must be set at build time */
+#ifndef DSP_BLOCK_SIZE
+#define DSP_BLOCK_SIZE      (4)
+#endif
+
+#if (DSP_BLOCK_SIZE < 1)
+#error DSP_BLOCK_SIZE must be at least 1
+#endif
+
+#define DSP_CHANS_OUT       (NUM_USB_CHAN_OUT)
+#define DSP_CHANS_IN        (NUM_USB_CHAN_IN)
+#define DSP_FRAME_WORDS     (DSP_CHANS_OUT + DSP_CHANS_IN)
+#define DSP_BLOCK_WORDS     (DSP_BLOCK_SIZE * DSP_FRAME_WORDS)
+
+/* Fixed latency added to both audio paths (in frames): one block to collect the raw samples
+ * plus one block for dsp_main() to process them */
+#define DSP_LATENCY_FRAMES  (2 * DSP_BLOCK_SIZE)
+
+/* Index of a sample within a block */
+#define DSP_OUT_IDX(frame, ch)  (((frame) * DSP_FRAME_WORDS) + (ch))
+#define DSP_IN_IDX(frame, ch)   (((frame) * DSP_FRAME_WORDS) + DSP_CHANS_OUT + (ch))
+
+/* Commands on the optional control channel of dsp_main(), handled between blocks:
+ *   DSP_CTRL_CMD_SET: id, value -> ok (DspSetParam())
+ *   DSP_CTRL_CMD_GET: id -> ok, value (DspGetParam())
+ */
+#define DSP_CTRL_CMD_SET    (0)
+#define DSP_CTRL_CMD_GET    (1)
+
+#ifdef __XC__
+/* DSP task, connected to the audio thread via the channel end stored in uc_dsp. Starts
+ * DSP_NUM_THREADS - 1 worker threads on the same tile (see dsp_workers.h). c_ctrl, if not
+ * null, takes DSP_CTRL_CMD_* commands, normally from DspRequest() on Endpoint 0 */
+void dsp_main(chanend c, chanend ?c_ctrl);
+
+extern unsafe chanend uc_dsp;
+
+#if (DSP_CONTROL_ENABLE)
+#include "xud_device.h"
+
+/* Handles the DSP parameter vendor request (VENDOR_REQUEST_DSP_PARAM in
+ * shared/vendor_requests.h), returns XUD_RES_ERR for any other request */
+int DspRequest(XUD_ep ep0_out, XUD_ep ep0_in, USB_SetupPacket_t &sp, chanend c_ctrl);
+#endif
+#endif
+
+#if (DIRECT_MONITOR_ENABLE)
+/* Direct monitor mix (shared/direct_monitor.h), included by direct_monitor.xc */
+void DirectMonitor(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[]);
+#endif
+
+/* Records the current sample frequency, called from AudioHwConfig(). It is forwarded to
+ * dsp_main() with the next block */
+void DspTransportSetSampFreq(unsigned samFreq);
+
+#endif
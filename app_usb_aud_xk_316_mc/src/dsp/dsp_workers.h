@@ -0,0 +1,63 @@
+#ifndef _DSP_WORKERS_H_
+#define _DSP_WORKERS_H_
+
+#include <xccompat.h>
+#include "dsp_transport.h"
+
+/*
+ * Channel-parallel processing of each block received by dsp_main().
+ *
+ * dsp_main() runs as thread 0 and starts DSP_NUM_THREADS - 1 workers on the same tile. For
+ * every block the output (USB->audio) and input (audio->USB) channels are each split evenly
+ * across all threads; each thread processes its share of the block in place and the block is
+ * returned to the audio thread once all threads have finished.
+ */
+
+/* Total number of threads used for DSP, including dsp_main() itself */
+#ifndef DSP_NUM_THREADS
+#define DSP_NUM_THREADS     (1)
+#endif
+
+#if (DSP_NUM_THREADS < 1) || (DSP_NUM_THREADS > 8)
+#error DSP_NUM_THREADS must be between 1 and 8
+#endif
+
+/* Channels handled by a thread: [START, END) */
+#define DSP_CHAN_SPLIT(numChans, thread)    (((numChans) * (thread)) / DSP_NUM_THREADS)
+
+#define DSP_OUT_CHAN_START(thread)          DSP_CHAN_SPLIT(DSP_CHANS_OUT, (thread))
+#define DSP_OUT_CHAN_END(thread)            DSP_CHAN_SPLIT(DSP_CHANS_OUT, (thread) + 1)
+#define DSP_IN_CHAN_START(thread)           DSP_CHAN_SPLIT(DSP_CHANS_IN, (thread))
+#define DSP_IN_CHAN_END(thread)             DSP_CHAN_SPLIT(DSP_CHANS_IN, (thread) + 1)
+
+/* Commands from dsp_main() to workers */
+#define DSP_CMD_PROCESS     (0)
+#define DSP_CMD_SAMP_FREQ   (1)
+
+#ifdef __XC__
+#define DSP_UNSAFE unsafe
+
+void dsp_worker(chanend c, unsigned thread);
+#else
+#define DSP_UNSAFE
+#endif
+
+/* Called once on every thread at start-up, before any other Dsp*() call. Slow set-up work
+ * (for example calculating filter coefficients) belongs here rather than in DspSetSampFreq() */
+void DspInit(unsigned thread);
+
+/* Called on every thread before the first block is processed at a new sample frequency */
+void DspSetSampFreq(unsigned samFreq, unsigned thread);
+
+/* Called on every thread once per block, processes the channels owned by the thread in place.
+ * Use DSP_OUT_IDX()/DSP_IN_IDX() with DSP_*_CHAN_START()/END() to access them */
+void DspProcessBlock(int * DSP_UNSAFE samples, unsigned thread);
+
+/* Runtime parameters, for example from the host over a vendor request (see DspRequest()).
+ * Called on thread 0 between blocks, while no thread is processing, so a parameter may be
+ * applied to the state of every thread. The meaning of id and value is up to the
+ * implementation. Both return 0 if id is not a parameter */
+unsigned DspSetParam(unsigned id, int value);
+unsigned DspGetParam(unsigned id, REFERENCE_PARAM(int, value));
+
+#endif
@@ -0,0 +1,372 @@
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include "xua_conf.h"
+#include "dynamics.h"
+
+#if (DSP_DYN_ENABLE)
+
+#define DYN_UNITY           (1 << DYN_GAIN_Q)
+#define DYN_MAKEUP_Q        (28)
+#define DYN_LOOKAHEAD_MASK  (DYN_LOOKAHEAD - 1)
+
+/* Limiter target below the ceiling, log2 Q16 (about 0.001dB), covers the error of the log2/exp2
+ * approximations so the final clip is not normally reached */
+#define DYN_LIM_MARGIN      (8)
+
+typedef struct
+{
+    int min;
+    int max;
+    int def;
+} dyn_param_range_t;
+
+static const dyn_param_range_t g_dynParamRanges[DYN_NUM_PARAMS] =
+{
+    [DYN_PARAM_COMP_THRESHOLD]  = {-60 * 256,   0,          -12 * 256},
+    [DYN_PARAM_COMP_RATIO]      = {100,         2000,       400},
+    [DYN_PARAM_COMP_ATTACK]     = {10,          1000000,    5000},
+    [DYN_PARAM_COMP_RELEASE]    = {1000,        5000000,    100000},
+    [DYN_PARAM_COMP_MAKEUP]     = {0,           18 * 256,   0},
+    [DYN_PARAM_LIM_CEILING]     = {-30 * 256,   0,          -1 * 256},
+    [DYN_PARAM_LIM_RELEASE]     = {1000,        2000000,    50000},
+    [DYN_PARAM_LINK]            = {0,           1,          1},
+};
+
+/* log2(1 + i/64) in Q16 */
+static const int32_t g_dynLog2Table[65] =
+{
+    0, 1466, 2909, 4331, 5732, 7112, 8473, 9814,
+    11136, 12440, 13727, 14996, 16248, 17484, 18704, 19909,
+    21098, 22272, 23433, 24579, 25711, 26830, 27936, 29029,
+    30109, 31178, 32234, 33279, 34312, 35334, 36346, 37346,
+    38336, 39316, 40286, 41246, 42196, 43137, 44068, 44990,
+    45904, 46809, 47705, 48593, 49472, 50344, 51207, 52063,
+    52911, 53751, 54584, 55410, 56229, 57040, 57845, 58643,
+    59434, 60219, 60997, 61769, 62534, 63294, 64047, 64794,
+    65536,
+};
+
+/* 2^(i/64) in Q30 */
+static const uint32_t g_dynExp2Table[65] =
+{
+    1073741824, 1085434106, 1097253708, 1109202018, 1121280436, 1133490379, 1145833280, 1158310587,
+    1170923762, 1183674286, 1196563654, 1209593378, 1222764986, 1236080024, 1249540052, 1263146652,
+    1276901417, 1290805962, 1304861917, 1319070932, 1333434672, 1347954824, 1362633090, 1377471191,
+    1392470869, 1407633882, 1422962010, 1438457051, 1454120821, 1469955159, 1485961921, 1502142985,
+    1518500250, 1535035634, 1551751076, 1568648537, 1585730000, 1602997467, 1620452965, 1638098541,
+    1655936265, 1673968228, 1692196547, 1710623359, 1729250827, 1748081133, 1767116489, 1786359126,
+    1805811301, 1825475297, 1845353420, 1865448001, 1885761398, 1906295993, 1927054196, 1948038440,
+    1969251188, 1990694927, 2012372174, 2034285470, 2056437387, 2078830522, 2101467502, 2124350982,
+    2147483648u,
+};
+
+/* log2(x / 2^31) in Q16, x must be non-zero */
+static inline int32_t dyn_log2(uint32_t x)
+{
+    const unsigned n = __builtin_clz(x);
+    const uint32_t norm = x << n;
+    const unsigned idx = (norm >> 25) & 63;
+    const int32_t rem = (norm >> 9) & 0xFFFF;
+    const int32_t lo = g_dynLog2Table[idx];
+
+    return (lo + (((g_dynLog2Table[idx + 1] - lo) * rem) >> 16)) - (int32_t)(n << 16);
+}
+
+/* 2^(e / 2^16) in Q30, limited to unity gain */
+static inline int32_t dyn_exp2(int32_t e)
+{
+    if(e >= 0)
+    {
+        return DYN_UNITY;
+    }
+
+    const unsigned shift = -(e >> 16);
+    if(shift > 31)
+    {
+        return 0;
+    }
+
+    const unsigned f = e & 0xFFFF;
+    const unsigned idx = f >> 10;
+    const uint32_t lo = g_dynExp2Table[idx];
+    const uint32_t val = lo + (uint32_t)(((uint64_t)(g_dynExp2Table[idx + 1] - lo) * (f & 0x3FF)) >> 10);
+
+    return (int32_t)(val >> shift);
+}
+
+static inline uint32_t dyn_abs(int32_t x)
+{
+    return (x < 0) ? -(uint32_t) x : (uint32_t) x;
+}
+
+/* Parameter conversions are in single precision, so they use the FPU and a parameter change
+ * takes a few microseconds between blocks */
+static int32_t dyn_db_to_log2(int db256)
+{
+    /* dB / 20 * log2(10), in Q16 */
+    return (int32_t) lroundf((db256 / 256.0f) * (3.32192809f / 20.0f) * 65536.0f);
+}
+
+static int32_t dyn_db_to_q(int db256, unsigned q)
+{
+    const float val = powf(10.0f, db256 / (256.0f * 20.0f)) * (float)(1ull << q);
+    return (val >= 2147483647.0f) ? INT32_MAX : (int32_t) lroundf(val);
+}
+
+/* One-pole smoothing coefficient for a time constant, per frame, Q31 */
+static int32_t dyn_time_coef(int time_us, unsigned samFreq)
+{
+    const float val = -expm1f(-1e6f / ((float) time_us * samFreq)) * 2147483648.0f;
+    return (val >= 2147483647.0f) ? INT32_MAX : (int32_t) lroundf(val);
+}
+
+/* Recalculates the values derived from a parameter */
+static void dyn_update(dyn_t *dyn, unsigned id)
+{
+    const unsigned samFreq = dyn->samp_freq ? dyn->samp_freq : 48000;
+    const int value = dyn->params[id];
+
+    switch(id)
+    {
+        case DYN_PARAM_COMP_THRESHOLD:
+            dyn->comp_thresh_log = dyn_db_to_log2(value);
+            break;
+        case DYN_PARAM_COMP_RATIO:
+            dyn->comp_slope = (int32_t) lroundf(((100.0f / value) - 1.0f) * 65536.0f);
+            break;
+        case DYN_PARAM_COMP_ATTACK:
+            dyn->comp_attack = dyn_time_coef(value, samFreq);
+            break;
+        case DYN_PARAM_COMP_RELEASE:
+            dyn->comp_release = dyn_time_coef(value, samFreq);
+            break;
+        case DYN_PARAM_COMP_MAKEUP:
+            dyn->makeup = dyn_db_to_q(value, DYN_MAKEUP_Q);
+            break;
+        case DYN_PARAM_LIM_CEILING:
+            dyn->lim_ceiling = dyn_db_to_q(value, 31);
+            dyn->lim_ceiling_log = dyn_db_to_log2(value);
+            break;
+        case DYN_PARAM_LIM_RELEASE:
+            dyn->lim_release = dyn_time_coef(value, samFreq);
+            break;
+        case DYN_PARAM_LINK:
+        default:
+            dyn->group = value ? DYN_LINK_CHANS : 1;
+            break;
+    }
+}
+
+static void dyn_reset(dyn_t *dyn)
+{
+    memset(dyn->delay, 0, sizeof(dyn->delay));
+    dyn->pos = 0;
+    dyn->time = 0;
+
+    for(unsigned d = 0; d < DYN_MAX_CHANS; d++)
+    {
+        dyn_det_t *det = &dyn->det[d];
+
+        det->env = 0;
+        det->hold = DYN_UNITY;
+        det->box_sum = (int64_t) DYN_UNITY * DYN_LOOKAHEAD;
+        det->min_head = 0;
+        det->min_count = 0;
+        for(unsigned i = 0; i < DYN_LOOKAHEAD; i++)
+        {
+            det->box[i] = DYN_UNITY;
+        }
+    }
+}
+
+void dyn_init(dyn_t *dyn, unsigned num_chans, unsigned samp_freq)
+{
+    assert(num_chans <= DYN_MAX_CHANS);
+
+    memset(dyn, 0, sizeof(dyn_t));
+    dyn->num_chans = num_chans;
+    dyn->samp_freq = samp_freq;
+
+    for(unsigned id = 0; id < DYN_NUM_PARAMS; id++)
+    {
+        dyn->params[id] = g_dynParamRanges[id].def;
+        dyn_update(dyn, id);
+    }
+
+    dyn_reset(dyn);
+}
+
+void dyn_set_samp_freq(dyn_t *dyn, unsigned samp_freq)
+{
+    dyn->samp_freq = samp_freq;
+
+    for(unsigned id = 0; id < DYN_NUM_PARAMS; id++)
+    {
+        dyn_update(dyn, id);
+    }
+
+    dyn_reset(dyn);
+}
+
+unsigned dyn_set_param(dyn_t *dyn, unsigned id, int value)
+{
+    if(id >= DYN_NUM_PARAMS)
+    {
+        return 0;
+    }
+
+    if(value < g_dynParamRanges[id].min)
+        value = g_dynParamRanges[id].min;
+    else if(value > g_dynParamRanges[id].max)
+        value = g_dynParamRanges[id].max;
+
+    const unsigned relink = (id == DYN_PARAM_LINK) && (value != dyn->params[id]);
+
+    dyn->params[id] = value;
+    dyn_update(dyn, id);
+
+    if(relink)
+    {
+        /* Detectors now cover different channels */
+        dyn_reset(dyn);
+    }
+    return 1;
+}
+
+unsigned dyn_get_param(const dyn_t *dyn, unsigned id, int *value)
+{
+    if(id >= DYN_NUM_PARAMS)
+    {
+        return 0;
+    }
+
+    *value = dyn->params[id];
+    return 1;
+}
+
+/* Compressor gain for a detector, including makeup, Q28 */
+static inline int32_t dyn_comp_gain(const dyn_t *dyn, dyn_det_t *det, uint32_t peak)
+{
+    const int32_t coef = (peak > det->env) ? dyn->comp_attack : dyn->comp_release;
+    int32_t gain = DYN_UNITY;
+
+    det->env += (int32_t)((((int64_t) peak - det->env) * coef) >> 31);
+
+    if(det->env)
+    {
+        const int32_t over = dyn_log2(det->env) - dyn->comp_thresh_log;
+        if(over > 0)
+        {
+            gain = dyn_exp2((int32_t)(((int64_t) dyn->comp_slope * over) >> 16));
+        }
+    }
+
+    return (int32_t)(((int64_t) gain * dyn->makeup) >> DYN_GAIN_Q);
+}
+
+/* Limiter gain for a detector, Q30. peak is the level of the frame entering the delay, the
+ * gain returned is for the frame leaving it */
+static inline int32_t dyn_lim_gain(const dyn_t *dyn, dyn_det_t *det, uint32_t peak)
+{
+    int32_t needed = DYN_UNITY;
+
+    if(peak > (uint32_t) dyn->lim_ceiling)
+    {
+        needed = dyn_exp2(dyn->lim_ceiling_log - dyn_log2(peak) - DYN_LIM_MARGIN);
+    }
+
+    /* Minimum over the last DYN_LOOKAHEAD frames */
+    if(det->min_count && ((dyn->time - det->min_time[det->min_head]) >= DYN_LOOKAHEAD))
+    {
+        det->min_head = (det->min_head + 1) & DYN_LOOKAHEAD_MASK;
+        det->min_count--;
+    }
+    while(det->min_count && (det->min_val[(det->min_head + det->min_count - 1) & DYN_LOOKAHEAD_MASK] >= needed))
+    {
+        det->min_count--;
+    }
+    const unsigned back = (det->min_head + det->min_count) & DYN_LOOKAHEAD_MASK;
+    det->min_val[back] = needed;
+    det->min_time[back] = dyn->time;
+    det->min_count++;
+
+    const int32_t held = det->min_val[det->min_head];
+
+    /* Release towards unity, attack is instant */
+    det->hold += (int32_t)(((int64_t)(DYN_UNITY - det->hold) * dyn->lim_release) >> 31);
+    if(held < det->hold)
+    {
+        det->hold = held;
+    }
+
+    /* Moving average over the look-ahead, so the gain reaches held as the peak is output */
+    det->box_sum += det->hold - det->box[dyn->pos];
+    det->box[dyn->pos] = det->hold;
+
+    return (int32_t)(det->box_sum / DYN_LOOKAHEAD);
+}
+
+void dyn_process(dyn_t *dyn, int32_t *samples, unsigned num_frames, unsigned stride)
+{
+    const unsigned group = dyn->group;
+    const int32_t ceiling = dyn->lim_ceiling;
+
+    for(unsigned f = 0; f < num_frames; f++)
+    {
+        int32_t *frame = &samples[f * stride];
+        const unsigned wr = dyn->pos;
+        const unsigned rd = (wr + 1) & DYN_LOOKAHEAD_MASK;
+
+        for(unsigned first = 0, d = 0; first < dyn->num_chans; first += group, d++)
+        {
+            const unsigned end = ((first + group) < dyn->num_chans) ? (first + group) : dyn->num_chans;
+            dyn_det_t *det = &dyn->det[d];
+            uint32_t peak = 0;
+
+            for(unsigned ch = first; ch < end; ch++)
+            {
+                const uint32_t a = dyn_abs(frame[ch]);
+                peak = (a > peak) ? a : peak;
+            }
+
+            const int32_t compGain = dyn_comp_gain(dyn, det, peak);
+
+            peak = 0;
+            for(unsigned ch = first; ch < end; ch++)
+            {
+                int64_t x = ((int64_t) frame[ch] * compGain) >> DYN_MAKEUP_Q;
+
+                if(x > INT32_MAX)
+                    x = INT32_MAX;
+                else if(x < INT32_MIN)
+                    x = INT32_MIN;
+
+                dyn->delay[ch][wr] = (int32_t) x;
+
+                const uint32_t a = dyn_abs((int32_t) x);
+                peak = (a > peak) ? a : peak;
+            }
+
+            const int32_t limGain = dyn_lim_gain(dyn, det, peak);
+
+            for(unsigned ch = first; ch < end; ch++)
+            {
+                int32_t y = (int32_t)(((int64_t) dyn->delay[ch][rd] * limGain) >> DYN_GAIN_Q);
+
+                /* The ceiling is never exceeded, whatever the rounding of the gain */
+                if(y > ceiling)
+                    y = ceiling;
+                else if(y < -ceiling)
+                    y = -ceiling;
+
+                frame[ch] = y;
+            }
+        }
+
+        dyn->pos = rd;
+        dyn->time++;
+    }
+}
+
+#endif
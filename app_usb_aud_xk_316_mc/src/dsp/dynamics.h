@@ -0,0 +1,116 @@
+#ifndef _DYNAMICS_H_
+#define _DYNAMICS_H_
+
+#include <stdint.h>
+
+/*
+ * Fixed-point dynamics processor: a compressor followed by a look-ahead brick-wall limiter.
+ *
+ * Compressor: a peak envelope (attack/release) is compared with the threshold and the gain
+ * above it follows the ratio, the makeup gain is then applied. It has no look-ahead, fast
+ * transients that get past its attack are left to the limiter.
+ *
+ * Limiter: the signal is delayed by DYN_LATENCY_FRAMES. The gain needed to keep each incoming
+ * frame at or below the ceiling is held for DYN_LOOKAHEAD frames (sliding minimum), released
+ * with the release time and then smoothed by a DYN_LOOKAHEAD frame moving average, so the
+ * gain ramps down over the look-ahead and reaches the needed value as the peak leaves the
+ * delay. Output is finally clipped at the ceiling, so it never exceeds it whatever the input.
+ *
+ * Channels are either independent or linked in groups of DYN_LINK_CHANS consecutive channels
+ * (the loudest channel of the group sets the gain of all of them, which keeps the stereo image
+ * of a pair). Groups start at the first channel of the instance.
+ *
+ * Levels use log2/exp2 approximations (about 0.001dB), per frame cost is a few tens of
+ * instructions per detector (channel or linked group) plus a few per channel.
+ */
+
+/* Look-ahead (frames), a power of 2. The latency is DYN_LATENCY_FRAMES, for example 0.65ms at
+ * 48kHz with the default */
+#ifndef DYN_LOOKAHEAD
+#define DYN_LOOKAHEAD       (32)
+#endif
+
+#if (DYN_LOOKAHEAD & (DYN_LOOKAHEAD - 1)) || (DYN_LOOKAHEAD < 2)
+#error DYN_LOOKAHEAD must be a power of 2
+#endif
+
+#define DYN_LATENCY_FRAMES  (DYN_LOOKAHEAD - 1)
+
+#ifndef DYN_MAX_CHANS
+#define DYN_MAX_CHANS       (8)
+#endif
+
+#ifndef DYN_LINK_CHANS
+#define DYN_LINK_CHANS      (2)
+#endif
+
+/* Parameters, all integers. Levels are in 1/256 dB, times in microseconds */
+#define DYN_PARAM_COMP_THRESHOLD    (0)     /* Compressor threshold, default -12dB */
+#define DYN_PARAM_COMP_RATIO        (1)     /* Compressor ratio x 100, default 400 (4:1), 100 is off */
+#define DYN_PARAM_COMP_ATTACK       (2)     /* Default 5ms */
+#define DYN_PARAM_COMP_RELEASE      (3)     /* Default 100ms */
+#define DYN_PARAM_COMP_MAKEUP       (4)     /* Makeup gain, 0 to +18dB, default 0dB */
+#define DYN_PARAM_LIM_CEILING       (5)     /* Limiter ceiling, default -1dB */
+#define DYN_PARAM_LIM_RELEASE       (6)     /* Default 50ms */
+#define DYN_PARAM_LINK              (7)     /* 1 to link channels in groups, default 1 */
+#define DYN_NUM_PARAMS              (8)
+
+/* Gain Q format */
+#define DYN_GAIN_Q          (30)
+
+/* Per detector state */
+typedef struct
+{
+    uint32_t env;                       /* Compressor envelope, Q31 */
+    int32_t hold;                       /* Limiter gain after release, Q30 */
+    int64_t box_sum;
+    int32_t box[DYN_LOOKAHEAD];         /* Moving average history of hold */
+
+    /* Sliding minimum of the needed limiter gain: increasing values, oldest first */
+    int32_t min_val[DYN_LOOKAHEAD];
+    uint32_t min_time[DYN_LOOKAHEAD];
+    unsigned min_head;
+    unsigned min_count;
+} dyn_det_t;
+
+typedef struct
+{
+    int params[DYN_NUM_PARAMS];
+    unsigned samp_freq;
+    unsigned num_chans;
+
+    /* Derived from params and samp_freq */
+    int32_t comp_thresh_log;            /* log2 of the threshold, Q16 */
+    int32_t comp_slope;                 /* 1/ratio - 1, Q16 */
+    int32_t comp_attack;                /* Envelope coefficients, Q31 */
+    int32_t comp_release;
+    int32_t makeup;                     /* Q28 */
+    int32_t lim_ceiling;                /* Q31 */
+    int32_t lim_ceiling_log;            /* Q16 */
+    int32_t lim_release;                /* Q31 */
+    unsigned group;                     /* Channels per detector */
+
+    uint32_t time;
+    unsigned pos;
+    int32_t delay[DYN_MAX_CHANS][DYN_LOOKAHEAD];
+    dyn_det_t det[DYN_MAX_CHANS];
+} dyn_t;
+
+/* Sets the default parameters and clears the state */
+void dyn_init(dyn_t *dyn, unsigned num_chans, unsigned samp_freq);
+
+/* Clears the state and recalculates time constants, e.g. after a sample rate change */
+void dyn_set_samp_freq(dyn_t *dyn, unsigned samp_freq);
+
+/* Sets a parameter (DYN_PARAM_*), values are clamped to their ranges. Returns 0 if id is not a
+ * parameter. Must not be called during dyn_process() on the same instance */
+unsigned dyn_set_param(dyn_t *dyn, unsigned id, int value);
+
+/* Returns 0 if id is not a parameter */
+unsigned dyn_get_param(const dyn_t *dyn, unsigned id, int *value);
+
+/* Processes num_frames frames in place, stride words from one frame of a channel to the next
+ * and channels contiguous */
+void dyn_process(dyn_t *dyn, int32_t *samples, unsigned num_frames, unsigned stride);
+
+#endif
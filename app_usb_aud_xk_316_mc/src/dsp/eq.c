@@ -0,0 +1,257 @@
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include "xua_conf.h"
+#include "eq.h"
+
+#if (DSP_EQ_ENABLE)
+
+static const unsigned g_eqSampFreqs[EQ_NUM_SAMP_FREQS] = EQ_SAMP_FREQS;
+
+/* Saturates to the Q30 range */
+static int32_t eq_coef_q30(double val)
+{
+    const long long coef = llround(val * (double)(1 << EQ_COEF_Q));
+
+    if(coef > INT32_MAX)
+        return INT32_MAX;
+    if(coef < INT32_MIN)
+        return INT32_MIN;
+    return (int32_t) coef;
+}
+
+/* Biquad coefficients from the RBJ audio EQ cookbook. Writes b0, b1, b2, -a1, -a2 normalised by a0 */
+static void eq_calc_section(double c[5], const eq_band_t *band, unsigned samFreq)
+{
+    const double w0 = 2.0 * M_PI * band->freq / samFreq;
+    const double cw = cos(w0);
+    const double alpha = sin(w0) / (2.0 * band->q);
+    const double gain_db = (band->gain_db > EQ_MAX_GAIN_DB) ? EQ_MAX_GAIN_DB : band->gain_db;
+    const double A = pow(10.0, gain_db / 40.0);
+    const double sqA2a = 2.0 * sqrt(A) * alpha;
+    double b0, b1, b2, a0, a1, a2;
+
+    switch(band->type)
+    {
+        case EQ_PEAKING:
+            b0 = 1.0 + alpha * A;
+            b1 = -2.0 * cw;
+            b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A;
+            a1 = -2.0 * cw;
+            a2 = 1.0 - alpha / A;
+            break;
+
+        case EQ_LOWSHELF:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cw + sqA2a);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cw);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cw - sqA2a);
+            a0 = (A + 1.0) + (A - 1.0) * cw + sqA2a;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cw);
+            a2 = (A + 1.0) + (A - 1.0) * cw - sqA2a;
+            break;
+
+        case EQ_HIGHSHELF:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cw + sqA2a);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cw);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cw - sqA2a);
+            a0 = (A + 1.0) - (A - 1.0) * cw + sqA2a;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cw);
+            a2 = (A + 1.0) - (A - 1.0) * cw - sqA2a;
+            break;
+
+        case EQ_LOWPASS:
+            b0 = (1.0 - cw) / 2.0;
+            b1 = 1.0 - cw;
+            b2 = (1.0 - cw) / 2.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cw;
+            a2 = 1.0 - alpha;
+            break;
+
+        case EQ_HIGHPASS:
+        default:
+            b0 = (1.0 + cw) / 2.0;
+            b1 = -(1.0 + cw);
+            b2 = (1.0 + cw) / 2.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cw;
+            a2 = 1.0 - alpha;
+            break;
+    }
+
+    c[0] = b0 / a0;
+    c[1] = b1 / a0;
+    c[2] = b2 / a0;
+    c[3] = -a1 / a0;
+    c[4] = -a2 / a0;
+}
+
+void eq_init(eq_t *eq, unsigned num_chans, const eq_chan_conf_t conf[])
+{
+    assert(num_chans <= EQ_MAX_CHANS);
+
+    memset(eq, 0, sizeof(eq_t));
+    eq->num_chans = num_chans;
+    eq->num_groups = (num_chans + EQ_LANES - 1) / EQ_LANES;
+    eq->bank = EQ_NUM_SAMP_FREQS;
+
+    for(unsigned ch = 0; ch < num_chans; ch++)
+    {
+        unsigned g = ch / EQ_LANES;
+        assert(conf[ch].num_bands <= EQ_MAX_SECTIONS);
+        if(conf[ch].num_bands > eq->num_sections[g])
+        {
+            eq->num_sections[g] = conf[ch].num_bands;
+        }
+    }
+
+    for(unsigned r = 0; r < EQ_NUM_SAMP_FREQS; r++)
+    {
+        for(unsigned g = 0; g < eq->num_groups; g++)
+        {
+            for(unsigned s = 0; s < eq->num_sections[g]; s++)
+            {
+                for(unsigned l = 0; l < EQ_LANES; l++)
+                {
+                    const unsigned ch = (g * EQ_LANES) + l;
+                    /* Pass-through unless the channel has a band here that is below Nyquist */
+                    double c[5] = {1.0, 0.0, 0.0, 0.0, 0.0};
+
+                    if((ch < num_chans) && (s < conf[ch].num_bands) && (conf[ch].bands[s].freq < (g_eqSampFreqs[r] / 2)))
+                    {
+                        eq_calc_section(c, &conf[ch].bands[s], g_eqSampFreqs[r]);
+                    }
+
+                    for(unsigned k = 0; k < 5; k++)
+                    {
+                        eq->coef[r][g][s][k][l] = eq_coef_q30(c[k]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void eq_set_samp_freq(eq_t *eq, unsigned samFreq)
+{
+    eq->bank = EQ_NUM_SAMP_FREQS;
+    for(unsigned r = 0; r < EQ_NUM_SAMP_FREQS; r++)
+    {
+        if(g_eqSampFreqs[r] == samFreq)
+        {
+            eq->bank = r;
+        }
+    }
+
+    memset(eq->hist, 0, sizeof(eq->hist));
+    eq->hist_idx = 0;
+}
+
+/* One section for all lanes: y = b0.x0 + b1.x1 + b2.x2 - a1.y1 - a2.y2 */
+#if defined(__XS3A__)
+static const int32_t g_eqZeroShr[EQ_LANES] = {0};
+
+static inline void eq_section(int32_t y[EQ_LANES], const int32_t coef[5][EQ_LANES],
+    const int32_t x0[EQ_LANES], const int32_t x1[EQ_LANES], const int32_t x2[EQ_LANES],
+    const int32_t y1[EQ_LANES], const int32_t y2[EQ_LANES])
+{
+    const int32_t *c = &coef[0][0];
+
+    /* 32-bit VPU mode: vlmacc accumulates (vC * mem) >> 30 into 40-bit accumulators */
+    asm volatile(
+        "vclrdr                 \n"
+        "vldc %[c][0]           \n"
+        "ldaw %[c], %[c][8]     \n"
+        "vlmacc %[x0][0]        \n"
+        "vldc %[c][0]           \n"
+        "ldaw %[c], %[c][8]     \n"
+        "vlmacc %[x1][0]        \n"
+        "vldc %[c][0]           \n"
+        "ldaw %[c], %[c][8]     \n"
+        "vlmacc %[x2][0]        \n"
+        "vldc %[c][0]           \n"
+        "ldaw %[c], %[c][8]     \n"
+        "vlmacc %[y1][0]        \n"
+        "vldc %[c][0]           \n"
+        "vlmacc %[y2][0]        \n"
+        "vlsat %[shr][0]        \n"
+        "vstr %[y][0]           \n"
+        : [c] "+r" (c)
+        : [x0] "r" (x0), [x1] "r" (x1), [x2] "r" (x2), [y1] "r" (y1), [y2] "r" (y2),
+          [y] "r" (y), [shr] "r" (g_eqZeroShr)
+        : "memory");
+}
+#else
+static inline int64_t eq_mul_q30(int32_t a, int32_t b)
+{
+    return (((int64_t) a * b) + (1 << (EQ_COEF_Q - 1))) >> EQ_COEF_Q;
+}
+
+static inline void eq_section(int32_t y[EQ_LANES], const int32_t coef[5][EQ_LANES],
+    const int32_t x0[EQ_LANES], const int32_t x1[EQ_LANES], const int32_t x2[EQ_LANES],
+    const int32_t y1[EQ_LANES], const int32_t y2[EQ_LANES])
+{
+    for(unsigned l = 0; l < EQ_LANES; l++)
+    {
+        int64_t acc = eq_mul_q30(coef[0][l], x0[l]) + eq_mul_q30(coef[1][l], x1[l]) + eq_mul_q30(coef[2][l], x2[l])
+                    + eq_mul_q30(coef[3][l], y1[l]) + eq_mul_q30(coef[4][l], y2[l]);
+
+        if(acc > INT32_MAX)
+            acc = INT32_MAX;
+        else if(acc < INT32_MIN)
+            acc = INT32_MIN;
+
+        y[l] = (int32_t) acc;
+    }
+}
+#endif
+
+void eq_process(eq_t *eq, int32_t samples[], unsigned num_frames, unsigned frame_stride)
+{
+    if(eq->bank >= EQ_NUM_SAMP_FREQS)
+    {
+        return;
+    }
+
+#if defined(__XS3A__)
+    asm volatile("vsetc %0" :: "r" (0));
+#endif
+
+    for(unsigned f = 0; f < num_frames; f++)
+    {
+        /* History slots are rotated rather than copied */
+        const unsigned p1 = eq->hist_idx;
+        const unsigned cur = (p1 + 1) % 3;
+        const unsigned p2 = (p1 + 2) % 3;
+        int32_t *frame = &samples[f * frame_stride];
+
+        eq->hist_idx = cur;
+
+        for(unsigned g = 0; g < eq->num_groups; g++)
+        {
+            const unsigned first = g * EQ_LANES;
+            const unsigned n = ((eq->num_chans - first) < EQ_LANES) ? (eq->num_chans - first) : EQ_LANES;
+            const unsigned numSections = eq->num_sections[g];
+            int32_t (*hist)[3][EQ_LANES] = eq->hist[g];
+
+            for(unsigned l = 0; l < n; l++)
+            {
+                hist[0][cur][l] = frame[first + l];
+            }
+
+            for(unsigned s = 0; s < numSections; s++)
+            {
+                eq_section(hist[s + 1][cur], eq->coef[eq->bank][g][s],
+                    hist[s][cur], hist[s][p1], hist[s][p2], hist[s + 1][p1], hist[s + 1][p2]);
+            }
+
+            for(unsigned l = 0; l < n; l++)
+            {
+                frame[first + l] = hist[numSections][cur][l];
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef _EQ_H_
+#define _EQ_H_
+
+#include <stdint.h>
+
+/*
+ * Multi-channel cascaded biquad EQ.
+ *
+ * All channels of a frame are processed together, eight channels per vector (a "group") on
+ * the xCORE.ai vector unit. Each channel has its own bank of up to EQ_MAX_SECTIONS sections;
+ * channels with fewer sections than others in their group run pass-through sections.
+ *
+ * Coefficients are calculated for every rate in EQ_SAMP_FREQS by eq_init(), so a sample rate
+ * change (eq_set_samp_freq()) only selects a bank and clears the filter state.
+ *
+ * Coefficients are Q30 so must lie in [-2, 2), this limits peaking/shelf boost to just under
+ * +6dB (cut is not limited). Band gains above EQ_MAX_GAIN_DB are taken as EQ_MAX_GAIN_DB, and any
+ * coefficient still outside the range is saturated, so settings from the host cannot stop the
+ * DSP. Output is saturated to 32 bits.
+ */
+
+#ifndef EQ_MAX_CHANS
+#define EQ_MAX_CHANS        (8)
+#endif
+
+#ifndef EQ_MAX_SECTIONS
+#define EQ_MAX_SECTIONS     (8)
+#endif
+
+#define EQ_LANES            (8)
+#define EQ_MAX_GROUPS       ((EQ_MAX_CHANS + EQ_LANES - 1) / EQ_LANES)
+
+/* Sample rates coefficients are pre-calculated for */
+#define EQ_SAMP_FREQS       {44100, 48000, 88200, 96000, 176400, 192000}
+#define EQ_NUM_SAMP_FREQS   (6)
+
+#define EQ_COEF_Q           (30)
+
+/* Largest peaking/shelf boost, the b0 of a +6.02dB band reaches 2.0 */
+#define EQ_MAX_GAIN_DB      (6.0)
+
+typedef enum
+{
+    EQ_PEAKING,
+    EQ_LOWSHELF,
+    EQ_HIGHSHELF,
+    EQ_LOWPASS,
+    EQ_HIGHPASS,
+} eq_type_t;
+
+/* One biquad section */
+typedef struct
+{
+    eq_type_t type;
+    float freq;         /* Centre/corner frequency (Hz) */
+    float q;
+    float gain_db;      /* Peaking and shelf types only */
+} eq_band_t;
+
+/* Settings for one channel */
+typedef struct
+{
+    unsigned num_bands;
+    const eq_band_t *bands;
+} eq_chan_conf_t;
+
+typedef struct
+{
+    unsigned num_chans;
+    unsigned num_groups;
+    unsigned num_sections[EQ_MAX_GROUPS];               /* Max sections of any channel in the group */
+    unsigned hist_idx;                                  /* Index of the newest history slot */
+    unsigned bank;                                      /* Active coefficient bank, EQ_NUM_SAMP_FREQS if bypassed */
+
+    /* b0, b1, b2, -a1, -a2 per section, one lane per channel */
+    int32_t coef[EQ_NUM_SAMP_FREQS][EQ_MAX_GROUPS][EQ_MAX_SECTIONS][5][EQ_LANES];
+
+    /* Last three values of every node in the cascade (input, then the output of each section) */
+    int32_t hist[EQ_MAX_GROUPS][EQ_MAX_SECTIONS + 1][3][EQ_LANES];
+} eq_t;
+
+/* Calculates the coefficient banks for num_chans channels, conf[] has one entry per channel.
+ * Can take some milliseconds, call before audio is running */
+void eq_init(eq_t *eq, unsigned num_chans, const eq_chan_conf_t conf[]);
+
+/* Selects the coefficients for samFreq and clears the filter state. The EQ is bypassed for
+ * rates not in EQ_SAMP_FREQS */
+void eq_set_samp_freq(eq_t *eq, unsigned samFreq);
+
+/* Processes num_frames frames in place. samples[] points to the first channel of the first
+ * frame, consecutive frames are frame_stride words apart */
+void eq_process(eq_t *eq, int32_t samples[], unsigned num_frames, unsigned frame_stride);
+
+#endif
@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include "xua_conf.h"
+#include "core_load.h"
+
+#if (CORE_LOAD_ENABLE)
+
+#define CORE_LOAD_UNMARKED      (0)
+#define CORE_LOAD_IDLE          (1)
+#define CORE_LOAD_BUSY          (2)
+
+/* Written by the cores, read by the sampler. One set per tile */
+static volatile unsigned g_coreLoadState[CORE_LOAD_MAX_CORES];
+
+/* Sampler only */
+static struct
+{
+    unsigned samples;                           /* In the current window */
+    unsigned windows;
+    uint64_t totalSamples;
+    unsigned busy[CORE_LOAD_MAX_CORES];         /* In the current window */
+    unsigned last[CORE_LOAD_MAX_CORES];
+    unsigned peak[CORE_LOAD_MAX_CORES];
+    uint64_t totalBusy[CORE_LOAD_MAX_CORES];
+    unsigned idleRate;                          /* Kept over a reset */
+    unsigned rate;
+    unsigned freeLast;
+    unsigned freeMin;
+    uint64_t totalCount;
+    uint64_t totalTicks;
+    unsigned random;
+} g_coreLoad = {.idleRate = CORE_LOAD_IDLE_RATE, .random = 1};
+
+void CoreLoadBusy(unsigned core)
+{
+    g_coreLoadState[core] = CORE_LOAD_BUSY;
+}
+
+void CoreLoadIdle(unsigned core)
+{
+    g_coreLoadState[core] = CORE_LOAD_IDLE;
+}
+
+unsigned CoreLoadSample(void)
+{
+    for(unsigned i = 0; i < CORE_LOAD_MAX_CORES; i++)
+    {
+        g_coreLoad.busy[i] += (g_coreLoadState[i] == CORE_LOAD_BUSY);
+    }
+
+    if(++g_coreLoad.samples < CORE_LOAD_WINDOW_SAMPLES)
+    {
+        return 0;
+    }
+
+    for(unsigned i = 0; i < CORE_LOAD_MAX_CORES; i++)
+    {
+        const unsigned load = (g_coreLoad.busy[i] * 1000 + (CORE_LOAD_WINDOW_SAMPLES / 2)) / CORE_LOAD_WINDOW_SAMPLES;
+
+        g_coreLoad.last[i] = load;
+        if(load > g_coreLoad.peak[i])
+        {
+            g_coreLoad.peak[i] = load;
+        }
+        g_coreLoad.totalBusy[i] += g_coreLoad.busy[i];
+        g_coreLoad.busy[i] = 0;
+    }
+
+    g_coreLoad.totalSamples += g_coreLoad.samples;
+    g_coreLoad.samples = 0;
+    g_coreLoad.windows++;
+    return 1;
+}
+
+/* Counts per ms */
+static unsigned CoreLoadRate(uint64_t count, uint64_t ticks)
+{
+    return (unsigned) (((count * 100000) + (ticks / 2)) / ticks);
+}
+
+/* Free fraction of the tile in 1/1000 at a count rate */
+static unsigned CoreLoadFree(unsigned rate)
+{
+    const unsigned free = (unsigned) ((((uint64_t) rate * 1000) + (g_coreLoad.idleRate / 2)) / g_coreLoad.idleRate);
+
+    return (free > 1000) ? 1000 : free;
+}
+
+void CoreLoadCount(unsigned count, unsigned ticks)
+{
+    if(ticks == 0)
+    {
+        return;
+    }
+
+    g_coreLoad.rate = CoreLoadRate(count, ticks);
+    if((CORE_LOAD_IDLE_RATE == 0) && (g_coreLoad.rate > g_coreLoad.idleRate))
+    {
+        g_coreLoad.idleRate = g_coreLoad.rate;
+    }
+
+    if(g_coreLoad.idleRate == 0)
+    {
+        return;
+    }
+
+    g_coreLoad.freeLast = CoreLoadFree(g_coreLoad.rate);
+    if(g_coreLoad.freeLast < g_coreLoad.freeMin)
+    {
+        g_coreLoad.freeMin = g_coreLoad.freeLast;
+    }
+    g_coreLoad.totalCount += count;
+    g_coreLoad.totalTicks += ticks;
+}
+
+/* Uniform over [CORE_LOAD_SAMPLE_TICKS / 2, 3 * CORE_LOAD_SAMPLE_TICKS / 2), from a 32-bit
+ * xorshift generator */
+unsigned CoreLoadInterval(void)
+{
+    unsigned x = g_coreLoad.random;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_coreLoad.random = x;
+
+    return (CORE_LOAD_SAMPLE_TICKS / 2) + (unsigned) (((uint64_t) x * CORE_LOAD_SAMPLE_TICKS) >> 32);
+}
+
+void CoreLoadReset(void)
+{
+    g_coreLoad.samples = 0;
+    g_coreLoad.windows = 0;
+    g_coreLoad.totalSamples = 0;
+    g_coreLoad.rate = 0;
+    g_coreLoad.freeLast = 0;
+    g_coreLoad.freeMin = 1000;
+    g_coreLoad.totalCount = 0;
+    g_coreLoad.totalTicks = 0;
+
+    for(unsigned i = 0; i < CORE_LOAD_MAX_CORES; i++)
+    {
+        g_coreLoad.busy[i] = 0;
+        g_coreLoad.last[i] = 0;
+        g_coreLoad.peak[i] = 0;
+        g_coreLoad.totalBusy[i] = 0;
+    }
+}
+
+void CoreLoadReport(unsigned report[])
+{
+    unsigned mask = 0;
+
+    report[CORE_LOAD_REPORT_WINDOWS] = g_coreLoad.windows;
+    report[CORE_LOAD_REPORT_WINDOW_MS] = CORE_LOAD_WINDOW_MS;
+
+    for(unsigned i = 0; i < CORE_LOAD_MAX_CORES; i++)
+    {
+        if(g_coreLoadState[i] != CORE_LOAD_UNMARKED)
+        {
+            mask |= (1 << i);
+        }
+
+        report[CORE_LOAD_REPORT_LAST(i)] = g_coreLoad.last[i];
+        report[CORE_LOAD_REPORT_PEAK(i)] = g_coreLoad.peak[i];
+        report[CORE_LOAD_REPORT_AVG(i)] = g_coreLoad.totalSamples ?
+            (unsigned) ((g_coreLoad.totalBusy[i] * 1000 + (g_coreLoad.totalSamples / 2)) / g_coreLoad.totalSamples) : 0;
+    }
+
+    report[CORE_LOAD_REPORT_MASK] = mask;
+    report[CORE_LOAD_REPORT_IDLE_RATE] = g_coreLoad.idleRate;
+    report[CORE_LOAD_REPORT_RATE] = g_coreLoad.rate;
+    report[CORE_LOAD_REPORT_FREE_LAST] = g_coreLoad.freeLast;
+    report[CORE_LOAD_REPORT_FREE_MIN] = g_coreLoad.totalTicks ? g_coreLoad.freeMin : 0;
+    report[CORE_LOAD_REPORT_FREE_AVG] = g_coreLoad.totalTicks ?
+        CoreLoadFree(CoreLoadRate(g_coreLoad.totalCount, g_coreLoad.totalTicks)) : 0;
+}
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef _CORE_LOAD_H_
+#define _CORE_LOAD_H_
+
+/*
+ * Logical core load profiler (CORE_LOAD_ENABLE), for finding the headroom a build config leaves
+ * on each tile.
+ *
+ * The headroom of a tile is measured without hooks in the cores: CoreLoadTask() runs on each
+ * tile and, whenever it has nothing else to do, counts turns of its polling loop. The issue slots
+ * of a tile are shared round robin among its active cores, each getting at most one in five, so
+ * the counter runs at its full rate while at most four other cores are active and slows in
+ * proportion when more are. The count rate of each CORE_LOAD_WINDOW_MS window, against the rate
+ * of an idle tile, is the free fraction of the tile in 1/1000: the share of a full speed core
+ * that one more core would get. 1000 is a tile with a core to spare, 625 one running eight
+ * active cores on average.
+ *
+ * The idle rate is CORE_LOAD_IDLE_RATE when set, otherwise the highest window rate the tile has
+ * seen, which is right once the tile has had a window with at most four other cores active
+ * (typically from boot, before the host starts streaming). The rate is reported so that the
+ * figure of an idle tile can be taken for CORE_LOAD_IDLE_RATE on a tile that never is.
+ *
+ * On top of that, the load of the cores the application owns is sampled: each calls
+ * CoreLoadBusy() when it takes up work and CoreLoadIdle() before it waits on a channel, port or
+ * timer, a call and a store. CoreLoadTask() samples the marks of the cores on its tile at random
+ * intervals averaging CORE_LOAD_SAMPLE_TICKS (randomised so that the sampling cannot lock to the
+ * frame or block rate of the audio work). The busy fraction of each core is kept over the same
+ * windows: the last window, the peak window and the average since the statistics were reset, in
+ * 1/1000.
+ *
+ * Instrumented cores, numbered per tile:
+ *
+ *   - CORE_LOAD_CORE_DSP(thread): dsp_main() and its workers (DSP_ENABLE), on DSP_TILE
+ *   - CORE_LOAD_CORE_SW_PLL: SwPllTask() (SW_PLL_ENABLE), on PLL_REF_TILE
+ *   - CORE_LOAD_CORE_UBM: UserBufferManagement() on the audio core, on AUDIO_IO_TILE
+ *   - CORE_LOAD_CORE_EP0: VendorRequests() on the Endpoint 0 core, on XUD_TILE
+ *
+ * The last two are the application hooks lib_xua calls: they are busy only while in the hook, so
+ * their load is the share of the audio and Endpoint 0 cores the application takes, not the load
+ * of those cores. The rest of the lib_xua and lib_i2c cores (XUD, buffering, mixer, the audio
+ * core's I2S and exchange work, S/PDIF, ADAT, MIDI, I2C) have no marks, they show in the free
+ * fraction of their tile only.
+ *
+ * Results are read over a vendor request (VENDOR_REQUEST_CORE_LOAD, shared/vendor_requests.h)
+ * handled by CoreLoadRequest() and, with CORE_LOAD_XSCOPE, streamed on the CORE_LOAD xscope
+ * probe at the end of each window, one value for the tile (core CORE_LOAD_CORE_TILE) and one
+ * per instrumented core:
+ *
+ *   (tile << 24) | (core << 16) | free fraction or load of the last window in 1/1000
+ *
+ * CoreLoadTask() takes a core on each tile and, as it never waits, an issue slot whenever a tile
+ * runs more than four other active cores. Builds for measuring only.
+ */
+
+#include "xua_conf.h"
+
+#ifndef CORE_LOAD_ENABLE
+#define CORE_LOAD_ENABLE            (0)
+#endif
+
+/* Mean sample interval, in reference timer ticks (100MHz) */
+#ifndef CORE_LOAD_SAMPLE_TICKS
+#define CORE_LOAD_SAMPLE_TICKS      (1000)
+#endif
+
+/* Window length. 10000 samples by default, so a window load is within about 1% of the true
+ * figure */
+#ifndef CORE_LOAD_WINDOW_MS
+#define CORE_LOAD_WINDOW_MS         (100)
+#endif
+
+/* Counts per ms of the CoreLoadTask() polling loop on an idle tile, 0 to take the highest rate
+ * seen */
+#ifndef CORE_LOAD_IDLE_RATE
+#define CORE_LOAD_IDLE_RATE         (0)
+#endif
+
+#ifndef CORE_LOAD_XSCOPE
+#define CORE_LOAD_XSCOPE            (1)
+#endif
+
+#define CORE_LOAD_WINDOW_SAMPLES    ((CORE_LOAD_WINDOW_MS * 100000) / CORE_LOAD_SAMPLE_TICKS)
+
+/* Cores per tile */
+#define CORE_LOAD_MAX_CORES         (8)
+
+#define CORE_LOAD_CORE_DSP(thread)  (thread)
+#define CORE_LOAD_CORE_SW_PLL       (CORE_LOAD_MAX_CORES - 1)
+#define CORE_LOAD_CORE_UBM          (CORE_LOAD_MAX_CORES - 2)
+#define CORE_LOAD_CORE_EP0          (CORE_LOAD_MAX_CORES - 3)
+
+/* Core number of the free fraction on the xscope probe */
+#define CORE_LOAD_CORE_TILE         (0xFF)
+
+/* Report, as sent for VENDOR_REQUEST_CORE_LOAD: windows since reset, window length in ms, mask
+ * of the instrumented cores, for each core the last, peak and average load then for the tile
+ * the idle and last count rates (counts per ms) and the last, lowest and average free fraction */
+#define CORE_LOAD_REPORT_WINDOWS    (0)
+#define CORE_LOAD_REPORT_WINDOW_MS  (1)
+#define CORE_LOAD_REPORT_MASK       (2)
+#define CORE_LOAD_REPORT_LAST(core) (3 + (3 * (core)))
+#define CORE_LOAD_REPORT_PEAK(core) (4 + (3 * (core)))
+#define CORE_LOAD_REPORT_AVG(core)  (5 + (3 * (core)))
+#define CORE_LOAD_REPORT_IDLE_RATE  (3 + (3 * CORE_LOAD_MAX_CORES))
+#define CORE_LOAD_REPORT_RATE       (4 + (3 * CORE_LOAD_MAX_CORES))
+#define CORE_LOAD_REPORT_FREE_LAST  (5 + (3 * CORE_LOAD_MAX_CORES))
+#define CORE_LOAD_REPORT_FREE_MIN   (6 + (3 * CORE_LOAD_MAX_CORES))
+#define CORE_LOAD_REPORT_FREE_AVG   (7 + (3 * CORE_LOAD_MAX_CORES))
+#define CORE_LOAD_REPORT_WORDS      (8 + (3 * CORE_LOAD_MAX_CORES))
+
+/* Commands from CoreLoadRequest() to CoreLoadTask(), each followed by the tile. Tasks pass
+ * commands for another tile on to the next task in the chain */
+#define CORE_LOAD_CMD_READ          (0)     /* -> number of words, report words (0 for no tile) */
+#define CORE_LOAD_CMD_RESET         (1)     /* -> 1, or 0 for no tile */
+
+#if (CORE_LOAD_ENABLE)
+
+#if (CORE_LOAD_WINDOW_SAMPLES < 100)
+#error CORE_LOAD_WINDOW_MS must be at least 100 samples of CORE_LOAD_SAMPLE_TICKS
+#endif
+
+/* Marks, called by the instrumented core itself */
+void CoreLoadBusy(unsigned core);
+void CoreLoadIdle(unsigned core);
+
+/* Samples the marks of all cores on the tile. Returns 1 if this completed a window */
+unsigned CoreLoadSample(void);
+
+/* Counts of the polling loop over the ticks of the window CoreLoadSample() completed */
+void CoreLoadCount(unsigned count, unsigned ticks);
+
+/* Ticks from this sample to the next */
+unsigned CoreLoadInterval(void);
+
+/* Clears the statistics, the marks and the idle rate are kept */
+void CoreLoadReset(void);
+
+/* Fills report with CORE_LOAD_REPORT_WORDS words */
+void CoreLoadReport(unsigned report[]);
+
+#ifdef __XC__
+#include "xud_device.h"
+
+/* Handles VENDOR_REQUEST_CORE_LOAD, returns XUD_RES_ERR for any other request */
+int CoreLoadRequest(XUD_ep ep0_out, XUD_ep ep0_in, USB_SetupPacket_t &sp, chanend c);
+#endif
+
+#else
+#define CoreLoadBusy(core)
+#define CoreLoadIdle(core)
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef _DIAG_H_
+#define _DIAG_H_
+
+/*
+ * Diagnostics task: one core on AUDIO_IO_TILE serving the vendor requests whose data lives on
+ * the audio tile, so that enabling more of them does not cost more cores:
+ *
+ *   - VENDOR_REQUEST_EVENT_TRACE: the event trace of the audio tile (shared/event_trace.h)
+ *   - VENDOR_REQUEST_METER: channel levels (extensions/meter.h), also polling for each metering
+ *     period every METER_POLL_TICKS
+ *   - VENDOR_REQUEST_XRUN: dropout counters of the audio tile (extensions/xrun.h)
+ *   - VENDOR_REQUEST_LATENCY: latency stages (extensions/latency.h)
+ *
+ * The handlers on Endpoint 0 share one channel to DiagTask() and send each command as
+ * VENDOR_REQUEST_CMD(bRequest, command) (shared/vendor_requests.h). DiagTask() passes it to the
+ * feature's command function, which answers on the same channel. Endpoint 0 handles one request
+ * at a time, so there is at most one command outstanding.
+ *
+ * The core load profiler (extensions/core_load.h) keeps a core per tile as it samples them.
+ */
+
+#include "xua_conf.h"
+
+#define DIAG_ENABLE                 ((EVENT_TRACE_ENABLE) || (METER_ENABLE) || (XRUN_ENABLE) || (LATENCY_ENABLE))
+
+#if (DIAG_ENABLE)
+
+#if (EVENT_TRACE_ENABLE) && (AUDIO_IO_TILE == XUD_TILE)
+#error EVENT_TRACE_ENABLE reads the tile other than XUD_TILE from DiagTask(), which runs on AUDIO_IO_TILE
+#endif
+
+#ifdef __XC__
+/* Serves the diagnostics commands on c. c_leds is the channel to MeterLeds() with
+ * METER_CLIP_LEDS, null otherwise */
+void DiagTask(chanend c, chanend ?c_leds);
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,4 @@
+#include "xua_conf.h"
+
+#define EVENT_TRACE_DEFINE
+#include "../../../shared/event_trace.h"
@@ -0,0 +1,104 @@
+#include "xua_conf.h"
+#include "latency.h"
+
+#if (LATENCY_ENABLE)
+
+/* Stops the compiler moving the stage stores past the seen mask */
+#define LATENCY_BARRIER()   asm volatile("" ::: "memory")
+
+/* Set by LatencyArm(), the audio thread arms a new measurement when they change */
+static volatile unsigned g_latencyArms = 0;
+static volatile unsigned g_latencyInjects = 0;
+
+/* Written by the audio thread only */
+static volatile unsigned g_latencySamFreq = 0;
+static volatile unsigned g_latencySeen = 0;
+static unsigned g_latencyStages[LATENCY_NUM_STAGES][2];
+
+/* Audio thread only */
+static struct
+{
+    unsigned frame;
+    unsigned arms;
+    unsigned injects;
+    unsigned inject;
+} g_latency;
+
+static inline void LatencyStage(unsigned stage, unsigned sample)
+{
+    if(LATENCY_IS_MARKER(sample) && !(g_latencySeen & (1 << stage)))
+    {
+        g_latencyStages[stage][0] = g_latency.frame;
+        g_latencyStages[stage][1] = LATENCY_TIME();
+        LATENCY_BARRIER();
+        g_latencySeen |= (1 << stage);
+    }
+}
+
+void LatencyFrameIn(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[])
+{
+    g_latency.frame++;
+
+    if(g_latencyArms != g_latency.arms)
+    {
+        g_latency.arms = g_latencyArms;
+        g_latency.inject = (g_latencyInjects != g_latency.injects);
+        g_latency.injects = g_latencyInjects;
+        g_latencySeen = 0;
+    }
+
+    LatencyStage(LATENCY_STAGE_USB_OUT, sampsFromUsbToAudio[LATENCY_CHAN]);
+    LatencyStage(LATENCY_STAGE_I2S_IN, sampsFromAudioToUsb[LATENCY_CHAN]);
+}
+
+void LatencyFrameOut(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[])
+{
+    if(g_latency.inject)
+    {
+        g_latency.inject = 0;
+        sampsFromUsbToAudio[LATENCY_CHAN] = LATENCY_MARKER;
+    }
+
+    LatencyStage(LATENCY_STAGE_I2S_OUT, sampsFromUsbToAudio[LATENCY_CHAN]);
+    LatencyStage(LATENCY_STAGE_USB_IN, sampsFromAudioToUsb[LATENCY_CHAN]);
+}
+
+void LatencySetSampFreq(unsigned samFreq)
+{
+    /* Frame numbers from different configurations cannot be compared, so a measurement armed
+     * before the restart is dropped */
+    g_latency.frame = 0;
+    g_latency.arms = g_latencyArms;
+    g_latency.injects = g_latencyInjects;
+    g_latency.inject = 0;
+    g_latencySeen = 0;
+    g_latencySamFreq = samFreq;
+}
+
+void LatencyArm(unsigned inject)
+{
+    if(inject)
+    {
+        g_latencyInjects++;
+    }
+    LATENCY_BARRIER();
+    g_latencyArms++;
+}
+
+void LatencyReport(unsigned report[])
+{
+    const unsigned seen = g_latencySeen;
+
+    LATENCY_BARRIER();
+    report[LATENCY_REPORT_SAMFREQ] = g_latencySamFreq;
+    report[LATENCY_REPORT_SEEN] = seen;
+
+    for(unsigned i = 0; i < LATENCY_NUM_STAGES; i++)
+    {
+        const unsigned valid = seen & (1 << i);
+        report[LATENCY_REPORT_FRAME(i)] = valid ? g_latencyStages[i][0] : 0;
+        report[LATENCY_REPORT_TIME(i)] = valid ? g_latencyStages[i][1] : 0;
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+/*
+ * Latency measurement (LATENCY_ENABLE): timestamps a marker sample as it passes through the
+ * device, for measuring the round trip with an I2S_LOOPBACK build, where the DACs return their
+ * data on the ADC lines.
+ *
+ * The marker is the sample LATENCY_MARKER on channel LATENCY_CHAN, compared without the bits
+ * below 24. It comes from the host (see tests/latency.py), or is inserted by the firmware in
+ * place of the channel's next sample to I2S. UserBufferManagement() calls LatencyFrameIn() on
+ * entry and LatencyFrameOut() before returning, and the first marker after the measurement is
+ * armed is timestamped at each stage:
+ *
+ *   - USB out: in the samples from USB, on entry
+ *   - I2S out: in the samples to I2S, before returning (after DSP_ENABLE processing)
+ *   - I2S in: in the samples from I2S, on entry
+ *   - USB in: in the samples to USB, before returning
+ *
+ * Each stage records the frame since the audio last restarted (at LatencySetSampFreq(), from
+ * AudioHwConfig()) and the reference timer. The device's share of the round trip is the frames
+ * from USB out to USB in, the I2S loop (lib_xua, the codec and the board) those from I2S out to
+ * I2S in. A stage after processing that changes the marker (DSP, direct monitor) does not see
+ * it.
+ *
+ * Measurements are armed and read over VENDOR_REQUEST_LATENCY (shared/vendor_requests.h),
+ * handled by LatencyRequest() on Endpoint 0, which passes them to DiagTask() (extensions/diag.h)
+ * on AUDIO_IO_TILE, answered by LatencyCommand(). The audio thread is the only writer of the
+ * stages, it clears them when it sees a new arm count.
+ *
+ * LatencyFrameIn() and LatencyFrameOut() cost some tens of instructions per frame.
+ */
+
+#include "xua_conf.h"
+
+#ifndef LATENCY_ENABLE
+#define LATENCY_ENABLE              (0)
+#endif
+
+#ifndef LATENCY_CHAN
+#define LATENCY_CHAN                (0)
+#endif
+
+/* Marker sample, bits 31:8. About +0.7 of full scale, so also an impulse on the analogue
+ * outputs of a build without I2S_LOOPBACK */
+#ifndef LATENCY_MARKER
+#define LATENCY_MARKER              (0x5A5A5A00)
+#endif
+
+#define LATENCY_MARKER_MASK         (0xFFFFFF00)
+#define LATENCY_IS_MARKER(sample)   (((sample) & LATENCY_MARKER_MASK) == LATENCY_MARKER)
+
+/* Reference timer, replaceable for host builds */
+#ifndef LATENCY_TIME
+#define LATENCY_TIME()              ({unsigned _t; asm volatile("gettime %0" : "=r"(_t)); _t;})
+#endif
+
+/* Stages, in the order of the vendor request */
+#define LATENCY_STAGE_USB_OUT       (0)
+#define LATENCY_STAGE_I2S_OUT       (1)
+#define LATENCY_STAGE_I2S_IN        (2)
+#define LATENCY_STAGE_USB_IN        (3)
+#define LATENCY_NUM_STAGES          (4)
+
+/* Report: sample rate, mask of the stages seen, then the frame and time of each stage */
+#define LATENCY_REPORT_SAMFREQ      (0)
+#define LATENCY_REPORT_SEEN         (1)
+#define LATENCY_REPORT_FRAME(stage) (2 + (2 * (stage)))
+#define LATENCY_REPORT_TIME(stage)  (3 + (2 * (stage)))
+#define LATENCY_REPORT_WORDS        (2 + (2 * LATENCY_NUM_STAGES))
+
+/* Commands from LatencyRequest() to LatencyCommand(), sent as VENDOR_REQUEST_CMD() */
+#define LATENCY_CMD_READ            (0)     /* -> report words */
+#define LATENCY_CMD_ARM             (1)     /* -> 1, waits for a marker from the host */
+#define LATENCY_CMD_INJECT          (2)     /* -> 1, arms and inserts a marker at I2S out */
+
+#if (LATENCY_ENABLE)
+
+/* Audio thread: USB out and I2S in stages of one frame */
+void LatencyFrameIn(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[]);
+
+/* Audio thread: I2S out and USB in stages, inserting the marker when asked to */
+void LatencyFrameOut(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[]);
+
+/* Audio thread: the audio restarts at samFreq, frames are counted from here */
+void LatencySetSampFreq(unsigned samFreq);
+
+/* Clears the stages from the audio thread's next frame, with a marker inserted if inject */
+void LatencyArm(unsigned inject);
+
+/* Fills report with LATENCY_REPORT_WORDS words */
+void LatencyReport(unsigned report[]);
+
+#ifdef __XC__
+#include "xud_device.h"
+
+/* Answers one command, already taken from c */
+void LatencyCommand(chanend c, unsigned cmd);
+
+/* Handles VENDOR_REQUEST_LATENCY, returns XUD_RES_ERR for any other request */
+int LatencyRequest(XUD_ep ep0_out, XUD_ep ep0_in, USB_SetupPacket_t &sp, chanend c);
+#endif
+
+#else
+#define LatencyFrameIn(sampsFromUsbToAudio, sampsFromAudioToUsb)
+#define LatencyFrameOut(sampsFromUsbToAudio, sampsFromAudioToUsb)
+#define LatencySetSampFreq(samFreq)
+#endif
+
+#endif
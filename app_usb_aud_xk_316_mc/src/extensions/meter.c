@@ -0,0 +1,187 @@
+#include <stdint.h>
+#include "xua_conf.h"
+#include "meter.h"
+
+#if (METER_ENABLE)
+
+/* Stops the compiler moving accesses to the sets past the hand over */
+#define METER_BARRIER()     asm volatile("" ::: "memory")
+
+/* Sums of one period */
+typedef struct
+{
+    unsigned frames;
+    unsigned peak[METER_NUM_CHANS];
+    unsigned clips[METER_NUM_CHANS];
+    uint64_t squares[METER_NUM_CHANS];
+} meter_sums_t;
+
+/* The audio thread adds to g_meterSums[g_meterActive]. g_meterFree is set by MeterCollect()
+ * once it has cleared the other set, and cleared by the audio thread when it switches to it */
+static meter_sums_t g_meterSums[2];
+static volatile unsigned g_meterActive = 0;
+static volatile unsigned g_meterFree = 1;
+
+/* Audio thread only, apart from g_meterRate */
+static unsigned g_meterSampFreq = 48000;
+static unsigned g_meterPeriodFrames = 48000 / METER_RATE_HZ;
+static volatile unsigned g_meterRate = METER_RATE_HZ;
+
+/* DiagTask() only */
+static struct
+{
+    unsigned updates;
+    unsigned frames;
+    unsigned peak[METER_NUM_CHANS];
+    unsigned rms[METER_NUM_CHANS];
+    unsigned clips[METER_NUM_CHANS];
+    unsigned clipped;                   /* Quarters, in the last period */
+} g_meter;
+
+static inline void MeterChans(meter_sums_t *s, const unsigned samples[], unsigned first, unsigned n)
+{
+    for(unsigned i = 0; i < n; i++)
+    {
+        const int x = (int) samples[i];
+        const unsigned a = (unsigned) (x ^ (x >> 31));  /* |x|, or |x| - 1 if negative */
+        const int x24 = x >> 8;
+
+        if(a > s->peak[first + i])
+        {
+            s->peak[first + i] = a;
+        }
+        s->clips[first + i] += (a >= METER_CLIP_LEVEL);
+        s->squares[first + i] += (uint64_t) ((int64_t) x24 * x24);
+    }
+}
+
+void MeterFrame(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[])
+{
+    meter_sums_t *s = &g_meterSums[g_meterActive];
+
+    /* A period carried on for too long stops, rather than overflow its sums */
+    if(s->frames < METER_MAX_PERIOD_FRAMES)
+    {
+        MeterChans(s, sampsFromUsbToAudio, 0, METER_CHANS_OUT);
+        MeterChans(s, sampsFromAudioToUsb, METER_CHANS_OUT, METER_CHANS_IN);
+        s->frames++;
+    }
+
+    if((s->frames >= g_meterPeriodFrames) && g_meterFree)
+    {
+        METER_BARRIER();
+        g_meterActive = !g_meterActive;
+        METER_BARRIER();
+        g_meterFree = 0;
+        g_meterPeriodFrames = g_meterSampFreq / g_meterRate;
+    }
+}
+
+void MeterSetSampFreq(unsigned samFreq)
+{
+    g_meterSampFreq = samFreq;
+    g_meterPeriodFrames = samFreq / g_meterRate;
+}
+
+unsigned MeterSetRate(unsigned rateHz)
+{
+    if((rateHz < METER_MIN_RATE_HZ) || (rateHz > METER_MAX_RATE_HZ))
+    {
+        return 0;
+    }
+    g_meterRate = rateHz;
+    return 1;
+}
+
+/* Integer square root */
+static unsigned MeterSqrt(uint64_t x)
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t) 1 << 62;
+
+    while(bit > x)
+    {
+        bit >>= 2;
+    }
+
+    while(bit)
+    {
+        if(x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (unsigned) root;
+}
+
+unsigned MeterCollect(void)
+{
+    if(g_meterFree)
+    {
+        return 0;
+    }
+
+    METER_BARRIER();
+    meter_sums_t *s = &g_meterSums[!g_meterActive];
+    const unsigned frames = s->frames;
+    unsigned clipped = 0;
+
+    for(unsigned i = 0; i < METER_NUM_CHANS; i++)
+    {
+        g_meter.peak[i] = s->peak[i];
+        g_meter.rms[i] = frames ? (MeterSqrt(s->squares[i] / frames) << 8) : 0;
+        g_meter.clips[i] += s->clips[i];
+        if(s->clips[i])
+        {
+            clipped |= 1 << ((i * METER_NUM_LEDS) / METER_NUM_CHANS);
+        }
+
+        s->peak[i] = 0;
+        s->clips[i] = 0;
+        s->squares[i] = 0;
+    }
+    s->frames = 0;
+
+    g_meter.frames = frames;
+    g_meter.clipped = clipped;
+    g_meter.updates++;
+
+    METER_BARRIER();
+    g_meterFree = 1;
+    return 1;
+}
+
+void MeterReport(unsigned report[])
+{
+    report[METER_REPORT_UPDATES] = g_meter.updates;
+    report[METER_REPORT_FRAMES] = g_meter.frames;
+
+    for(unsigned i = 0; i < METER_NUM_CHANS; i++)
+    {
+        report[METER_REPORT_PEAK(i)] = g_meter.peak[i];
+        report[METER_REPORT_RMS(i)] = g_meter.rms[i];
+        report[METER_REPORT_CLIPS(i)] = g_meter.clips[i];
+    }
+}
+
+unsigned MeterClipQuarters(void)
+{
+    return g_meter.clipped;
+}
+
+void MeterReset(void)
+{
+    g_meter.updates = 0;
+    for(unsigned i = 0; i < METER_NUM_CHANS; i++)
+    {
+        g_meter.clips[i] = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef _METER_H_
+#define _METER_H_
+
+/*
+ * Per-channel level metering (METER_ENABLE): peak, RMS and clip count of every USB channel,
+ * host to device (what goes to the DACs and digital outputs) then device to host (the ADCs and
+ * digital inputs), so that a rack can be metered without capturing the streams on the host.
+ *
+ * MeterFrame() is called from UserBufferManagement() on the audio thread. Per channel and sample
+ * it takes the absolute value into the peak, the sample squared into a 64-bit sum and counts
+ * samples at or above METER_CLIP_LEVEL, some ten instructions. Every 1/METER_RATE_HZ seconds it
+ * hands the period's sums to MeterPoll() by switching to the second of two sets, so it never
+ * copies, clears or waits. If MeterPoll() has not yet taken the previous period, the current one
+ * is carried on until it has, up to METER_MAX_PERIOD_FRAMES frames, after which frames are left
+ * out of the meter.
+ *
+ * MeterPoll(), called every METER_POLL_TICKS by DiagTask() (extensions/diag.h) on
+ * AUDIO_IO_TILE, takes each period (MeterCollect()), works out the RMS and makes the levels
+ * available:
+ *
+ *   - over VENDOR_REQUEST_METER (shared/vendor_requests.h), handled by MeterRequest(). The
+ *     update rate can be changed at run time the same way. DiagTask() answers with
+ *     MeterCommand()
+ *   - with METER_XSCOPE, on the METER_PEAK, METER_RMS and METER_CLIPS xscope probes after each
+ *     period, one value per channel: (channel << 16) | value, the value as in the vendor request
+ *   - with METER_CLIP_LEDS, on the four LEDs on p_leds (extensions/audiostream.xc) in place of
+ *     the stream status: LED n is lit while any channel of the nth quarter of the channels has
+ *     clipped within METER_CLIP_HOLD_MS. MeterLeds() drives the LEDs from tile 0 and takes a
+ *     core there
+ *
+ * Peak and RMS are linear, 0x7FFFFFFF being full scale.
+ */
+
+#include "xua_conf.h"
+
+#ifndef METER_ENABLE
+#define METER_ENABLE                (0)
+#endif
+
+/* Default update rate and the highest allowed over the vendor request */
+#ifndef METER_RATE_HZ
+#define METER_RATE_HZ               (20)
+#endif
+
+#define METER_MAX_RATE_HZ           (100)
+
+/* Longest period: the sum of squares holds this many full scale 24-bit samples (2^46 each) */
+#define METER_MAX_PERIOD_FRAMES     ((1 << 18) - 1)
+
+/* Lowest update rate over the vendor request, for a period at MAX_FREQ to fit */
+#define METER_MIN_RATE_HZ           ((MAX_FREQ + METER_MAX_PERIOD_FRAMES - 1) / METER_MAX_PERIOD_FRAMES)
+
+#if ((METER_RATE_HZ) < (METER_MIN_RATE_HZ)) || ((METER_RATE_HZ) > (METER_MAX_RATE_HZ))
+#error METER_RATE_HZ must be from METER_MIN_RATE_HZ to METER_MAX_RATE_HZ
+#endif
+
+/* Samples with an absolute value at or above this count as clipped, default the largest 24-bit
+ * value */
+#ifndef METER_CLIP_LEVEL
+#define METER_CLIP_LEVEL            (0x7FFFFF00)
+#endif
+
+#ifndef METER_XSCOPE
+#define METER_XSCOPE                (1)
+#endif
+
+#ifndef METER_CLIP_LEDS
+#define METER_CLIP_LEDS             (0)
+#endif
+
+#ifndef METER_CLIP_HOLD_MS
+#define METER_CLIP_HOLD_MS          (500)
+#endif
+
+/* Interval at which MeterPoll() looks for a complete period, in reference timer ticks */
+#ifndef METER_POLL_TICKS
+#define METER_POLL_TICKS            (100000)
+#endif
+
+#ifndef METER_CHANS_OUT
+#define METER_CHANS_OUT             (NUM_USB_CHAN_OUT)
+#endif
+
+#ifndef METER_CHANS_IN
+#define METER_CHANS_IN              (NUM_USB_CHAN_IN)
+#endif
+
+#define METER_NUM_CHANS             (METER_CHANS_OUT + METER_CHANS_IN)
+
+#define METER_NUM_LEDS              (4)
+
+/* Report: periods collected since reset, frames in the last period, then for each channel the
+ * peak and RMS of the last period and the clipped samples since reset */
+#define METER_REPORT_UPDATES        (0)
+#define METER_REPORT_FRAMES         (1)
+#define METER_REPORT_PEAK(chan)     (2 + (3 * (chan)))
+#define METER_REPORT_RMS(chan)      (3 + (3 * (chan)))
+#define METER_REPORT_CLIPS(chan)    (4 + (3 * (chan)))
+#define METER_REPORT_WORDS          (2 + (3 * METER_NUM_CHANS))
+
+/* Vendor request data, see VENDOR_REQUEST_METER: a 4 byte header then 6 bytes per channel */
+#define METER_REQUEST_BYTES         (4 + (6 * METER_NUM_CHANS))
+
+/* Levels as sent in the vendor request and on xscope, 16 bits */
+#define METER_LEVEL16(level)        ((level) >> 15)
+#define METER_COUNT16(count)        (((count) > 0xFFFF) ? 0xFFFF : (count))
+
+/* Commands from MeterRequest() to MeterCommand(), sent as VENDOR_REQUEST_CMD() */
+#define METER_CMD_READ              (0)     /* -> report words */
+#define METER_CMD_RESET             (1)     /* -> 1 */
+#define METER_CMD_RATE              (2)     /* rate in Hz -> 1, or 0 if out of range */
+
+#if (METER_ENABLE)
+
+/* Audio thread: meters one frame, and starts a new period at the sample rate set by
+ * MeterSetSampFreq() */
+void MeterFrame(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[]);
+void MeterSetSampFreq(unsigned samFreq);
+
+/* MeterPoll(): takes a completed period if there is one, returns 1 if so */
+unsigned MeterCollect(void);
+
+/* Fills report with METER_REPORT_WORDS words */
+void MeterReport(unsigned report[]);
+
+/* Returns a mask of the METER_NUM_LEDS quarters of the channels that clipped in the last period */
+unsigned MeterClipQuarters(void);
+
+/* Clears the clip counts and the number of periods */
+void MeterReset(void);
+
+/* Update rate from the next period, METER_MIN_RATE_HZ to METER_MAX_RATE_HZ. Returns 0 if out of
+ * range */
+unsigned MeterSetRate(unsigned rateHz);
+
+#ifdef __XC__
+#include "xud_device.h"
+
+/* Takes a completed period if there is one, and shows it on xscope and on the LEDs (c_leds to
+ * MeterLeds(), null without METER_CLIP_LEDS). now is the reference timer */
+void MeterPoll(unsigned now, chanend ?c_leds);
+
+/* Answers one command, already taken from c */
+void MeterCommand(chanend c, unsigned cmd);
+
+/* Handles VENDOR_REQUEST_METER, returns XUD_RES_ERR for any other request */
+int MeterRequest(XUD_ep ep0_out, XUD_ep ep0_in, USB_SetupPacket_t &sp, chanend c);
+#endif
+
+#else
+#define MeterFrame(sampsFromUsbToAudio, sampsFromAudioToUsb)
+#define MeterSetSampFreq(samFreq)
+#endif
+
+#endif
@@ -0,0 +1,306 @@
+#include <stdint.h>
+#include "xua_conf.h"
+#include "sw_pll.h"
+
+#if (SW_PLL_ENABLE)
+
+#define SW_PLL_XTAL_HZ          (24000000)
+#define SW_PLL_FRAC_N_MAX       (256)
+#define SW_PLL_FRAC_ENABLE      (0x80000000)
+#define SW_PLL_RANGE_PPB        ((int64_t) SW_PLL_RANGE_PPM * 1000)
+
+unsigned g_swPllLocked = 0;
+unsigned g_swPllLockTicks = 0;
+int g_swPllPpb = 0;
+int g_swPllPhaseNs = 0;
+unsigned g_swPllUpdates = 0;
+unsigned g_swPllSlips = 0;
+unsigned g_swPllUnlocks = 0;
+unsigned g_swPllFrac = 0;
+
+static struct
+{
+    unsigned mclk;
+    unsigned ref;
+    unsigned fint;              /* F + 1 */
+    unsigned den;               /* 4 * OD * FOD * (R + 1) */
+    int64_t fdNom;              /* Nominal FD, Q24 */
+    uint64_t mclkQ16;           /* MCLK frequency with the current FRAC, Q16 Hz */
+
+    unsigned started;
+    unsigned startTicks;
+    unsigned lastTicks;
+    int64_t err;                /* MCLK cycles output minus expected, Q16 */
+    uint64_t outRem;            /* Remainders of the cycle counts */
+    uint64_t expRem;
+
+    unsigned acquire;           /* Periods measured before the loop closes, 0 once closed */
+    int64_t integ;              /* Integrator, ppb << SW_PLL_KI_SHIFT */
+    int64_t ppb;                /* Correction applied */
+    unsigned lockCount;
+    uint64_t meanSq;            /* Mean square phase error, (Q8 ns)^2 << 6 */
+} g_swPll;
+
+/* MCLK frequency (Q16 Hz) with FD = fint + m/n */
+static uint64_t MclkQ16(unsigned m, unsigned n)
+{
+    return (((uint64_t) (g_swPll.fint * n + m) * SW_PLL_XTAL_HZ) << 16) / ((uint64_t) n * g_swPll.den);
+}
+
+/* Phase error err (Q16 cycles) accumulated over periods reference periods, as a frequency error
+ * in ppb: err / (periods * mclk / ref) */
+static int64_t PhasePpb(int64_t err, unsigned periods)
+{
+    /* 1e9 / 2^16 = 1953125 / 2^7 */
+    return ((err * g_swPll.ref / periods) * 1953125 / g_swPll.mclk) / 128;
+}
+
+/* Best m/n (n <= SW_PLL_FRAC_N_MAX) for x / 2^24, 0 < x < 2^24, from the continued fraction of x */
+static void BestFrac(uint32_t x, unsigned *m, unsigned *n)
+{
+    uint64_t num = x;
+    uint64_t den = 1 << 24;
+    uint64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+
+    while(1)
+    {
+        const uint64_t a = num / den;
+        const uint64_t p2 = a * p1 + p0;
+        const uint64_t q2 = a * q1 + q0;
+
+        if(q2 > SW_PLL_FRAC_N_MAX)
+        {
+            /* Closest of the last convergent and the largest semiconvergent that fits */
+            const uint64_t k = (SW_PLL_FRAC_N_MAX - q0) / q1;
+            const uint64_t ps = p0 + k * p1;
+            const uint64_t qs = q0 + k * q1;
+            const int64_t e1 = (int64_t) (p1 << 24) - (int64_t) (x * q1);
+            const int64_t e2 = (int64_t) (ps << 24) - (int64_t) (x * qs);
+            const uint64_t a1 = (e1 < 0) ? -e1 : e1;
+            const uint64_t a2 = (e2 < 0) ? -e2 : e2;
+
+            if((k > 0) && (a2 * q1 < a1 * qs))
+            {
+                p1 = ps;
+                q1 = qs;
+            }
+            break;
+        }
+
+        p0 = p1;
+        q0 = q1;
+        p1 = p2;
+        q1 = q2;
+
+        const uint64_t r = num - a * den;
+        if(r == 0)
+        {
+            break;
+        }
+        num = den;
+        den = r;
+    }
+
+    /* FRAC holds m - 1 and n - 1, 0 < m < n */
+    if(p1 == 0)
+    {
+        p1 = 1;
+        q1 = SW_PLL_FRAC_N_MAX;
+    }
+    else if(p1 >= q1)
+    {
+        p1 = SW_PLL_FRAC_N_MAX - 1;
+        q1 = SW_PLL_FRAC_N_MAX;
+    }
+
+    *m = (unsigned) p1;
+    *n = (unsigned) q1;
+}
+
+/* Realigns the phase and measures the frequency again, keeping the current FRAC */
+static void Restart()
+{
+    g_swPll.err = 0;
+    g_swPll.outRem = 0;
+    g_swPll.expRem = 0;
+    g_swPll.acquire = 1;
+    g_swPll.lockCount = 0;
+    g_swPllLocked = 0;
+}
+
+void SwPllInit(unsigned mclk, unsigned ref, unsigned ctl, unsigned div, unsigned frac, unsigned now)
+{
+    const unsigned r = ctl & 0x3F;
+    const unsigned od = ((ctl >> 23) & 0x7) + 1;
+    const unsigned fod = (div & 0x1FF) + 1;
+    unsigned m = 0;
+    unsigned n = 1;
+
+    g_swPll.mclk = mclk;
+    g_swPll.ref = ref;
+    g_swPll.fint = ((ctl >> 8) & 0x1FFF) + 1;
+    g_swPll.den = 4 * od * fod * (r + 1);
+
+    if(frac & SW_PLL_FRAC_ENABLE)
+    {
+        m = ((frac >> 8) & 0xFF) + 1;
+        n = (frac & 0xFF) + 1;
+    }
+    g_swPll.fdNom = ((int64_t) g_swPll.fint << 24) + (((int64_t) m << 24) / n);
+    g_swPll.mclkQ16 = MclkQ16(m, n);
+
+    g_swPll.started = 0;
+    g_swPll.startTicks = now;
+    g_swPll.integ = 0;
+    g_swPll.ppb = 0;
+    g_swPll.meanSq = 0;
+    Restart();
+
+    g_swPllLockTicks = 0;
+    g_swPllPpb = 0;
+    g_swPllPhaseNs = 0;
+    g_swPllFrac = frac;
+}
+
+unsigned SwPllUpdate(unsigned ticks)
+{
+    const unsigned dt = ticks - g_swPll.lastTicks;
+    g_swPll.lastTicks = ticks;
+
+    if(!g_swPll.started)
+    {
+        g_swPll.started = 1;
+        return 0;
+    }
+
+    g_swPllUpdates++;
+
+    /* Reference periods since the last edge, normally 1 */
+    const unsigned periods = (unsigned) (((uint64_t) dt * g_swPll.ref + SW_PLL_TIMER_HZ / 2) / SW_PLL_TIMER_HZ);
+    if((periods == 0) || (periods > SW_PLL_MAX_GAP_PERIODS))
+    {
+        g_swPllSlips++;
+        Restart();
+        return 0;
+    }
+
+    /* MCLK cycles output since the last edge, and expected from the reference */
+    const uint64_t out = g_swPll.mclkQ16 * dt + g_swPll.outRem;
+    g_swPll.outRem = out % SW_PLL_TIMER_HZ;
+
+    const uint64_t exp = ((uint64_t) g_swPll.mclk << 16) * periods + g_swPll.expRem;
+    g_swPll.expRem = exp % g_swPll.ref;
+
+    g_swPll.err += (int64_t) (out / SW_PLL_TIMER_HZ) - (int64_t) (exp / g_swPll.ref);
+
+    const int64_t errNsQ8 = (g_swPll.err * 1000000000) / g_swPll.mclk / 256;
+    g_swPllPhaseNs = (int) (errNsQ8 / 256);
+
+    if(g_swPll.acquire)
+    {
+        /* Measuring the frequency error of the current FRAC */
+        if(g_swPll.acquire++ < SW_PLL_ACQUIRE_PERIODS)
+        {
+            return 0;
+        }
+
+        int64_t ppb = g_swPll.ppb - PhasePpb(g_swPll.err, SW_PLL_ACQUIRE_PERIODS);
+        ppb = (ppb > SW_PLL_RANGE_PPB) ? SW_PLL_RANGE_PPB : ppb;
+        ppb = (ppb < -SW_PLL_RANGE_PPB) ? -SW_PLL_RANGE_PPB : ppb;
+
+        g_swPll.integ = -ppb * (1 << SW_PLL_KI_SHIFT);
+        g_swPll.err = 0;
+        g_swPll.acquire = 0;
+    }
+    else if((g_swPll.err > ((int64_t) SW_PLL_SLIP_CYCLES << 16)) || (g_swPll.err < -((int64_t) SW_PLL_SLIP_CYCLES << 16)))
+    {
+        g_swPllSlips++;
+        Restart();
+        return 0;
+    }
+
+    /* PI loop on the phase error */
+    const int64_t pe = PhasePpb(g_swPll.err, 1);
+    const int64_t integMax = SW_PLL_RANGE_PPB * (1 << SW_PLL_KI_SHIFT);
+
+    g_swPll.integ += pe;
+    g_swPll.integ = (g_swPll.integ > integMax) ? integMax : g_swPll.integ;
+    g_swPll.integ = (g_swPll.integ < -integMax) ? -integMax : g_swPll.integ;
+
+    int64_t ppb = -(pe >> SW_PLL_KP_SHIFT) - (g_swPll.integ >> SW_PLL_KI_SHIFT);
+    ppb = (ppb > SW_PLL_RANGE_PPB) ? SW_PLL_RANGE_PPB : ppb;
+    ppb = (ppb < -SW_PLL_RANGE_PPB) ? -SW_PLL_RANGE_PPB : ppb;
+    g_swPll.ppb = ppb;
+    g_swPllPpb = (int) ppb;
+
+    /* Lock and jitter */
+    const int64_t errNs = (errNsQ8 < 0) ? -errNsQ8 / 256 : errNsQ8 / 256;
+    g_swPll.meanSq = g_swPll.meanSq - (g_swPll.meanSq >> 6) + (uint64_t) (errNsQ8 * errNsQ8);
+
+    if(errNs <= SW_PLL_LOCK_NS)
+    {
+        if((g_swPll.lockCount < SW_PLL_LOCK_COUNT) && (++g_swPll.lockCount == SW_PLL_LOCK_COUNT))
+        {
+            g_swPllLocked = 1;
+            if(g_swPllLockTicks == 0)
+            {
+                g_swPllLockTicks = ticks - g_swPll.startTicks;
+            }
+        }
+    }
+    else if(!g_swPllLocked || (errNs > 4 * SW_PLL_LOCK_NS))
+    {
+        g_swPllUnlocks += g_swPllLocked;
+        g_swPll.lockCount = 0;
+        g_swPllLocked = 0;
+    }
+
+    /* FD for the correction, as F + 1 and the closest m/n */
+    int64_t x = g_swPll.fdNom + (((g_swPll.fdNom >> 8) * ppb) / 3906250) - ((int64_t) g_swPll.fint << 24);
+    x = (x < 1) ? 1 : x;
+    x = (x > (1 << 24) - 1) ? (1 << 24) - 1 : x;
+
+    unsigned m, n;
+    BestFrac((uint32_t) x, &m, &n);
+
+    const unsigned frac = SW_PLL_FRAC_ENABLE | ((m - 1) << 8) | (n - 1);
+    if(frac == g_swPllFrac)
+    {
+        return 0;
+    }
+
+    g_swPll.mclkQ16 = MclkQ16(m, n);
+    g_swPllFrac = frac;
+    return frac;
+}
+
+unsigned SwPllJitterPs(void)
+{
+    /* Integer square root of the mean square (Q8 ns)^2 */
+    const uint64_t v = g_swPll.meanSq >> 6;
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+
+    while(bit > v)
+    {
+        bit >>= 2;
+    }
+    uint64_t rem = v;
+    while(bit)
+    {
+        if(rem >= root + bit)
+        {
+            rem -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (unsigned) ((root * 1000) / 256);
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef _SW_PLL_H_
+#define _SW_PLL_H_
+
+#include <stdint.h>
+
+/*
+ * Software MCLK recovery on the AppPLL (SW_PLL_ENABLE), in place of the CS2100.
+ *
+ * lib_xua produces a reference clock of PLL_SYNC_FREQ Hz from the USB SOFs (sync mode) or the
+ * received S/PDIF or ADAT samples. SwPllTask() timestamps its rising edges with the reference
+ * timer and passes them to SwPllUpdate(), which steers MCLK to PLL_SYNC_FREQ times the MCLK/ref
+ * ratio by rewriting the AppPLL fractional divider (AppPllSetFrac()), so the PLL never re-locks.
+ *
+ * The AppPLL and the reference timer both run from the 24MHz crystal, so the MCLK phase is known
+ * exactly from the timer and the divider settings written. The phase error is that phase minus
+ * the expected MCLK cycles for the reference edges seen, and drives a PI loop (critically damped
+ * with the default gains, time constant 2^SW_PLL_KP_SHIFT reference periods). The first
+ * SW_PLL_ACQUIRE_PERIODS periods measure the frequency error to preset the integrator, so lock
+ * only has to pull in the phase.
+ *
+ * The fractional divider is m/n with n at most 256, SwPllUpdate() picks the closest m/n to the
+ * FD the loop asks for. Steps are a fraction of a ppm with the g_appPllTrimSettings[] entries,
+ * the loop dithers between neighbouring m/n to average the rest.
+ *
+ * lib_xua drives the reference on PORT_PLL_REF, an output it owns. SwPllTask() takes it on its
+ * own 1-bit input, PORT_SW_PLL_REF (XS1_PORT_1E, X0D12, on tile[0] of the xCORE-AUDIO 316 MC),
+ * which needs a link from X0D00 (PORT_PLL_REF) on the board. It waits on pin change events and
+ * takes the edge time from the port timestamp. SwPllTask() takes a logical core on PLL_REF_TILE
+ * but is paused apart from one SwPllUpdate() per reference period (some hundreds of
+ * instructions), so it takes no issue slots from the other cores on the tile.
+ *
+ * A stock board does not have the link, so SW_PLL_ENABLE also needs SW_PLL_REF_LINK to say the
+ * board has been modified. The build configs are only there with SW_PLL_REF_LINK=1 on the xmake
+ * or cmake command line, and the tests only run them with xk_316_mc_sw_pll_ref_link set.
+ *
+ * Everything is integer arithmetic so the same code runs on the host, see
+ * tests/host_tests/test_sw_pll.c which plays recorded or synthetic reference edge timestamps.
+ */
+
+/* Loop gains as shifts: proportional 1/2^KP, integral 1/2^KI of the phase error per period. KI
+ * = 2 * KP + 2 is critically damped */
+/* Set for a board with X0D00 linked to X0D12, needed by SW_PLL_ENABLE */
+#ifndef SW_PLL_REF_LINK
+#define SW_PLL_REF_LINK             (0)
+#endif
+
+#ifndef SW_PLL_KP_SHIFT
+#define SW_PLL_KP_SHIFT             (5)
+#endif
+
+#ifndef SW_PLL_KI_SHIFT
+#define SW_PLL_KI_SHIFT             (12)
+#endif
+
+/* Reference periods measured before the loop closes */
+#ifndef SW_PLL_ACQUIRE_PERIODS
+#define SW_PLL_ACQUIRE_PERIODS      (16)
+#endif
+
+/* Largest correction from the nominal MCLK, must be within the trim range of
+ * g_appPllTrimSettings[] (see shared/apppll_gen.py) */
+#ifndef SW_PLL_RANGE_PPM
+#define SW_PLL_RANGE_PPM            (500)
+#endif
+
+/* Locked once the phase error has been within SW_PLL_LOCK_NS for SW_PLL_LOCK_COUNT consecutive
+ * periods, unlocked again when it exceeds 4 * SW_PLL_LOCK_NS. The reference is toggled by
+ * software in lib_xua, so its edges carry some hundreds of ns of jitter */
+#ifndef SW_PLL_LOCK_NS
+#define SW_PLL_LOCK_NS              (2000)
+#endif
+
+#ifndef SW_PLL_LOCK_COUNT
+#define SW_PLL_LOCK_COUNT           (32)
+#endif
+
+/* Phase errors beyond this (in MCLK cycles) are a slip: the phase is realigned and the
+ * frequency measured again */
+#define SW_PLL_SLIP_CYCLES          (256)
+
+/* More missed reference edges than this between two updates also counts as a slip */
+#define SW_PLL_MAX_GAP_PERIODS      (8)
+
+#define SW_PLL_TIMER_HZ             (100000000)
+
+/* Stream the loop state over xscope (SWPLL_* probes in config.xscope), one probe write every
+ * SW_PLL_REPORT reference periods in the order SWPLL_PPB, SWPLL_PHASE, SWPLL_JITTER,
+ * SWPLL_LOCKED. 0 for off */
+#ifndef SW_PLL_REPORT
+#define SW_PLL_REPORT               (0)
+#endif
+
+/* Print "SWPLL <ticks>" for each reference edge, for playing back with test_sw_pll. Needs xscope
+ * I/O (-fxscope) to keep up */
+#ifndef SW_PLL_TRACE
+#define SW_PLL_TRACE                (0)
+#endif
+
+/* Status, for reading with a debugger, over xscope (SW_PLL_REPORT) or by the host model */
+extern unsigned g_swPllLocked;
+extern unsigned g_swPllLockTicks;       /* Init to first lock, 0 if not yet locked */
+extern int g_swPllPpb;                  /* Correction from the nominal MCLK, i.e. reference ppm */
+extern int g_swPllPhaseNs;              /* Phase error at the last update */
+extern unsigned g_swPllUpdates;
+extern unsigned g_swPllSlips;
+extern unsigned g_swPllUnlocks;         /* Lock lost other than by a slip */
+extern unsigned g_swPllFrac;            /* Current FRAC register value */
+
+/* Starts recovery of mclk (Hz) from a ref Hz reference, the AppPLL having just been set up with
+ * ctl, div and frac (a g_appPllTrimSettings[] entry). now is the reference timer */
+void SwPllInit(unsigned mclk, unsigned ref, unsigned ctl, unsigned div, unsigned frac, unsigned now);
+
+/* Called with the reference timer value of each rising reference edge. Returns a new FRAC
+ * register value to write with AppPllSetFrac(), or 0 if it has not changed */
+unsigned SwPllUpdate(unsigned ticks);
+
+/* RMS phase error over roughly the last 64 periods, in ps */
+unsigned SwPllJitterPs(void);
+
+#endif
@@ -16,19 +16,138 @@ extern void board_setup();
 extern port p_scl;
 extern port p_sda;
 
+/* I2C bus speed. The DACs, ADCs and I2C mux support fast-mode (400kbps) but the CS2100 only
+ * standard mode, so fast-mode is used only when the CS2100 is not (see USE_FRACTIONAL_N in
+ * audiohw.xc). An expression rather than #if: this is included from xua_conf.h, before lib_xua
+ * defines XUA_SYNCMODE and XUA_SYNCMODE_SYNC */
+#ifndef I2C_SPEED_KBPS
+#define I2C_SPEED_KBPS      (((XUA_SPDIF_RX_EN || XUA_ADAT_RX_EN || (XUA_SYNCMODE == XUA_SYNCMODE_SYNC)) \
+                                && !(SW_PLL_ENABLE)) ? 100 : 400)
+#endif
+
+#if (DSP_ENABLE)
+#include "../dsp/dsp_transport.h"
+
+#if (DSP_CONTROL_ENABLE)
+/* The other end of c_dspCtrl is passed to VendorRequests() (see VENDOR_REQUESTS_PARAMS) */
+#define DSP_MAIN_DECLARATIONS chan c_dsp; chan c_dspCtrl;
+#define DSP_MAIN_CTRL c_dspCtrl
+#else
+#define DSP_MAIN_DECLARATIONS chan c_dsp;
+#define DSP_MAIN_CTRL null
+#endif
+
+#define DSP_MAIN_CORES  on tile[AUDIO_IO_TILE]: {\
+                                        unsafe\
+                                        {\
+                                            uc_dsp = (chanend) c_dsp;\
+                                        }\
+                                    }\
+                        on tile[DSP_TILE]: dsp_main(c_dsp, DSP_MAIN_CTRL);
+#else
+#define DSP_MAIN_DECLARATIONS
+#define DSP_MAIN_CORES
+#endif
+
+#if (DIRECT_MONITOR_ENABLE)
+extern unsafe chanend uc_directMonitor;
+
+/* The other end of c_directMonitor is passed to VendorRequests() (see VENDOR_REQUESTS_PARAMS) */
+#define DIRECT_MONITOR_DECLARATIONS chan c_directMonitor;
+
+#define DIRECT_MONITOR_CORES on tile[AUDIO_IO_TILE]: {\
+                                        unsafe\
+                                        {\
+                                            uc_directMonitor = (chanend) c_directMonitor;\
+                                        }\
+                                    }
+#else
+#define DIRECT_MONITOR_DECLARATIONS
+#define DIRECT_MONITOR_CORES
+#endif
+
+#if (SW_PLL_ENABLE)
+void SwPllTask(chanend c);
+
+extern unsafe chanend uc_swPll;
+
+/* AudioHwConfig() sends each new MCLK to SwPllTask() over c_swPll */
+#define SW_PLL_DECLARATIONS chan c_swPll;
+
+#define SW_PLL_CORES on tile[AUDIO_IO_TILE]: {\
+                                        unsafe\
+                                        {\
+                                            uc_swPll = (chanend) c_swPll;\
+                                        }\
+                                    }\
+                     on tile[PLL_REF_TILE]: SwPllTask(c_swPll);
+#else
+#define SW_PLL_DECLARATIONS
+#define SW_PLL_CORES
+#endif
+
+#if (CORE_LOAD_ENABLE)
+void CoreLoadTask(chanend c, chanend ?c_next, unsigned tile);
+
+/* A sampler on each tile (extensions/core_load.h). The other end of c_coreLoad is passed to
+ * VendorRequests() (see VENDOR_REQUESTS_PARAMS), the tile 0 sampler passes requests for tile 1
+ * on over c_coreLoadNext */
+#define CORE_LOAD_DECLARATIONS chan c_coreLoad; chan c_coreLoadNext;
+
+#define CORE_LOAD_CORES on tile[0]: CoreLoadTask(c_coreLoad, c_coreLoadNext, 0);\
+                        on tile[1]: CoreLoadTask(c_coreLoadNext, null, 1);
+#else
+#define CORE_LOAD_DECLARATIONS
+#define CORE_LOAD_CORES
+#endif
+
+#if (EVENT_TRACE_ENABLE) || (METER_ENABLE) || (XRUN_ENABLE) || (LATENCY_ENABLE)
+void DiagTask(chanend c, chanend ?c_leds);
+
+/* One task on the audio tile serves the event trace of that tile, metering, the dropout counters
+ * of that tile and the latency stages (extensions/diag.h). The other end of c_diag is passed to
+ * VendorRequests() (see VENDOR_REQUESTS_PARAMS). With METER_CLIP_LEDS, MeterLeds() shows clips
+ * on p_leds, which is on tile 0 */
+#if (METER_ENABLE) && (METER_CLIP_LEDS)
+void MeterLeds(chanend c);
+
+#define DIAG_DECLARATIONS chan c_diag; chan c_meterLeds;
+
+#define DIAG_CORES on tile[AUDIO_IO_TILE]: DiagTask(c_diag, c_meterLeds);\
+                   on tile[0]: MeterLeds(c_meterLeds);
+#else
+#define DIAG_DECLARATIONS chan c_diag;
+
+#define DIAG_CORES on tile[AUDIO_IO_TILE]: DiagTask(c_diag, null);
+#endif
+#else
+#define DIAG_DECLARATIONS
+#define DIAG_CORES
+#endif
+
 #define USER_MAIN_DECLARATIONS \
-    interface i2c_master_if i2c[1];
+    interface i2c_master_if i2c[1];\
+    DSP_MAIN_DECLARATIONS\
+    DIRECT_MONITOR_DECLARATIONS\
+    SW_PLL_DECLARATIONS\
+    CORE_LOAD_DECLARATIONS\
+    DIAG_DECLARATIONS
 
 #define USER_MAIN_CORES on tile[0]: {\
                                         board_setup();\
-                                        i2c_master(i2c, 1, p_scl, p_sda, 100);\
+                                        i2c_master(i2c, 1, p_scl, p_sda, I2C_SPEED_KBPS);\
                                     }\
                         on tile[1]: {\
                                         unsafe\
                                         {\
                                             i_i2c_client = i2c[0];\
                                         }\
-                                    }
+                                    }\
+                        DSP_MAIN_CORES\
+                        DIRECT_MONITOR_CORES\
+                        SW_PLL_CORES\
+                        CORE_LOAD_CORES\
+                        DIAG_CORES
 #endif
 
 #endif
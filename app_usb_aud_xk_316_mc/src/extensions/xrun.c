@@ -0,0 +1,139 @@
+#include "xua_conf.h"
+#include "xrun.h"
+
+#if (XRUN_ENABLE)
+#if (SW_PLL_ENABLE)
+#include "sw_pll.h"
+#endif
+
+/* shared/cs2100.h, included by audiohw.xc */
+extern unsigned g_pllLockFails;
+
+/* Silence of one direction */
+typedef struct
+{
+    unsigned run;                       /* Silent frames so far */
+    unsigned audio;                     /* Audio seen since the restart */
+} xrun_gap_t;
+
+/* Audio thread only */
+static struct
+{
+    unsigned period;                    /* Frame period in ticks, 0 before the first rate */
+    unsigned slipTicks;
+    unsigned gapMax;                    /* Frames */
+    unsigned last;
+    unsigned restart;
+    xrun_gap_t out;
+    xrun_gap_t in;
+} g_xrun;
+
+/* Written by the audio thread only */
+static volatile unsigned g_xrunCounts[XRUN_NUM_COUNTERS];
+
+/* The counts at the last reset, reader only */
+static unsigned g_xrunBase[XRUN_NUM_COUNTERS];
+
+static inline unsigned XrunSilent(const unsigned samples[], unsigned n)
+{
+    unsigned x = 0;
+
+    for(unsigned i = 0; i < n; i++)
+    {
+        x |= samples[i];
+    }
+    return x == 0;
+}
+
+static inline void XrunGap(xrun_gap_t *g, unsigned silent, unsigned counter)
+{
+    if(silent)
+    {
+        if(g->run <= g_xrun.gapMax)
+        {
+            g->run++;
+        }
+        return;
+    }
+
+    if(g->audio && (g->run >= XRUN_GAP_MIN_FRAMES) && (g->run <= g_xrun.gapMax))
+    {
+        g_xrunCounts[counter]++;
+    }
+    g->run = 0;
+    g->audio = 1;
+}
+
+void XrunFrame(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[])
+{
+    const unsigned now = XRUN_TIME();
+    const unsigned interval = now - g_xrun.last;
+
+    g_xrun.last = now;
+
+    if(g_xrun.restart || !g_xrun.period)
+    {
+        g_xrun.restart = 0;
+        return;
+    }
+
+    if(interval > g_xrun.slipTicks)
+    {
+        g_xrunCounts[XRUN_I2S_SLIPS]++;
+        g_xrunCounts[XRUN_FRAMES_LOST] += ((interval + (g_xrun.period >> 1)) / g_xrun.period) - 1;
+    }
+
+    XrunGap(&g_xrun.out, XrunSilent(sampsFromUsbToAudio, XRUN_CHANS_OUT), XRUN_OUT_SILENCE_GAPS);
+    XrunGap(&g_xrun.in, XrunSilent(sampsFromAudioToUsb, XRUN_CHANS_IN), XRUN_IN_SILENCE_GAPS);
+}
+
+void XrunSetSampFreq(unsigned samFreq)
+{
+    g_xrun.period = 100000000 / samFreq;
+    g_xrun.slipTicks = (g_xrun.period * XRUN_SLIP_PERCENT) / 100;
+    g_xrun.gapMax = (samFreq / 1000) * XRUN_GAP_MAX_MS;
+    g_xrun.restart = 1;
+
+    /* Silence across the restart is not a silence gap */
+    g_xrun.out.run = 0;
+    g_xrun.out.audio = 0;
+    g_xrun.in.run = 0;
+    g_xrun.in.audio = 0;
+
+    g_xrunCounts[XRUN_RESTARTS]++;
+}
+
+static void XrunCurrent(unsigned counts[])
+{
+    /* The audio thread counts come first */
+    for(unsigned i = 0; i < XRUN_PLL_LOCK_FAILS; i++)
+    {
+        counts[i] = g_xrunCounts[i];
+    }
+
+    counts[XRUN_PLL_LOCK_FAILS] = g_pllLockFails;
+#if (SW_PLL_ENABLE)
+    counts[XRUN_PLL_SLIPS] = g_swPllSlips;
+    counts[XRUN_PLL_UNLOCKS] = g_swPllUnlocks;
+#else
+    counts[XRUN_PLL_SLIPS] = 0;
+    counts[XRUN_PLL_UNLOCKS] = 0;
+#endif
+}
+
+void XrunRead(unsigned counts[])
+{
+    XrunCurrent(counts);
+
+    for(unsigned i = 0; i < XRUN_NUM_COUNTERS; i++)
+    {
+        counts[i] -= g_xrunBase[i];
+    }
+}
+
+void XrunReset(void)
+{
+    XrunCurrent(g_xrunBase);
+}
+
+#endif
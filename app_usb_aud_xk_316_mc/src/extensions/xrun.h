@@ -0,0 +1,117 @@
+#ifndef _XRUN_H_
+#define _XRUN_H_
+
+/*
+ * Dropout counters (XRUN_ENABLE), so that a test or a monitoring tool can ask the device whether
+ * the audio was interrupted rather than look for the glitch in a capture.
+ *
+ * XrunFrame() is called at the start of UserBufferManagement() on the audio thread, with the
+ * samples as they come from USB and from I2S. It counts:
+ *
+ *   - I2S slips: calls more than XRUN_SLIP_PERCENT of a frame period after the previous one, so
+ *     the audio thread missed at least one frame in both directions. The frames missed are
+ *     estimated from the interval
+ *   - silence gaps, per direction: a run of XRUN_GAP_MIN_FRAMES to XRUN_GAP_MAX_MS of digital
+ *     silence on every channel with audio either side. Host to device this is what lib_xua plays
+ *     when its USB buffer underflows, device to host what a lost I2S input looks like. Longer runs
+ *     are taken to be the host pausing
+ *
+ * Silence gaps are not a count of USB underflows. lib_xua has no hook in the decoupler, where an
+ * underflow happens, so it is inferred from what reaches the audio thread. Audio that is itself
+ * silent for a few frames, the host muting the stream for less than XRUN_GAP_MAX_MS or a
+ * source that plays zeros between tracks all count, and an underflow while the stream is
+ * already silent, or one that repeats the last samples rather than playing zeros, does not. Read
+ * them as dropouts only with a test signal that is never silent, such as a sine
+ *
+ * XrunSetSampFreq(), from AudioHwConfig(), counts the restarts of the audio (sample rate and
+ * DSD/PCM changes) and excludes the gap in the audio they cause from the above. The MCLK clock
+ * counts come from the existing status: PLL lock timeouts (g_pllLockFails, CS2100 or SW PLL)
+ * and, with SW_PLL_ENABLE, SW PLL slips and losses of lock.
+ *
+ * Counters are read and reset over VENDOR_REQUEST_XRUN (shared/vendor_requests.h), handled by
+ * XrunRequest() on Endpoint 0. It reads the counters of XUD_TILE itself and asks DiagTask()
+ * (extensions/diag.h) on AUDIO_IO_TILE for the others, answered by XrunCommand(). Each thread only
+ * writes its own counts, a reset stores the current counts as the new zero.
+ *
+ * XrunFrame() costs a couple of instructions per channel and some tens per frame.
+ */
+
+#include "xua_conf.h"
+
+#ifndef XRUN_ENABLE
+#define XRUN_ENABLE                 (0)
+#endif
+
+/* Intervals between UserBufferManagement() calls above this percentage of the frame period are
+ * a slip */
+#ifndef XRUN_SLIP_PERCENT
+#define XRUN_SLIP_PERCENT           (150)
+#endif
+
+/* Shortest and longest run of silence counted as a gap */
+#ifndef XRUN_GAP_MIN_FRAMES
+#define XRUN_GAP_MIN_FRAMES         (2)
+#endif
+
+#ifndef XRUN_GAP_MAX_MS
+#define XRUN_GAP_MAX_MS             (50)
+#endif
+
+#ifndef XRUN_CHANS_OUT
+#define XRUN_CHANS_OUT              (NUM_USB_CHAN_OUT)
+#endif
+
+#ifndef XRUN_CHANS_IN
+#define XRUN_CHANS_IN               (NUM_USB_CHAN_IN)
+#endif
+
+/* Reference timer, replaceable for host builds */
+#ifndef XRUN_TIME
+#define XRUN_TIME()                 ({unsigned _t; asm volatile("gettime %0" : "=r"(_t)); _t;})
+#endif
+
+/* Counters, in the order of the vendor request */
+#define XRUN_I2S_SLIPS              (0)
+#define XRUN_FRAMES_LOST            (1)
+#define XRUN_OUT_SILENCE_GAPS       (2)     /* Host to device */
+#define XRUN_IN_SILENCE_GAPS        (3)     /* Device to host */
+#define XRUN_RESTARTS               (4)
+#define XRUN_PLL_LOCK_FAILS         (5)
+#define XRUN_PLL_SLIPS              (6)
+#define XRUN_PLL_UNLOCKS            (7)
+#define XRUN_NUM_COUNTERS           (8)
+
+/* Commands from XrunRequest() to XrunCommand(), sent as VENDOR_REQUEST_CMD() */
+#define XRUN_CMD_READ               (0)     /* -> XRUN_NUM_COUNTERS counters */
+#define XRUN_CMD_RESET              (1)     /* -> 1 */
+
+#if (XRUN_ENABLE)
+
+/* Audio thread: checks the timing and silence of one frame */
+void XrunFrame(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[]);
+
+/* Audio thread: the audio restarts at samFreq */
+void XrunSetSampFreq(unsigned samFreq);
+
+/* Fills counts with the XRUN_NUM_COUNTERS counters of the calling tile since the last reset */
+void XrunRead(unsigned counts[]);
+
+void XrunReset(void);
+
+#ifdef __XC__
+#include "xud_device.h"
+
+/* Answers one command, already taken from c */
+void XrunCommand(chanend c, unsigned cmd);
+
+/* Handles VENDOR_REQUEST_XRUN, returns XUD_RES_ERR for any other request. c is the channel to
+ * DiagTask() */
+int XrunRequest(XUD_ep ep0_out, XUD_ep ep0_in, USB_SetupPacket_t &sp, chanend c);
+#endif
+
+#else
+#define XrunFrame(sampsFromUsbToAudio, sampsFromAudioToUsb)
+#define XrunSetSampFreq(samFreq)
+#endif
+
+#endif
@@ -12,4 +12,7 @@ set(APP_COMPILER_FLAGS_upgrade2 ${SW_USB_AUDIO_FLAGS} -DBCD_DEVICE_J=0x99
                                                       -DBCD_DEVICE_M=0x0
                                                       -DBCD_DEVICE_N=0x2)
 
+# Boot phase timestamps printed over xSCOPE for start-up time testing
+set(APP_COMPILER_FLAGS_boottime ${SW_USB_AUDIO_FLAGS} -DBOOT_TIME_REPORT=1)
+
 endif()
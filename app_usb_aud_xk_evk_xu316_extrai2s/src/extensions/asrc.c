@@ -0,0 +1,121 @@
+#include <math.h>
+#include <string.h>
+#include "extra_i2s.h"
+#include "asrc.h"
+
+#if (EXTRA_I2S_ASRC_ENABLE)
+
+/* Passband edge and stopband start, as fractions of the input rate */
+#define ASRC_PASS           (0.45)
+#define ASRC_STOP           (0.55)
+
+/* Row p holds the taps for an output p / ASRC_PHASES of an input period on, so the last row
+ * is the first shifted by one input period and adjacent rows can always be interpolated */
+static int32_t g_asrcFilter[ASRC_PHASES + 1][ASRC_TAPS];
+
+/* Zeroth order modified Bessel function of the first kind, for the Kaiser window */
+static double asrc_bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+
+    for(unsigned k = 1; k < 50; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if(term < (sum * 1e-12))
+            break;
+    }
+    return sum;
+}
+
+void asrc_init_filter(void)
+{
+    /* Kaiser design for the transition band, see Kaiser's formula for the attenuation */
+    const double atten = 2.285 * (ASRC_TAPS - 1) * 2.0 * M_PI * (ASRC_STOP - ASRC_PASS) + 7.95;
+    const double beta = (atten > 50.0) ? 0.1102 * (atten - 8.7) : 0.5842 * pow(atten - 21.0, 0.4) + 0.07886 * (atten - 21.0);
+    const double fc = (ASRC_PASS + ASRC_STOP) / 2.0;
+    const double half = ASRC_TAPS / 2.0;
+
+    for(unsigned p = 0; p <= ASRC_PHASES; p++)
+    {
+        double h[ASRC_TAPS];
+        double sum = 0.0;
+
+        for(unsigned i = 0; i < ASRC_TAPS; i++)
+        {
+            /* Distance in input periods from the output position to the sample of tap i */
+            const double t = ((double) p / ASRC_PHASES) + i - half;
+            const double x = 2.0 * fc * t;
+            const double sinc = (fabs(x) < 1e-12) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+            const double r = t / half;
+            const double w = (fabs(r) >= 1.0) ? 0.0 : asrc_bessel_i0(beta * sqrt(1.0 - r * r)) / asrc_bessel_i0(beta);
+
+            h[i] = sinc * w;
+            sum += h[i];
+        }
+
+        /* Unity gain at DC for every phase */
+        for(unsigned i = 0; i < ASRC_TAPS; i++)
+        {
+            g_asrcFilter[p][i] = (int32_t) llround((h[i] / sum) * (double)(1 << ASRC_COEF_Q));
+        }
+    }
+}
+
+void asrc_init(asrc_t *asrc, unsigned num_chans)
+{
+    memset(asrc, 0, sizeof(asrc_t));
+    asrc->num_chans = num_chans;
+}
+
+void asrc_push(asrc_t *asrc, const int32_t frame[])
+{
+    const unsigned idx = (asrc->idx == 0) ? (ASRC_TAPS - 1) : (asrc->idx - 1);
+
+    for(unsigned ch = 0; ch < asrc->num_chans; ch++)
+    {
+        asrc->hist[ch][idx] = frame[ch];
+        asrc->hist[ch][idx + ASRC_TAPS] = frame[ch];
+    }
+    asrc->idx = idx;
+}
+
+void asrc_coefs(int32_t coefs[ASRC_TAPS], uint32_t frac)
+{
+    const int32_t *h0 = g_asrcFilter[frac >> (32 - ASRC_PHASES_LOG2)];
+    const int32_t *h1 = h0 + ASRC_TAPS;
+
+    /* Position between the two phases, Q31 so that the products are signed 32x32 */
+    const int32_t f = (int32_t)((frac << ASRC_PHASES_LOG2) >> 1);
+
+    for(unsigned i = 0; i < ASRC_TAPS; i++)
+    {
+        coefs[i] = h0[i] + (int32_t)(((int64_t)(h1[i] - h0[i]) * f) >> 31);
+    }
+}
+
+void asrc_output(const asrc_t *asrc, const int32_t coefs[ASRC_TAPS], int32_t frame[])
+{
+    for(unsigned ch = 0; ch < asrc->num_chans; ch++)
+    {
+        const int32_t *x = &asrc->hist[ch][asrc->idx];
+        int64_t acc = 0;
+
+        for(unsigned i = 0; i < ASRC_TAPS; i += 4)
+        {
+            acc += (int64_t) coefs[i] * x[i];
+            acc += (int64_t) coefs[i + 1] * x[i + 1];
+            acc += (int64_t) coefs[i + 2] * x[i + 2];
+            acc += (int64_t) coefs[i + 3] * x[i + 3];
+        }
+
+        acc >>= ASRC_COEF_Q;
+        if(acc > INT32_MAX)
+            acc = INT32_MAX;
+        else if(acc < INT32_MIN)
+            acc = INT32_MIN;
+        frame[ch] = (int32_t) acc;
+    }
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef _ASRC_H_
+#define _ASRC_H_
+
+#include <stdint.h>
+
+/*
+ * Polyphase resampler core for asynchronous sample-rate conversion.
+ *
+ * The interpolation filter is a Kaiser windowed sinc of ASRC_TAPS taps, tabulated at
+ * 2^ASRC_PHASES_LOG2 positions per input period. An output sample may be at any 32-bit fraction
+ * of an input period: its coefficients are linearly interpolated between the two nearest
+ * phases by asrc_coefs(). That is done once per output frame and shared by all channels, so
+ * each channel then costs ASRC_TAPS multiply-accumulates per output sample.
+ *
+ * The filter is designed for ratios close to 1 (two clocks with the same nominal rate): it
+ * passes up to 0.45 and stops from 0.55 of the input rate, with unity gain at DC for every
+ * phase. Group delay is ASRC_TAPS / 2 input frames.
+ *
+ * The caller tracks the output position. Before each output sample, push the input frames
+ * that the position has advanced past, then call asrc_output() with the fraction.
+ */
+
+#ifndef ASRC_TAPS
+#define ASRC_TAPS           (64)
+#endif
+
+/* Phases per input period. The table is (ASRC_PHASES + 1) * ASRC_TAPS words, 66KB by default;
+ * each halving of the phases costs about 12dB of noise at high frequencies */
+#ifndef ASRC_PHASES_LOG2
+#define ASRC_PHASES_LOG2    (8)
+#endif
+
+#define ASRC_PHASES         (1 << ASRC_PHASES_LOG2)
+
+/* Channels per instance */
+#ifndef ASRC_MAX_CHANS
+#define ASRC_MAX_CHANS      (8)
+#endif
+
+#define ASRC_COEF_Q         (30)
+
+typedef struct
+{
+    unsigned num_chans;
+    unsigned idx;                               /* Slot of the newest frame, [0, ASRC_TAPS) */
+
+    /* Each sample is stored twice, ASRC_TAPS apart, so the newest ASRC_TAPS samples of a
+     * channel are always contiguous (newest first) from hist[ch][idx] */
+    int32_t hist[ASRC_MAX_CHANS][2 * ASRC_TAPS];
+} asrc_t;
+
+/* Tabulates the filter shared by all instances. Takes some milliseconds, call once before
+ * audio is running */
+void asrc_init_filter(void);
+
+/* Sets the number of channels and clears the history */
+void asrc_init(asrc_t *asrc, unsigned num_chans);
+
+/* Adds one input frame of num_chans samples */
+void asrc_push(asrc_t *asrc, const int32_t frame[]);
+
+/* Coefficients for an output frac (Q32) of an input period after the frame ASRC_TAPS / 2
+ * before the newest */
+void asrc_coefs(int32_t coefs[ASRC_TAPS], uint32_t frac);
+
+/* Calculates one output frame of num_chans samples with coefficients from asrc_coefs() */
+void asrc_output(const asrc_t *asrc, const int32_t coefs[ASRC_TAPS], int32_t frame[]);
+
+#endif
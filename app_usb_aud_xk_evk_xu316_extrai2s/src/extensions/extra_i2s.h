@@ -0,0 +1,166 @@
+#ifndef _EXTRA_I2S_H_
+#define _EXTRA_I2S_H_
+
+#include <stdint.h>
+
+/* Format of the extra interface, the xCORE is always slave */
+#define EXTRA_I2S_MODE_I2S       (0)
+#define EXTRA_I2S_MODE_TDM       (1)
+
+#ifndef EXTRA_I2S_MODE
+#define EXTRA_I2S_MODE           (EXTRA_I2S_MODE_I2S)
+#endif
+
+/* Channels per data line in TDM mode - 8 or 16 */
+#ifndef EXTRA_I2S_TDM_CHANS
+#define EXTRA_I2S_TDM_CHANS      (8)
+#endif
+
+/* Number of data lines in each direction. Ports are set by EXTRA_I2S_DIN_PORTS and
+ * EXTRA_I2S_DOUT_PORTS in extra_i2s.xc */
+#ifndef EXTRA_I2S_NUM_DIN
+#define EXTRA_I2S_NUM_DIN        (1)
+#endif
+
+#ifndef EXTRA_I2S_NUM_DOUT
+#define EXTRA_I2S_NUM_DOUT       (0)
+#endif
+
+#if (EXTRA_I2S_MODE == EXTRA_I2S_MODE_TDM)
+#if (EXTRA_I2S_TDM_CHANS != 8) && (EXTRA_I2S_TDM_CHANS != 16)
+#error EXTRA_I2S_TDM_CHANS must be 8 or 16
+#endif
+#define EXTRA_I2S_CHANS_PER_LINE (EXTRA_I2S_TDM_CHANS)
+#else
+#define EXTRA_I2S_CHANS_PER_LINE (2)
+#endif
+
+/* Channels passed to/from the USB stream, by default all channels of all lines. Channels are
+ * line-major: channel (line * EXTRA_I2S_CHANS_PER_LINE) + slot is that slot of that line */
+#ifndef EXTRA_I2S_CHAN_COUNT_IN
+#define EXTRA_I2S_CHAN_COUNT_IN  (EXTRA_I2S_NUM_DIN * EXTRA_I2S_CHANS_PER_LINE)
+#endif
+
+#ifndef EXTRA_I2S_CHAN_INDEX_IN
+#define EXTRA_I2S_CHAN_INDEX_IN  (0)
+#endif
+
+#ifndef EXTRA_I2S_CHAN_COUNT_OUT
+#define EXTRA_I2S_CHAN_COUNT_OUT (EXTRA_I2S_NUM_DOUT * EXTRA_I2S_CHANS_PER_LINE)
+#endif
+
+#ifndef EXTRA_I2S_CHAN_INDEX_OUT
+#define EXTRA_I2S_CHAN_INDEX_OUT (0)
+#endif
+
+#if (EXTRA_I2S_CHAN_COUNT_IN > (EXTRA_I2S_NUM_DIN * EXTRA_I2S_CHANS_PER_LINE)) || \
+    (EXTRA_I2S_CHAN_COUNT_OUT > (EXTRA_I2S_NUM_DOUT * EXTRA_I2S_CHANS_PER_LINE))
+#error More extra I2S channels than the data lines carry
+#endif
+
+/*
+ * Samples are passed between i2s_data() and UserBufferManagement() (both on tile[1]) through
+ * single-producer/single-consumer rings in shared memory, one per direction, so neither side
+ * ever waits for the other.
+ *
+ * A consumer that finds its ring empty outputs silence, counts an underrun and waits for the
+ * ring to refill to half way before continuing. A producer that finds its ring full drops the
+ * frame and counts an overrun. Both clocks are derived from the same LRCLK, so once started the
+ * fill level stays put; the rings add about EXTRA_I2S_RING_FRAMES / 2 frames of latency.
+ */
+
+/*
+ * Asynchronous sample-rate conversion, for an I2S/TDM master that is not clocked from the
+ * device's master clock. A pool of EXTRA_I2S_ASRC_THREADS threads converts between the rings
+ * written on one clock and a second pair of rings read on the other, EXTRA_I2S_ASRC_BLOCK frames
+ * at a time. The rate ratio is measured from timer timestamps of both clocks. See
+ * extra_i2s_asrc.c
+ */
+#ifndef EXTRA_I2S_ASRC_ENABLE
+#define EXTRA_I2S_ASRC_ENABLE    (0)
+#endif
+
+#ifndef EXTRA_I2S_ASRC_THREADS
+#define EXTRA_I2S_ASRC_THREADS   (2)
+#endif
+
+#if (EXTRA_I2S_ASRC_THREADS < 1) || (EXTRA_I2S_ASRC_THREADS > 4)
+#error EXTRA_I2S_ASRC_THREADS must be between 1 and 4
+#endif
+
+/* Output frames converted per block */
+#ifndef EXTRA_I2S_ASRC_BLOCK
+#define EXTRA_I2S_ASRC_BLOCK     (8)
+#endif
+
+/* Channels converted by each ASRC thread, of the larger direction */
+#define EXTRA_I2S_ASRC_CHANS     ((EXTRA_I2S_CHAN_COUNT_IN > EXTRA_I2S_CHAN_COUNT_OUT) ? EXTRA_I2S_CHAN_COUNT_IN : EXTRA_I2S_CHAN_COUNT_OUT)
+
+#if (EXTRA_I2S_ASRC_ENABLE) && !defined(ASRC_MAX_CHANS)
+#define ASRC_MAX_CHANS           ((EXTRA_I2S_ASRC_CHANS + EXTRA_I2S_ASRC_THREADS - 1) / EXTRA_I2S_ASRC_THREADS)
+#endif
+
+/* Largest difference between the two clocks converted, beyond this the converted streams
+ * are silent */
+#ifndef EXTRA_I2S_ASRC_MAX_PPM
+#define EXTRA_I2S_ASRC_MAX_PPM   (10000)
+#endif
+
+/* Frames per ring - must be a power of 2 */
+#ifndef EXTRA_I2S_RING_FRAMES
+#if (EXTRA_I2S_ASRC_ENABLE)
+#define EXTRA_I2S_RING_FRAMES    (4 * EXTRA_I2S_ASRC_BLOCK)
+#else
+#define EXTRA_I2S_RING_FRAMES    (4)
+#endif
+#endif
+
+#if (EXTRA_I2S_RING_FRAMES & (EXTRA_I2S_RING_FRAMES - 1)) || (EXTRA_I2S_RING_FRAMES < 2)
+#error EXTRA_I2S_RING_FRAMES must be a power of 2
+#endif
+
+/* Counters for ExtraI2sRingCount() */
+#define EXTRA_I2S_IN_OVERRUNS    (0)
+#define EXTRA_I2S_IN_UNDERRUNS   (1)
+#define EXTRA_I2S_OUT_OVERRUNS   (2)
+#define EXTRA_I2S_OUT_UNDERRUNS  (3)
+
+/* Audio thread side, once per sample frame */
+void ExtraI2sRingAudio(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[]);
+
+/* i2s_data() side, from the receive()/send() callbacks */
+void ExtraI2sRingReceive(int32_t samples[]);
+void ExtraI2sRingSend(int32_t samples[]);
+
+unsigned ExtraI2sRingCount(unsigned counter);
+
+/* Clock domains timestamped for the ASRC */
+#define EXTRA_I2S_CLOCK_I2S      (0)
+#define EXTRA_I2S_CLOCK_USB      (1)
+
+/* Records the reference timer at one frame of a clock domain, from i2s_data() once per frame
+ * (EXTRA_I2S_CLOCK_I2S) and UserBufferManagement() (EXTRA_I2S_CLOCK_USB) */
+void ExtraI2sAsrcClock(unsigned domain, unsigned time);
+
+/* ASRC state: 1 while converting. Until then the converted streams are silent */
+unsigned ExtraI2sAsrcLocked();
+
+/* Measured rate of the extra interface relative to the USB audio clock, parts per million */
+int ExtraI2sAsrcPpm();
+
+#ifdef __XC__
+#include "i2s.h"
+
+/* ASRC threads, extra_i2s_asrc_main() runs as thread 0 */
+void extra_i2s_asrc_main();
+
+/* TDM slave for EXTRA_I2S_MODE_TDM, using the same callbacks as i2s_frame_slave(). Data lines
+ * carry tdm_config.channels_per_frame 32-bit slots, slot 0 starting tdm_config.offset (0 or 1)
+ * bit clocks after the rising edge of FSYNC. Samples are line-major: line * channels + slot */
+void tdm_frame_slave(client i2s_frame_callback_if i_tdm,
+        out buffered port:32 (&?p_dout)[num_out], static const size_t num_out,
+        in buffered port:32 (&?p_din)[num_in], static const size_t num_in,
+        in port p_bclk, in buffered port:32 p_fsync, clock clk_bclk);
+#endif
+
+#endif
@@ -0,0 +1,339 @@
+#include "extra_i2s_ring.h"
+#include "extra_i2s_asrc.h"
+#include "asrc.h"
+
+#if (EXTRA_I2S_ASRC_ENABLE)
+
+/*
+ * Asynchronous sample-rate conversion between the extra interface and the USB stream.
+ *
+ * Each direction is a path from a source ring written on one clock to a sink ring read on the
+ * other. Whenever a sink ring has space for EXTRA_I2S_ASRC_BLOCK frames, thread 0 schedules a
+ * block: the input frames to consume and the fractional position of each output frame. All
+ * threads then share the calculation of the filter coefficients for each frame, convert their
+ * share of the channels with them, and thread 0 advances both rings.
+ *
+ * The rate ratio is measured from the reference timer timestamps passed to ExtraI2sAsrcClock()
+ * by both clock domains, over a sliding window of ASRC_SNAPSHOTS snapshots taken every
+ * ASRC_INTERVAL frames of the extra interface. A small correction from the fill of the source
+ * ring is added so that timestamp error cannot make the rings drift.
+ *
+ * Conversion starts once ASRC_LOCK_SNAPSHOTS snapshots agree, and stops (the converted streams
+ * go silent) if the clocks differ by more than EXTRA_I2S_ASRC_MAX_PPM, if the ratio jumps by
+ * more than ASRC_SLIP_PPM, or if either clock stops, for example for a sample rate change.
+ *
+ * Latency is about 3.5 blocks in the sink ring, ASRC_TARGET_FILL frames in the source ring
+ * and ASRC_TAPS / 2 frames of filter delay: 76 frames (1.6ms at 48kHz) with the defaults.
+ */
+
+#define ASRC_INTERVAL       (1024)
+#define ASRC_SNAPSHOTS      (16)
+#define ASRC_LOCK_SNAPSHOTS (4)
+#define ASRC_SLIP_PPM       (2000)
+
+/* Q32 step for a deviation from 1 in parts per million */
+#define ASRC_PPM(ppm)       ((uint64_t)(ppm) * 4295)
+
+/* Source ring fill the conversion holds, frames */
+#define ASRC_TARGET_FILL    (EXTRA_I2S_RING_FRAMES / 2)
+
+/* Step correction per 1/256 frame of filtered fill error (Q32), about 10ppm per frame */
+#define ASRC_FILL_GAIN      (168)
+
+typedef struct
+{
+    volatile unsigned count;
+    volatile unsigned stamps[4];    /* Indexed by count, so a reader never sees a torn pair */
+} asrc_clock_t;
+
+typedef struct
+{
+    unsigned count[2];
+    unsigned stamp[2];
+} asrc_snapshot_t;
+
+typedef struct
+{
+    unsigned num_chans;
+    ring_t *src;
+    unsigned *src_data;
+    ring_t *sink;
+    unsigned *sink_data;
+    uint64_t pos;                   /* Q32, integer part is the input to push before the next output */
+    int fill_err;                   /* Source ring fill error, Q8, filtered */
+    unsigned running;
+
+    /* Current block, written by thread 0 and read by all threads */
+    unsigned reset;
+    unsigned in_tail;
+    unsigned out_head;
+    unsigned num_in;
+    unsigned push[EXTRA_I2S_ASRC_BLOCK];
+    uint32_t frac[EXTRA_I2S_ASRC_BLOCK];
+    int32_t coefs[EXTRA_I2S_ASRC_BLOCK][ASRC_TAPS];
+
+    asrc_t asrc[EXTRA_I2S_ASRC_THREADS];
+} asrc_path_t;
+
+static asrc_clock_t g_asrcClocks[2];
+
+static asrc_snapshot_t g_asrcSnaps[ASRC_SNAPSHOTS];
+static unsigned g_asrcSnapNum = 0;
+static unsigned g_asrcSnapIdx = 0;
+
+/* Input frames per output frame for each path, Q32 */
+static uint64_t g_asrcStep[EXTRA_I2S_ASRC_NUM_PATHS];
+static volatile unsigned g_asrcLocked = 0;
+static volatile int g_asrcPpm = 0;
+
+static asrc_path_t g_asrcPaths[EXTRA_I2S_ASRC_NUM_PATHS];
+
+void ExtraI2sAsrcClock(unsigned domain, unsigned time)
+{
+    asrc_clock_t *c = &g_asrcClocks[domain];
+    const unsigned n = c->count + 1;
+
+    c->stamps[n & 3] = time;
+    RING_BARRIER();
+    c->count = n;
+}
+
+static void asrc_read_clock(unsigned domain, unsigned *count, unsigned *stamp)
+{
+    const unsigned n = g_asrcClocks[domain].count;
+
+    RING_BARRIER();
+    *count = n;
+    *stamp = g_asrcClocks[domain].stamps[n & 3];
+}
+
+/* Steps for both paths between two snapshots, returns 0 if either clock has not run */
+static unsigned asrc_measure(const asrc_snapshot_t *a, const asrc_snapshot_t *b, uint64_t step[EXTRA_I2S_ASRC_NUM_PATHS])
+{
+    uint64_t period[2];
+
+    for(unsigned d = 0; d < 2; d++)
+    {
+        const unsigned n = b->count[d] - a->count[d];
+        if(n == 0)
+            return 0;
+
+        /* Ticks per frame, Q16 */
+        period[d] = ((uint64_t)(b->stamp[d] - a->stamp[d]) << 16) / n;
+        if((period[d] == 0) || (period[d] >= (1ULL << 31)))
+            return 0;
+    }
+
+    step[EXTRA_I2S_ASRC_PATH_IN] = (period[EXTRA_I2S_CLOCK_USB] << 32) / period[EXTRA_I2S_CLOCK_I2S];
+    step[EXTRA_I2S_ASRC_PATH_OUT] = (period[EXTRA_I2S_CLOCK_I2S] << 32) / period[EXTRA_I2S_CLOCK_USB];
+    return 1;
+}
+
+static inline uint64_t asrc_abs_diff(uint64_t a, uint64_t b)
+{
+    return (a > b) ? (a - b) : (b - a);
+}
+
+static void asrc_restart(const asrc_snapshot_t *now)
+{
+    g_asrcSnaps[0] = *now;
+    g_asrcSnapIdx = 0;
+    g_asrcSnapNum = 1;
+    g_asrcLocked = 0;
+}
+
+void ExtraI2sAsrcInit()
+{
+    asrc_init_filter();
+
+#if (EXTRA_I2S_CHAN_COUNT_IN > 0)
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_IN].num_chans = EXTRA_I2S_CHAN_COUNT_IN;
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_IN].src = &g_ringIn;
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_IN].src_data = &g_ringInData[0][0];
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_IN].sink = &g_ringInAsrc;
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_IN].sink_data = &g_ringInAsrcData[0][0];
+#endif
+#if (EXTRA_I2S_CHAN_COUNT_OUT > 0)
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_OUT].num_chans = EXTRA_I2S_CHAN_COUNT_OUT;
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_OUT].src = &g_ringOut;
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_OUT].src_data = &g_ringOutData[0][0];
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_OUT].sink = &g_ringOutAsrc;
+    g_asrcPaths[EXTRA_I2S_ASRC_PATH_OUT].sink_data = &g_ringOutAsrcData[0][0];
+#endif
+}
+
+void ExtraI2sAsrcUpdate()
+{
+    asrc_snapshot_t now;
+    uint64_t step[EXTRA_I2S_ASRC_NUM_PATHS];
+    uint64_t stepLast[EXTRA_I2S_ASRC_NUM_PATHS];
+
+    asrc_read_clock(EXTRA_I2S_CLOCK_I2S, &now.count[0], &now.stamp[0]);
+    asrc_read_clock(EXTRA_I2S_CLOCK_USB, &now.count[1], &now.stamp[1]);
+
+    if(g_asrcSnapNum == 0)
+    {
+        asrc_restart(&now);
+        return;
+    }
+
+    const asrc_snapshot_t *last = &g_asrcSnaps[g_asrcSnapIdx];
+    if((now.count[0] - last->count[0]) < ASRC_INTERVAL)
+    {
+        /* The extra interface has stopped if the USB clock has run on without it */
+        if((now.count[1] - last->count[1]) > (4 * ASRC_INTERVAL))
+        {
+            asrc_restart(&now);
+        }
+        return;
+    }
+
+    const asrc_snapshot_t *first = &g_asrcSnaps[(g_asrcSnapIdx + ASRC_SNAPSHOTS + 1 - g_asrcSnapNum) % ASRC_SNAPSHOTS];
+
+    if(!asrc_measure(last, &now, stepLast) || !asrc_measure(first, &now, step)
+        || (asrc_abs_diff(step[EXTRA_I2S_ASRC_PATH_IN], 1ULL << 32) > ASRC_PPM(EXTRA_I2S_ASRC_MAX_PPM))
+        || (asrc_abs_diff(stepLast[EXTRA_I2S_ASRC_PATH_IN], step[EXTRA_I2S_ASRC_PATH_IN]) > ASRC_PPM(ASRC_SLIP_PPM)))
+    {
+        asrc_restart(&now);
+        return;
+    }
+
+    /* The window drops its oldest snapshot once full */
+    g_asrcSnapIdx = (g_asrcSnapIdx + 1) % ASRC_SNAPSHOTS;
+    g_asrcSnaps[g_asrcSnapIdx] = now;
+    if(g_asrcSnapNum < ASRC_SNAPSHOTS)
+    {
+        g_asrcSnapNum++;
+    }
+
+    g_asrcStep[EXTRA_I2S_ASRC_PATH_IN] = step[EXTRA_I2S_ASRC_PATH_IN];
+    g_asrcStep[EXTRA_I2S_ASRC_PATH_OUT] = step[EXTRA_I2S_ASRC_PATH_OUT];
+    g_asrcPpm = (int)(((int64_t) step[EXTRA_I2S_ASRC_PATH_IN] - (int64_t)(1ULL << 32)) / 4295);
+
+    if(g_asrcSnapNum >= ASRC_LOCK_SNAPSHOTS)
+    {
+        g_asrcLocked = 1;
+    }
+}
+
+unsigned ExtraI2sAsrcSchedule(unsigned path)
+{
+    asrc_path_t *p = &g_asrcPaths[path];
+
+    if(p->num_chans == 0)
+    {
+        return 0;
+    }
+
+    const unsigned fill = RingFill(p->src);
+
+    if(!g_asrcLocked)
+    {
+        /* Hold the source ring at the target fill, ready to start */
+        if(fill > ASRC_TARGET_FILL)
+        {
+            RingPopN(p->src, fill - ASRC_TARGET_FILL);
+        }
+        p->running = 0;
+        return 0;
+    }
+
+    if(RingSpace(p->sink) < EXTRA_I2S_ASRC_BLOCK)
+    {
+        return 0;
+    }
+
+    if(!p->running)
+    {
+        p->pos = 0;
+        p->fill_err = 0;
+    }
+
+    const uint64_t step = (uint64_t)((int64_t) g_asrcStep[path] + ((int64_t) p->fill_err * ASRC_FILL_GAIN));
+    uint64_t pos = p->pos;
+    unsigned numIn = 0;
+
+    for(unsigned k = 0; k < EXTRA_I2S_ASRC_BLOCK; k++)
+    {
+        const unsigned n = (unsigned)(pos >> 32);
+        p->push[k] = n;
+        numIn += n;
+        pos = (uint32_t) pos;
+        p->frac[k] = (uint32_t) pos;
+        pos += step;
+    }
+
+    if(fill < numIn)
+    {
+        /* Wait for the input */
+        return 0;
+    }
+
+    p->fill_err += ((((int) fill - ASRC_TARGET_FILL) << 8) - p->fill_err) >> 4;
+    p->reset = !p->running;
+    p->running = 1;
+    p->pos = pos;
+    p->num_in = numIn;
+    p->in_tail = p->src->tail;
+    p->out_head = p->sink->head;
+    return 1;
+}
+
+void ExtraI2sAsrcCoefs(unsigned path, unsigned thread)
+{
+    asrc_path_t *p = &g_asrcPaths[path];
+
+    for(unsigned k = thread; k < EXTRA_I2S_ASRC_BLOCK; k += EXTRA_I2S_ASRC_THREADS)
+    {
+        asrc_coefs(p->coefs[k], p->frac[k]);
+    }
+}
+
+void ExtraI2sAsrcProcess(unsigned path, unsigned thread)
+{
+    asrc_path_t *p = &g_asrcPaths[path];
+    asrc_t *asrc = &p->asrc[thread];
+    const unsigned first = EXTRA_I2S_ASRC_CHAN_SPLIT(p->num_chans, thread);
+    const unsigned numChans = EXTRA_I2S_ASRC_CHAN_SPLIT(p->num_chans, thread + 1) - first;
+    unsigned in = p->in_tail;
+
+    if(numChans == 0)
+    {
+        return;
+    }
+
+    if(p->reset)
+    {
+        asrc_init(asrc, numChans);
+    }
+
+    for(unsigned k = 0; k < EXTRA_I2S_ASRC_BLOCK; k++)
+    {
+        for(unsigned n = 0; n < p->push[k]; n++, in++)
+        {
+            asrc_push(asrc, (const int32_t *) &p->src_data[(RING_IDX(in) * p->num_chans) + first]);
+        }
+
+        asrc_output(asrc, p->coefs[k], (int32_t *) &p->sink_data[(RING_IDX(p->out_head + k) * p->num_chans) + first]);
+    }
+}
+
+void ExtraI2sAsrcCommit(unsigned path)
+{
+    asrc_path_t *p = &g_asrcPaths[path];
+
+    RingPopN(p->src, p->num_in);
+    RingPushN(p->sink, EXTRA_I2S_ASRC_BLOCK);
+}
+
+unsigned ExtraI2sAsrcLocked()
+{
+    return g_asrcLocked;
+}
+
+int ExtraI2sAsrcPpm()
+{
+    return g_asrcPpm;
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _EXTRA_I2S_ASRC_H_
+#define _EXTRA_I2S_ASRC_H_
+
+#include "extra_i2s.h"
+
+/* Conversion paths */
+#define EXTRA_I2S_ASRC_PATH_IN      (0)     /* Extra interface inputs to USB */
+#define EXTRA_I2S_ASRC_PATH_OUT     (1)     /* USB to extra interface outputs */
+#define EXTRA_I2S_ASRC_NUM_PATHS    (2)
+
+/* Channels converted by a thread: [START, END) */
+#define EXTRA_I2S_ASRC_CHAN_SPLIT(numChans, thread) (((numChans) * (thread)) / EXTRA_I2S_ASRC_THREADS)
+
+/* Time between checks for work when there is none, reference timer ticks */
+#define EXTRA_I2S_ASRC_POLL_TICKS   (500)
+
+/* Thread 0 (extra_i2s_asrc_main()) only */
+void ExtraI2sAsrcInit();
+void ExtraI2sAsrcUpdate();
+unsigned ExtraI2sAsrcSchedule(unsigned path);
+void ExtraI2sAsrcCommit(unsigned path);
+
+/* All threads, once a block has been scheduled: first ExtraI2sAsrcCoefs() on every thread
+ * (each calculates the coefficients of some of the frames), then ExtraI2sAsrcProcess() */
+void ExtraI2sAsrcCoefs(unsigned path, unsigned thread);
+void ExtraI2sAsrcProcess(unsigned path, unsigned thread);
+
+/* Commands from thread 0 to the other threads */
+#define EXTRA_I2S_ASRC_CMD_COEFS    (0)
+#define EXTRA_I2S_ASRC_CMD_PROCESS  (1)
+
+#endif
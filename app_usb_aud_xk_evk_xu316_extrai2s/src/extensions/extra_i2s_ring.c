@@ -0,0 +1,118 @@
+#include "extra_i2s_ring.h"
+
+/* With EXTRA_I2S_ASRC_ENABLE the audio thread reads the converted input ring and i2s_data()
+ * the converted output ring, extra_i2s_asrc.c moves samples between each pair */
+#if (EXTRA_I2S_CHAN_COUNT_IN > 0)
+ring_t g_ringIn = {0, 0, 0, 0, 1};
+unsigned g_ringInData[EXTRA_I2S_RING_FRAMES][EXTRA_I2S_CHAN_COUNT_IN];
+#if (EXTRA_I2S_ASRC_ENABLE)
+ring_t g_ringInAsrc = {0, 0, 0, 0, 1};
+unsigned g_ringInAsrcData[EXTRA_I2S_RING_FRAMES][EXTRA_I2S_CHAN_COUNT_IN];
+#define RING_IN_USB         g_ringInAsrc
+#define RING_IN_USB_DATA    g_ringInAsrcData
+#else
+#define RING_IN_USB         g_ringIn
+#define RING_IN_USB_DATA    g_ringInData
+#endif
+#endif
+
+#if (EXTRA_I2S_CHAN_COUNT_OUT > 0)
+ring_t g_ringOut = {0, 0, 0, 0, 1};
+unsigned g_ringOutData[EXTRA_I2S_RING_FRAMES][EXTRA_I2S_CHAN_COUNT_OUT];
+#if (EXTRA_I2S_ASRC_ENABLE)
+ring_t g_ringOutAsrc = {0, 0, 0, 0, 1};
+unsigned g_ringOutAsrcData[EXTRA_I2S_RING_FRAMES][EXTRA_I2S_CHAN_COUNT_OUT];
+#define RING_OUT_I2S        g_ringOutAsrc
+#define RING_OUT_I2S_DATA   g_ringOutAsrcData
+#else
+#define RING_OUT_I2S        g_ringOut
+#define RING_OUT_I2S_DATA   g_ringOutData
+#endif
+#endif
+
+void ExtraI2sRingAudio(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[])
+{
+#if (EXTRA_I2S_CHAN_COUNT_OUT > 0)
+    if(RingPushStart(&g_ringOut))
+    {
+        unsigned *frame = g_ringOutData[RING_IDX(g_ringOut.head)];
+        for(unsigned i = 0; i < EXTRA_I2S_CHAN_COUNT_OUT; i++)
+        {
+            frame[i] = sampsFromUsbToAudio[i + EXTRA_I2S_CHAN_INDEX_OUT];
+        }
+        RingPushEnd(&g_ringOut);
+    }
+#endif
+
+#if (EXTRA_I2S_CHAN_COUNT_IN > 0)
+    if(RingPopStart(&RING_IN_USB))
+    {
+        const unsigned *frame = RING_IN_USB_DATA[RING_IDX(RING_IN_USB.tail)];
+        for(unsigned i = 0; i < EXTRA_I2S_CHAN_COUNT_IN; i++)
+        {
+            sampsFromAudioToUsb[i + EXTRA_I2S_CHAN_INDEX_IN] = frame[i];
+        }
+        RingPopEnd(&RING_IN_USB);
+    }
+    else
+    {
+        for(unsigned i = 0; i < EXTRA_I2S_CHAN_COUNT_IN; i++)
+        {
+            sampsFromAudioToUsb[i + EXTRA_I2S_CHAN_INDEX_IN] = 0;
+        }
+    }
+#endif
+}
+
+void ExtraI2sRingReceive(int32_t samples[])
+{
+#if (EXTRA_I2S_CHAN_COUNT_IN > 0)
+    if(RingPushStart(&g_ringIn))
+    {
+        unsigned *frame = g_ringInData[RING_IDX(g_ringIn.head)];
+        for(unsigned i = 0; i < EXTRA_I2S_CHAN_COUNT_IN; i++)
+        {
+            frame[i] = samples[i];
+        }
+        RingPushEnd(&g_ringIn);
+    }
+#endif
+}
+
+void ExtraI2sRingSend(int32_t samples[])
+{
+#if (EXTRA_I2S_CHAN_COUNT_OUT > 0)
+    if(RingPopStart(&RING_OUT_I2S))
+    {
+        const unsigned *frame = RING_OUT_I2S_DATA[RING_IDX(RING_OUT_I2S.tail)];
+        for(unsigned i = 0; i < EXTRA_I2S_CHAN_COUNT_OUT; i++)
+        {
+            samples[i] = frame[i];
+        }
+        RingPopEnd(&RING_OUT_I2S);
+    }
+    else
+    {
+        for(unsigned i = 0; i < EXTRA_I2S_CHAN_COUNT_OUT; i++)
+        {
+            samples[i] = 0;
+        }
+    }
+#endif
+}
+
+unsigned ExtraI2sRingCount(unsigned counter)
+{
+    switch(counter)
+    {
+#if (EXTRA_I2S_CHAN_COUNT_IN > 0)
+        case EXTRA_I2S_IN_OVERRUNS:     return g_ringIn.overruns;
+        case EXTRA_I2S_IN_UNDERRUNS:    return RING_IN_USB.underruns;
+#endif
+#if (EXTRA_I2S_CHAN_COUNT_OUT > 0)
+        case EXTRA_I2S_OUT_OVERRUNS:    return g_ringOut.overruns;
+        case EXTRA_I2S_OUT_UNDERRUNS:   return RING_OUT_I2S.underruns;
+#endif
+        default:                        return 0;
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef _EXTRA_I2S_RING_H_
+#define _EXTRA_I2S_RING_H_
+
+#include "extra_i2s.h"
+
+/* Ring internals, shared by extra_i2s_ring.c and extra_i2s_asrc.c */
+
+typedef struct
+{
+    volatile unsigned head;     /* Frames written, producer only */
+    volatile unsigned tail;     /* Frames read, consumer only */
+    unsigned overruns;          /* Producer only */
+    unsigned underruns;         /* Consumer only */
+    unsigned syncing;           /* Consumer only, waiting for the ring to fill to half way */
+} ring_t;
+
+/* Stops the compiler moving sample accesses past an index update */
+#define RING_BARRIER()  asm volatile("" ::: "memory")
+
+#define RING_IDX(r)     ((r) & (EXTRA_I2S_RING_FRAMES - 1))
+
+static inline unsigned RingFill(const ring_t *r)
+{
+    return r->head - r->tail;
+}
+
+static inline unsigned RingSpace(const ring_t *r)
+{
+    return EXTRA_I2S_RING_FRAMES - (r->head - r->tail);
+}
+
+/* Single frame producer, returns 0 (and counts an overrun) if the ring is full */
+static inline unsigned RingPushStart(ring_t *r)
+{
+    if((r->head - r->tail) == EXTRA_I2S_RING_FRAMES)
+    {
+        r->overruns++;
+        return 0;
+    }
+    return 1;
+}
+
+static inline void RingPushEnd(ring_t *r)
+{
+    RING_BARRIER();
+    r->head = r->head + 1;
+}
+
+/* Single frame consumer, returns 0 (and counts an underrun) if the ring is empty. After an
+ * underrun returns 0 until the ring has refilled to half way */
+static inline unsigned RingPopStart(ring_t *r)
+{
+    unsigned fill = r->head - r->tail;
+
+    if(r->syncing)
+    {
+        if(fill < (EXTRA_I2S_RING_FRAMES / 2))
+            return 0;
+        r->syncing = 0;
+    }
+    else if(fill == 0)
+    {
+        r->underruns++;
+        r->syncing = 1;
+        return 0;
+    }
+    RING_BARRIER();
+    return 1;
+}
+
+static inline void RingPopEnd(ring_t *r)
+{
+    RING_BARRIER();
+    r->tail = r->tail + 1;
+}
+
+/* Multi-frame producer/consumer, the caller checks RingSpace()/RingFill() first */
+static inline void RingPushN(ring_t *r, unsigned n)
+{
+    RING_BARRIER();
+    r->head = r->head + n;
+}
+
+static inline void RingPopN(ring_t *r, unsigned n)
+{
+    RING_BARRIER();
+    r->tail = r->tail + n;
+}
+
+#if (EXTRA_I2S_CHAN_COUNT_IN > 0)
+/* Written by i2s_data() */
+extern ring_t g_ringIn;
+extern unsigned g_ringInData[EXTRA_I2S_RING_FRAMES][EXTRA_I2S_CHAN_COUNT_IN];
+#if (EXTRA_I2S_ASRC_ENABLE)
+/* Converted to the USB clock, read by UserBufferManagement() */
+extern ring_t g_ringInAsrc;
+extern unsigned g_ringInAsrcData[EXTRA_I2S_RING_FRAMES][EXTRA_I2S_CHAN_COUNT_IN];
+#endif
+#endif
+
+#if (EXTRA_I2S_CHAN_COUNT_OUT > 0)
+/* Written by UserBufferManagement() */
+extern ring_t g_ringOut;
+extern unsigned g_ringOutData[EXTRA_I2S_RING_FRAMES][EXTRA_I2S_CHAN_COUNT_OUT];
+#if (EXTRA_I2S_ASRC_ENABLE)
+/* Converted to the extra interface clock, read by i2s_data() */
+extern ring_t g_ringOutAsrc;
+extern unsigned g_ringOutAsrcData[EXTRA_I2S_RING_FRAMES][EXTRA_I2S_CHAN_COUNT_OUT];
+#endif
+#endif
+
+#endif
@@ -1,50 +1,34 @@
 #include <platform.h>
 #include <stdint.h>
 
-//Found solution: IN 24.000MHz, OUT 49.151786MHz, VCO 3145.71MHz, RD 1, FD 131.071 (m = 1, n = 14), OD 8, FOD 2, ERR -4.36ppm
-// Measure: 100Hz-40kHz: ~7ps
-// 100Hz-1MHz: 70ps.
-// 100Hz high pass: 118ps.
-#define APP_PLL_CTL_49M  0x0B808200
-#define APP_PLL_DIV_49M  0x80000001
-#define APP_PLL_FRAC_49M 0x8000000D
-
-//Found solution: IN 24.000MHz, OUT 45.157895MHz, VCO 2709.47MHz, RD 1, FD 112.895 (m = 17, n = 19), OD 5, FOD 3, ERR -11.19ppm
-// Measure: 100Hz-40kHz: 6.5ps
-// 100Hz-1MHz: 67ps.
-// 100Hz high pass: 215ps.
-#define APP_PLL_CTL_45M  0x0A006F00
-#define APP_PLL_DIV_45M  0x80000002
-#define APP_PLL_FRAC_45M 0x80001012
-
-// Found solution: IN 24.000MHz, OUT 24.576000MHz, VCO 2457.60MHz, RD 1, FD 102.400 (m = 2, n = 5), OD 5, FOD 5, ERR 0.0ppm
-// Measure: 100Hz-40kHz: ~8ps
-// 100Hz-1MHz: 63ps.
-// 100Hz high pass: 127ps.
-#define APP_PLL_CTL_24M  0x0A006500
-#define APP_PLL_DIV_24M  0x80000004
-#define APP_PLL_FRAC_24M 0x80000104
-
-// Found solution: IN 24.000MHz, OUT 22.579186MHz, VCO 3522.35MHz, RD 1, FD 146.765 (m = 13, n = 17), OD 3, FOD 13, ERR -0.641ppm
-// Measure: 100Hz-40kHz: 7ps
-// 100Hz-1MHz: 67ps.
-// 100Hz high pass: 260ps.
-#define APP_PLL_CTL_22M  0x09009100
-#define APP_PLL_DIV_22M  0x8000000C
-#define APP_PLL_FRAC_22M 0x80000C10
-
-#define APP_PLL_CTL_12M  0x0A006500
-#define APP_PLL_DIV_12M  0x80000009
-#define APP_PLL_FRAC_12M 0x80000104
+/*
+ * AppPLL (xCORE.ai secondary PLL) MCLK generation from the 24MHz reference.
+ *
+ * Register settings come from apppll_table.h, which is generated by apppll_gen.py for a list of
+ * MCLK frequencies with the frequency error of each. To support another MCLK (e.g. for a new
+ * sample rate or MCLK/fs ratio) add it to the list and regenerate the table, rather than
+ * deriving register values by hand.
+ *
+ * AppPllEnable() uses the most accurate setting for an MCLK. AppPllEnableTrim() uses one that
+ * MCLK recovery can then trim with AppPllSetFrac() without re-locking the PLL.
+ */
+
+typedef struct
+{
+    unsigned mclk;          /* Hz */
+    unsigned ctl;           /* XS1_SSWITCH_SS_APP_PLL_CTL_NUM */
+    unsigned div;           /* XS1_SSWITCH_SS_APP_CLK_DIVIDER_NUM */
+    unsigned frac;          /* XS1_SSWITCH_SS_APP_PLL_FRAC_N_DIVIDER_NUM */
+    int err_ppb;            /* Output frequency error */
+} app_pll_setting_t;
 
-#define APP_PLL_CTL_11M  0x09009100
-#define APP_PLL_DIV_11M  0x80000009
-#define APP_PLL_FRAC_11M 0x80000C10
+#include "apppll_table.h"
 
 #define APP_PLL_CTL_ENABLE (1 << 27)
 #define APP_PLL_CLK_OUTPUT_ENABLE (1 << 16)
 
-int AppPllEnable(int32_t clkFreq_hz)
+/* Programs the AppPLL and turns on its clock output */
+void AppPllSet(unsigned ctrl, unsigned div, unsigned frac)
 {
     // Ensure the AppPLL is enabled
     unsigned data;
@@ -55,53 +39,6 @@ int AppPllEnable(int32_t clkFreq_hz)
     read_node_config_reg(tile[0], XS1_SSWITCH_SS_APP_CLK_DIVIDER_NUM, data);
     write_node_config_reg(tile[0], XS1_SSWITCH_SS_APP_CLK_DIVIDER_NUM, data | APP_PLL_CLK_OUTPUT_ENABLE);
 
-    unsigned ctrl;
-    unsigned div;
-    unsigned frac;
-
-    switch(clkFreq_hz)
-    {
-        case 44100*256:
-            ctrl = APP_PLL_CTL_11M;
-            div = APP_PLL_DIV_11M;
-            frac = APP_PLL_FRAC_11M;
-            break;
-
-         case 48000*256:
-            ctrl = APP_PLL_CTL_12M;
-            div = APP_PLL_DIV_12M;
-            frac = APP_PLL_FRAC_12M;
-            break;
-
-        case 44100*512:
-            ctrl = APP_PLL_CTL_22M;
-            div = APP_PLL_DIV_22M;
-            frac = APP_PLL_FRAC_22M;
-            break;
-
-        case 48000*512:
-            ctrl = APP_PLL_CTL_24M;
-            div = APP_PLL_DIV_24M;
-            frac = APP_PLL_FRAC_24M;
-            break;
-
-        case 44100*1024:
-            ctrl = APP_PLL_CTL_45M;
-            div = APP_PLL_DIV_45M;
-            frac = APP_PLL_FRAC_45M;
-            break;
-
-        case 48000*1024:
-            ctrl = APP_PLL_CTL_49M;
-            div = APP_PLL_DIV_49M;
-            frac = APP_PLL_FRAC_49M;
-            break;
-
-        default:
-            assert(0);
-            break;
-    }
-
     // Disable the PLL
     write_node_config_reg(tile[0], XS1_SSWITCH_SS_APP_PLL_CTL_NUM, (ctrl & 0xF7FFFFFF));
     // Enable the PLL to invoke a reset on the appPLL.
@@ -118,6 +55,42 @@ int AppPllEnable(int32_t clkFreq_hz)
     delay_microseconds(100);
     // Turn on the clock output
     write_node_config_reg(tile[0], XS1_SSWITCH_SS_APP_CLK_DIVIDER_NUM, div);
+}
+
+/* Index of clkFreq_hz in the setting tables */
+static unsigned AppPllSettingIndex(int32_t clkFreq_hz)
+{
+    unsigned i = 0;
+    while((i < APP_PLL_NUM_SETTINGS) && (g_appPllSettings[i].mclk != clkFreq_hz))
+    {
+        i++;
+    }
+    assert(i < APP_PLL_NUM_SETTINGS);
+    return i;
+}
+
+int AppPllEnable(int32_t clkFreq_hz)
+{
+    const unsigned i = AppPllSettingIndex(clkFreq_hz);
+
+    AppPllSet(g_appPllSettings[i].ctl, g_appPllSettings[i].div, g_appPllSettings[i].frac);
 
 	return 0;
 }
+
+/* As AppPllEnable() but with the setting from g_appPllTrimSettings[], whose index is returned */
+unsigned AppPllEnableTrim(int32_t clkFreq_hz)
+{
+    const unsigned i = AppPllSettingIndex(clkFreq_hz);
+
+    AppPllSet(g_appPllTrimSettings[i].ctl, g_appPllTrimSettings[i].div, g_appPllTrimSettings[i].frac);
+
+    return i;
+}
+
+/* Changes the fractional divider of a running AppPLL, the output follows within a few
+ * microseconds without re-locking */
+void AppPllSetFrac(unsigned frac)
+{
+    write_node_config_reg(tile[0], XS1_SSWITCH_SS_APP_PLL_FRAC_N_DIVIDER_NUM, frac);
+}
@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+"""
+Generates apppll_table.h, the xCORE.ai AppPLL register settings used by AppPllEnable() in
+apppll.h, for a list of MCLK frequencies from the 24MHz reference.
+
+The AppPLL output (MCLK) is set by the CTL, FRAC and DIV registers:
+
+    FD   = (F + 1) + m / n          (fractional part only when FRAC is enabled)
+    VCO  = IN / (R + 1) * FD
+    OUT  = VCO / (2 * (OD + 1)) / (2 * (DIV + 1))
+
+The /2 after the output divider is in the PLL feedback path (FB divider is FD/2), the /2 after
+DIV gives a 50/50 duty cycle. With RD = R + 1, OD and FOD = DIV + 1 this is the notation of the
+solutions in earlier versions of apppll.h (e.g. "RD 1, FD 102.400 (m = 2, n = 5), OD 5, FOD 5").
+
+Each MCLK gets the setting with the smallest frequency error, then the highest phase detector
+frequency IN / RD (the loop filter is designed for RD 1, and noise in the reference is multiplied
+by FD), then integer mode over fractional mode, then the smallest n (fractional spurs are at
+IN / RD / n), then the highest VCO, then the largest output divider OD (rather than DIV).
+
+A second table holds settings for MCLK recovery (SwPllTask() in app_usb_aud_xk_316_mc), which
+trims the output by rewriting only FRAC. These use fractional mode with m/n in the middle of its
+range, so that +/- TRIM_PPM is reachable with any n up to 256 without changing F, and the
+largest FD (finest steps) that allows.
+
+Usage:
+    python3 apppll_gen.py                       # default MCLKs, writes apppll_table.h
+    python3 apppll_gen.py --mclk 24576000 ...   # other MCLKs, in Hz
+"""
+import argparse
+from fractions import Fraction
+from pathlib import Path
+
+REF_HZ = 24000000
+
+# Limits of the register fields and the PLL
+R_MAX = 63                  # 6 bits
+F_MAX = 8191                # 13 bits
+OD_MAX = 8                  # 3 bits, OD + 1
+FOD_MAX = 512               # 9 bits, DIV + 1
+PFD_MIN_HZ = 4000000        # IN / RD
+VCO_MIN_HZ = 1440000000
+VCO_MAX_HZ = 3600000000
+
+# Largest n used for the fractional divider, larger n gives finer steps but lower frequency
+# spurs. The hand-picked solutions this replaces all used n <= 19
+FRAC_N_MAX = 20
+
+# 128 to 2048 fs of both families. The 1024fs MCLK of the 48kHz family (49.152MHz) is 128fs at
+# 384kHz and 64fs at 768kHz, the 2048fs MCLK (98.304MHz) 256fs at 384kHz and 128fs at 768kHz
+DEFAULT_MCLKS = [fs * mult for mult in (128, 256, 512, 1024, 2048) for fs in (44100, 48000)]
+
+# Trim range of the recovery settings. USB SOF is accurate to 500ppm
+TRIM_PPM = 500
+TRIM_N_MAX = 256            # 8 bits, FRAC TOTAL_CYCLES + 1
+TRIM_ERR_PPM_MAX = 1
+
+CTL_ENABLE = 1 << 27
+DIV_INPUT_SEL_APP_PLL = 1 << 31
+FRAC_ENABLE = 1 << 31
+
+
+def ctl_word(r, f, od):
+    return CTL_ENABLE | ((od - 1) << 23) | (f << 8) | r
+
+
+def div_word(fod):
+    return DIV_INPUT_SEL_APP_PLL | (fod - 1)
+
+
+def frac_word(m, n):
+    return (FRAC_ENABLE | ((m - 1) << 8) | (n - 1)) if m else 0
+
+
+def decode(ctl, div, frac, ref_hz=REF_HZ):
+    """Output frequency (Fraction, Hz) of a register setting"""
+    r = ctl & 0x3F
+    f = (ctl >> 8) & 0x1FFF
+    od = ((ctl >> 23) & 0x7) + 1
+    fod = (div & 0x1FF) + 1
+    fd = Fraction(f + 1)
+    if frac & FRAC_ENABLE:
+        fd += Fraction(((frac >> 8) & 0xFF) + 1, (frac & 0xFF) + 1)
+    return Fraction(ref_hz, r + 1) * fd / (2 * od) / (2 * fod)
+
+
+def ppm(out_hz, mclk):
+    return float((Fraction(out_hz) / mclk - 1) * 1000000)
+
+
+def solve(mclk, ref_hz=REF_HZ, frac_n_max=FRAC_N_MAX):
+    """Best setting for mclk (Hz) as a dict, or None if there is none within the limits"""
+    best = None
+    best_key = None
+
+    for od in range(1, OD_MAX + 1):
+        for fod in range(1, FOD_MAX + 1):
+            vco = Fraction(mclk * 4 * od * fod)
+            if vco < VCO_MIN_HZ or vco > VCO_MAX_HZ:
+                continue
+
+            for r in range(0, R_MAX + 1):
+                pfd = Fraction(ref_hz, r + 1)
+                if pfd < PFD_MIN_HZ:
+                    break
+
+                fd = vco / pfd
+                fi = int(fd)
+
+                # Integer mode either side, then each n
+                cands = [(fi, 0, 1), (fi + 1, 0, 1)]
+                for n in range(2, frac_n_max + 1):
+                    m = round((fd - fi) * n)
+                    if 0 < m < n:
+                        cands.append((fi, m, n))
+
+                for fint, m, n in cands:
+                    if fint < 2 or fint - 1 > F_MAX:
+                        continue
+                    fd_c = fint + Fraction(m, n)
+                    vco_c = pfd * fd_c
+                    if vco_c < VCO_MIN_HZ or vco_c > VCO_MAX_HZ:
+                        continue
+                    out = vco_c / (4 * od * fod)
+                    err = ppm(out, mclk)
+                    key = (round(abs(err), 3), r, 1 if m else 0, n, -vco_c, -od)
+                    if best_key is None or key < best_key:
+                        best_key = key
+                        best = {
+                            "mclk": mclk, "rd": r + 1, "fd": fd_c, "m": m, "n": n, "od": od,
+                            "fod": fod, "vco": vco_c, "out": out, "ppm": err,
+                            "ctl": ctl_word(r, fint - 1, od), "div": div_word(fod),
+                            "frac": frac_word(m, n),
+                        }
+    return best
+
+
+def solve_trim(mclk, ref_hz=REF_HZ, trim_ppm=TRIM_PPM):
+    """Setting for mclk (Hz) that can be trimmed by +/- trim_ppm through FRAC alone, as a dict,
+    or None if there is none"""
+    best = None
+    best_key = None
+    margin = Fraction(1, TRIM_N_MAX)
+
+    for od in range(1, OD_MAX + 1):
+        for fod in range(1, FOD_MAX + 1):
+            vco = Fraction(mclk * 4 * od * fod)
+            for r in range(0, R_MAX + 1):
+                pfd = Fraction(ref_hz, r + 1)
+                if pfd < PFD_MIN_HZ:
+                    break
+
+                fd = vco / pfd
+                fi = int(fd)
+                lo = fd * (1 - Fraction(trim_ppm, 1000000))
+                hi = fd * (1 + Fraction(trim_ppm, 1000000))
+                if lo < fi + margin or hi > fi + 1 - margin or fi - 1 > F_MAX:
+                    continue
+                if pfd * lo < VCO_MIN_HZ or pfd * hi > VCO_MAX_HZ:
+                    continue
+
+                frac = Fraction(fd - fi).limit_denominator(TRIM_N_MAX)
+                m, n = frac.numerator, frac.denominator
+                if m == 0:
+                    continue
+                fd_c = fi + frac
+                out = pfd * fd_c / (4 * od * fod)
+                err = ppm(out, mclk)
+                if abs(err) > TRIM_ERR_PPM_MAX:
+                    continue
+
+                key = (-fd_c, round(abs(err), 3), -od, r)
+                if best_key is None or key < best_key:
+                    best_key = key
+                    best = {
+                        "mclk": mclk, "rd": r + 1, "fd": fd_c, "m": m, "n": n, "od": od,
+                        "fod": fod, "vco": pfd * fd_c, "out": out, "ppm": err,
+                        "ctl": ctl_word(r, fi - 1, od), "div": div_word(fod),
+                        "frac": frac_word(m, n),
+                    }
+    return best
+
+
+def describe(s, ref_hz=REF_HZ):
+    frac = f" (m = {s['m']}, n = {s['n']})" if s["m"] else ""
+    return (f"IN {ref_hz / 1e6:.3f}MHz, OUT {float(s['out']) / 1e6:.6f}MHz, "
+            f"VCO {float(s['vco']) / 1e6:.2f}MHz, RD {s['rd']}, FD {float(s['fd']):.3f}{frac}, "
+            f"OD {s['od']}, FOD {s['fod']}, ERR {s['ppm']:.3f}ppm")
+
+
+def entry(s, ref_hz=REF_HZ):
+    ppb = round(s["ppm"] * 1000)
+    return [f"    // {describe(s, ref_hz)}",
+            f"    {{{s['mclk']}, 0x{s['ctl']:08X}, 0x{s['div']:08X}, 0x{s['frac']:08X}, {ppb}}},"]
+
+
+def table(mclks, ref_hz=REF_HZ, frac_n_max=FRAC_N_MAX):
+    """Text of apppll_table.h"""
+    settings = []
+    for mclk in mclks:
+        s = solve(mclk, ref_hz, frac_n_max)
+        if s is None:
+            raise ValueError(f"No AppPLL setting for MCLK {mclk}Hz")
+        settings.append(s)
+
+    trims = []
+    for mclk in mclks:
+        s = solve_trim(mclk, ref_hz)
+        if s is None:
+            raise ValueError(f"No AppPLL trim setting for MCLK {mclk}Hz")
+        trims.append(s)
+
+    args = " ".join(str(m) for m in mclks)
+    lines = [
+        "/* Generated by apppll_gen.py, do not edit. Regenerate with:",
+        f" *   python3 apppll_gen.py --mclk {args}",
+        " */",
+        "#ifndef _APPPLL_TABLE_H_",
+        "#define _APPPLL_TABLE_H_",
+        "",
+        f"#define APP_PLL_NUM_SETTINGS ({len(settings)})",
+        "",
+        "const app_pll_setting_t g_appPllSettings[APP_PLL_NUM_SETTINGS] =",
+        "{",
+    ]
+    for s in settings:
+        lines += entry(s, ref_hz)
+    lines += [
+        "};",
+        "",
+        f"/* For trimming by up to +/- {TRIM_PPM}ppm through FRAC only */",
+        "const app_pll_setting_t g_appPllTrimSettings[APP_PLL_NUM_SETTINGS] =",
+        "{",
+    ]
+    for s in trims:
+        lines += entry(s, ref_hz)
+    lines += ["};", "", "#endif", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--mclk", type=int, nargs="+", default=DEFAULT_MCLKS, help="MCLK frequencies in Hz")
+    parser.add_argument("--frac-n-max", type=int, default=FRAC_N_MAX, help="Largest fractional divider n")
+    parser.add_argument("-o", "--output", type=Path, default=Path(__file__).parent / "apppll_table.h")
+    args = parser.parse_args()
+
+    text = table(args.mclk, REF_HZ, args.frac_n_max)
+    args.output.write_text(text)
+    print(text)
+
+
+if __name__ == "__main__":
+    main()
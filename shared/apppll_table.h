@@ -0,0 +1,58 @@
+/* Generated by apppll_gen.py, do not edit. Regenerate with:
+ *   python3 apppll_gen.py --mclk 5644800 6144000 11289600 12288000 22579200 24576000 45158400 49152000 90316800 98304000
+ */
+#ifndef _APPPLL_TABLE_H_
+#define _APPPLL_TABLE_H_
+
+#define APP_PLL_NUM_SETTINGS (10)
+
+const app_pll_setting_t g_appPllSettings[APP_PLL_NUM_SETTINGS] =
+{
+    // IN 24.000MHz, OUT 5.644800MHz, VCO 2822.40MHz, RD 1, FD 117.600 (m = 3, n = 5), OD 5, FOD 25, ERR 0.000ppm
+    {5644800, 0x0A007400, 0x80000018, 0x80000204, 0},
+    // IN 24.000MHz, OUT 6.144000MHz, VCO 3072.00MHz, RD 1, FD 128.000, OD 5, FOD 25, ERR 0.000ppm
+    {6144000, 0x0A007F00, 0x80000018, 0x00000000, 0},
+    // IN 24.000MHz, OUT 11.289600MHz, VCO 3386.88MHz, RD 5, FD 705.600 (m = 3, n = 5), OD 5, FOD 15, ERR 0.000ppm
+    {11289600, 0x0A02C004, 0x8000000E, 0x80000204, 0},
+    // IN 24.000MHz, OUT 12.288000MHz, VCO 2457.60MHz, RD 1, FD 102.400 (m = 2, n = 5), OD 5, FOD 10, ERR 0.000ppm
+    {12288000, 0x0A006500, 0x80000009, 0x80000104, 0},
+    // IN 24.000MHz, OUT 22.579200MHz, VCO 2257.92MHz, RD 5, FD 470.400 (m = 2, n = 5), OD 5, FOD 5, ERR 0.000ppm
+    {22579200, 0x0A01D504, 0x80000004, 0x80000104, 0},
+    // IN 24.000MHz, OUT 24.576000MHz, VCO 2457.60MHz, RD 1, FD 102.400 (m = 2, n = 5), OD 5, FOD 5, ERR 0.000ppm
+    {24576000, 0x0A006500, 0x80000004, 0x80000104, 0},
+    // IN 24.000MHz, OUT 45.158371MHz, VCO 3070.77MHz, RD 3, FD 383.846 (m = 11, n = 13), OD 1, FOD 17, ERR -0.641ppm
+    {45158400, 0x08017E02, 0x80000010, 0x80000A0C, -641},
+    // IN 24.000MHz, OUT 49.152000MHz, VCO 2949.12MHz, RD 5, FD 614.400 (m = 2, n = 5), OD 5, FOD 3, ERR 0.000ppm
+    {49152000, 0x0A026504, 0x80000002, 0x80000104, 0},
+    // IN 24.000MHz, OUT 90.316667MHz, VCO 3251.40MHz, RD 2, FD 270.950 (m = 19, n = 20), OD 3, FOD 3, ERR -1.476ppm
+    {90316800, 0x09010D01, 0x80000002, 0x80001213, -1476},
+    // IN 24.000MHz, OUT 98.304000MHz, VCO 1966.08MHz, RD 5, FD 409.600 (m = 3, n = 5), OD 5, FOD 1, ERR 0.000ppm
+    {98304000, 0x0A019804, 0x80000000, 0x80000204, 0},
+};
+
+/* For trimming by up to +/- 500ppm through FRAC only */
+const app_pll_setting_t g_appPllTrimSettings[APP_PLL_NUM_SETTINGS] =
+{
+    // IN 24.000MHz, OUT 5.644800MHz, VCO 3590.09MHz, RD 6, FD 897.523 (m = 124, n = 237), OD 3, FOD 53, ERR 0.008ppm
+    {5644800, 0x09038005, 0x80000034, 0x80007BEC, 8},
+    // IN 24.000MHz, OUT 6.144000MHz, VCO 3489.79MHz, RD 6, FD 872.448 (m = 56, n = 125), OD 2, FOD 71, ERR 0.000ppm
+    {6144000, 0x08836705, 0x80000046, 0x8000377C, 0},
+    // IN 24.000MHz, OUT 11.289600MHz, VCO 3341.72MHz, RD 6, FD 835.430 (m = 34, n = 79), OD 2, FOD 37, ERR -0.024ppm
+    {11289600, 0x08834205, 0x80000024, 0x8000214E, -24},
+    // IN 24.000MHz, OUT 12.288000MHz, VCO 3489.79MHz, RD 6, FD 872.448 (m = 56, n = 125), OD 1, FOD 71, ERR 0.000ppm
+    {12288000, 0x08036705, 0x80000046, 0x8000377C, 0},
+    // IN 24.000MHz, OUT 22.579199MHz, VCO 3341.72MHz, RD 6, FD 835.430 (m = 34, n = 79), OD 1, FOD 37, ERR -0.024ppm
+    {22579200, 0x08034205, 0x80000024, 0x8000214E, -24},
+    // IN 24.000MHz, OUT 24.576000MHz, VCO 3145.73MHz, RD 6, FD 786.432 (m = 54, n = 125), OD 8, FOD 4, ERR 0.000ppm
+    {24576000, 0x0B831105, 0x80000003, 0x8000357C, 0},
+    // IN 24.000MHz, OUT 45.158399MHz, VCO 2890.14MHz, RD 6, FD 722.534 (m = 101, n = 189), OD 8, FOD 2, ERR -0.012ppm
+    {45158400, 0x0B82D105, 0x80000001, 0x800064BC, -12},
+    // IN 24.000MHz, OUT 49.152000MHz, VCO 3145.73MHz, RD 6, FD 786.432 (m = 54, n = 125), OD 8, FOD 2, ERR 0.000ppm
+    {49152000, 0x0B831105, 0x80000001, 0x8000357C, 0},
+    // IN 24.000MHz, OUT 90.316799MHz, VCO 2890.14MHz, RD 6, FD 722.534 (m = 101, n = 189), OD 8, FOD 1, ERR -0.012ppm
+    {90316800, 0x0B82D105, 0x80000000, 0x800064BC, -12},
+    // IN 24.000MHz, OUT 98.304000MHz, VCO 3145.73MHz, RD 6, FD 786.432 (m = 54, n = 125), OD 8, FOD 1, ERR 0.000ppm
+    {98304000, 0x0B831105, 0x80000000, 0x8000357C, 0},
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef _BOOT_TIME_H_
+#define _BOOT_TIME_H_
+
+/*
+ * Boot phase timestamps.
+ *
+ * BootTimeMark(phase) records the reference timer (100MHz ticks from when the tile started) the
+ * first time a start-up phase completes, later marks of the same phase are ignored. Marks are
+ * kept in g_bootTime[] of the tile that made them. Tiles start within a few microseconds of each
+ * other when run with xrun, so marks from different tiles can be compared at the millisecond
+ * level that start-up phases are measured in.
+ *
+ * With BOOT_TIME_REPORT set each mark is also printed (over xSCOPE when run with xrun --xscope)
+ * as one line:
+ *
+ *   BOOT <phase> <ticks>
+ *
+ * which is what tests/test_boot.py reads. Include in one XC source file per application.
+ */
+
+#ifndef BOOT_TIME_REPORT
+#define BOOT_TIME_REPORT            (0)
+#endif
+
+#define BOOT_PHASE_BOARD_SETUP      (0)     /* Board power and control set up */
+#define BOOT_PHASE_HW_INIT_START    (1)     /* AudioHwInit() called */
+#define BOOT_PHASE_HW_INIT_DONE     (2)     /* AudioHwInit() returned, audio thread running */
+#define BOOT_PHASE_CODEC_READY      (3)     /* Codecs configured */
+#define BOOT_PHASE_FIRST_AUDIO      (4)     /* Audio thread running and codecs unmuted, audio
+                                             * passes */
+#define BOOT_NUM_PHASES             (5)
+
+#include <xs1.h>
+#if (BOOT_TIME_REPORT)
+#include <stdio.h>
+#endif
+
+unsigned g_bootTime[BOOT_NUM_PHASES];
+unsigned g_bootTimeMarked = 0;
+
+void BootTimeMark(unsigned phase)
+{
+    timer t;
+    unsigned now;
+
+    if(g_bootTimeMarked & (1 << phase))
+    {
+        return;
+    }
+
+    t :> now;
+    g_bootTime[phase] = now;
+    g_bootTimeMarked |= (1 << phase);
+
+#if (BOOT_TIME_REPORT)
+    switch(phase)
+    {
+        case BOOT_PHASE_BOARD_SETUP:
+            printf("BOOT board_setup %u\n", now);
+            break;
+        case BOOT_PHASE_HW_INIT_START:
+            printf("BOOT hw_init_start %u\n", now);
+            break;
+        case BOOT_PHASE_HW_INIT_DONE:
+            printf("BOOT hw_init_done %u\n", now);
+            break;
+        case BOOT_PHASE_CODEC_READY:
+            printf("BOOT codec_ready %u\n", now);
+            break;
+        case BOOT_PHASE_FIRST_AUDIO:
+            printf("BOOT first_audio %u\n", now);
+            break;
+    }
+#endif
+}
+
+#endif
@@ -1,3 +1,5 @@
+#include "event_trace.h"
+
 #ifndef CS2100_I2C_DEVICE_ADDR
 #define CS2100_I2C_DEVICE_ADDR      (0x9c>>1)
 #endif
@@ -12,6 +14,9 @@
 #define CS2100_FUNC_CONFIG_1        (0x16)
 #define CS2100_FUNC_CONFIG_2        (0x17)
 
+/* CS2100_DEVICE_CONTROL bit, set while the PLL is not locked */
+#define CS2100_UNLOCK               (0x80)
+
 /* TODO this is a key frequency and should be moved into lib_xua */
 #if (XUA_SYNCMODE == XUA_SYNCMODE_SYNC)
     #define PLL_SYNC_FREQ           (500)
@@ -91,3 +96,96 @@ void PllMult(unsigned output, unsigned ref, UNSAFE client interface i2c_master_i
     }
 }
 
+/* Lock polling, see PllWaitLock(). Times are in reference timer (100MHz) ticks */
+#ifndef CS2100_LOCK_TIMEOUT
+#define CS2100_LOCK_TIMEOUT         (40000000)  /* 400ms */
+#endif
+
+#ifndef CS2100_LOCK_POLL
+#define CS2100_LOCK_POLL            (20000)     /* 200us between reads */
+#endif
+
+/* Consecutive locked reads needed, so MCLK is not used during a momentary lock */
+#ifndef CS2100_LOCK_STABLE_READS
+#define CS2100_LOCK_STABLE_READS    (3)
+#endif
+
+#define CS2100_LOCK_FAILED          (0xFFFFFFFF)
+#define CS2100_LOCK_DEFERRED        (0xFFFFFFFE)
+
+/* Whether a PllWaitLock() result is a lock seen, rather than a timeout or a lock left to happen
+ * later. Callers only treat MCLK as set up for the next configuration on a lock seen */
+#define CS2100_LOCKED(ticks)        (((ticks) != CS2100_LOCK_FAILED) && ((ticks) != CS2100_LOCK_DEFERRED))
+
+/* Whether the reference runs while the PLL is configured. In sync mode it is made from the USB
+ * stream, which lib_xua only starts after AudioHwConfig() returns, so lock cannot happen there */
+#ifndef CS2100_REF_AT_CONFIG
+#define CS2100_REF_AT_CONFIG        (XUA_SYNCMODE != XUA_SYNCMODE_SYNC)
+#endif
+
+/* Result of the last PllWaitLock(): ticks from the call until lock (CS2100_LOCK_FAILED if it
+ * timed out, CS2100_LOCK_DEFERRED without a reference) and the number of timeouts since
+ * start-up */
+unsigned g_pllLockTicks = 0;
+unsigned g_pllLockFails = 0;
+
+/* Waits for the CS2100 to lock after PllMult(), polling its unlock indicator, for at most
+ * CS2100_LOCK_TIMEOUT ticks. The first read is two reference (ref Hz) periods after the call so
+ * the unlock indicator has had time to reflect the new ratio.
+ *
+ * Returns the ticks taken to lock, or CS2100_LOCK_FAILED if lock was not seen in time (for
+ * example the reference stopped), in which case the caller carries on with an unlocked MCLK
+ * rather than hanging.
+ *
+ * Without CS2100_REF_AT_CONFIG there is no reference yet, the PLL locks once the stream starts.
+ * Returns CS2100_LOCK_DEFERRED straight away, not counted as a timeout */
+unsigned PllWaitLock(unsigned ref, UNSAFE client interface i2c_master_if i2c)
+{
+    UNSAFE
+    {
+#if !(CS2100_REF_AT_CONFIG)
+    g_pllLockTicks = CS2100_LOCK_DEFERRED;
+    EventTrace(EVENT_TRACE_PLL_LOCK, EVENT_TRACE_ARG_MAX - 1);
+    return CS2100_LOCK_DEFERRED;
+#else
+    unsigned char data[1] = {0};
+    i2c_regop_res_t result;
+    timer t;
+    unsigned start, now;
+    unsigned stable = 0;
+
+    t :> start;
+    t when timerafter(start + (2 * (XS1_TIMER_HZ / ref))) :> now;
+
+    while(1)
+    {
+        CS2100_REGREAD(CS2100_DEVICE_CONTROL, data);
+        t :> now;
+
+        if((result == I2C_REGOP_SUCCESS) && !(data[0] & CS2100_UNLOCK))
+        {
+            if(++stable == CS2100_LOCK_STABLE_READS)
+            {
+                g_pllLockTicks = now - start;
+                EventTrace(EVENT_TRACE_PLL_LOCK, g_pllLockTicks / 100);
+                return g_pllLockTicks;
+            }
+        }
+        else
+        {
+            stable = 0;
+        }
+
+        if((now - start) >= CS2100_LOCK_TIMEOUT)
+        {
+            g_pllLockTicks = CS2100_LOCK_FAILED;
+            g_pllLockFails++;
+            EventTrace(EVENT_TRACE_PLL_LOCK, EVENT_TRACE_ARG_MAX);
+            return CS2100_LOCK_FAILED;
+        }
+
+        t when timerafter(now + CS2100_LOCK_POLL) :> void;
+    }
+#endif
+    }
+}
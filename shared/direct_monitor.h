@@ -0,0 +1,406 @@
+#ifndef _DIRECT_MONITOR_H_
+#define _DIRECT_MONITOR_H_
+
+/*
+ * Zero-latency direct monitor mix.
+ *
+ * Device inputs (in USB order, i.e. analogue inputs followed by any digital inputs) are mixed
+ * into the device outputs inside UserBufferManagement(), so a performer hears their inputs
+ * without the USB round trip through the host. DirectMonitor() adds the input frame received
+ * by the audio thread to the output frame it is about to send, no buffering is added. The
+ * mix is independent of the lib_xua mixer, so it is available in builds with MAX_MIX_COUNT=0.
+ * Note the monitor signal is added after any host output volume.
+ *
+ * Include this file once in the application, in a source file that provides:
+ *   - a call to DirectMonitor() from UserBufferManagement(), after any processing of the
+ *     output samples and before any processing of the input samples
+ *   - a call to DirectMonitorRequest() from VendorRequests() (lib_xua Endpoint 0), with the
+ *     channel end that is also stored in uc_directMonitor on AUDIO_IO_TILE
+ *
+ * Control uses the same request layout as the lib_xua mixer unit controls, addressed to a
+ * unit of its own (DIRECT_MONITOR_UNIT_ID), so the host mixer control application can drive it
+ * with its audio request options:
+ *
+ *   - DIRECT_MONITOR_CS_GAIN, channel number input * DIRECT_MONITOR_OUTS + output: CUR is the
+ *     crosspoint gain, 2 bytes in 1/256 dB with 0x8000 (-inf) meaning no route. RANGE is
+ *     supported. All crosspoints start at -inf (monitoring off). The channel number is 8 bits,
+ *     so there are at most 256 crosspoints
+ *   - DIRECT_MONITOR_CS_CYCLES, channel number 0: CUR is the cost of DirectMonitor() in
+ *     reference timer ticks (100MHz), four little-endian 32-bit words: calls, min, average
+ *     and max. Setting it (any data) clears the statistics
+ *
+ * Requests are passed to the audio thread, which takes at most one per call of DirectMonitor(),
+ * so Endpoint 0 waits up to a frame for each (longer while audio is stopped).
+ *
+ * The cost is proportional to the number of active crosspoints (routes), at most
+ * DIRECT_MONITOR_MAX_ROUTES; a request to add a route beyond that is stalled.
+ */
+
+#ifndef DIRECT_MONITOR_ENABLE
+#define DIRECT_MONITOR_ENABLE       (0)
+#endif
+
+/* Inputs and outputs available to the mix */
+#ifndef DIRECT_MONITOR_INS
+#define DIRECT_MONITOR_INS          (NUM_USB_CHAN_IN)
+#endif
+
+#ifndef DIRECT_MONITOR_OUTS
+#define DIRECT_MONITOR_OUTS         (NUM_USB_CHAN_OUT)
+#endif
+
+#ifndef DIRECT_MONITOR_MAX_ROUTES
+#define DIRECT_MONITOR_MAX_ROUTES   (16)
+#endif
+
+/* The crosspoint is the channel number, the low byte of wValue in the audio class request layout */
+#if (DIRECT_MONITOR_ENABLE) && ((DIRECT_MONITOR_INS * DIRECT_MONITOR_OUTS) > 256)
+#error DIRECT_MONITOR_INS * DIRECT_MONITOR_OUTS must be at most 256, set them to the channels to be monitored
+#endif
+
+/* Unit ID the controls are addressed to, chosen clear of the lib_xua unit and terminal IDs */
+#ifndef DIRECT_MONITOR_UNIT_ID
+#define DIRECT_MONITOR_UNIT_ID      (0xD0)
+#endif
+
+/* Crosspoint gain range, in 1/256 dB */
+#ifndef DIRECT_MONITOR_MIN_GAIN
+#define DIRECT_MONITOR_MIN_GAIN     (-127 * 256)
+#endif
+
+#ifndef DIRECT_MONITOR_MAX_GAIN
+#define DIRECT_MONITOR_MAX_GAIN     (6 * 256)
+#endif
+
+#define DIRECT_MONITOR_GAIN_OFF     (0x8000)
+
+/* Build DirectMonitorRequest(). Without it the commands below can be sent to the audio thread
+ * directly, as the xsim benchmark does */
+#ifndef DIRECT_MONITOR_ENDPOINT0
+#define DIRECT_MONITOR_ENDPOINT0    (1)
+#endif
+
+/* Controls */
+#define DIRECT_MONITOR_CS_GAIN      (1)
+#define DIRECT_MONITOR_CS_CYCLES    (2)
+
+/* Audio class request codes */
+#define DIRECT_MONITOR_REQ_CUR      (0x01)
+#define DIRECT_MONITOR_REQ_RANGE    (0x02)
+
+/* Linear gains applied by the audio thread, Q28 so +6dB fits */
+#define DIRECT_MONITOR_GAIN_Q       (28)
+
+/* Commands from Endpoint 0 to the audio thread, each is answered with one or more words */
+#define DIRECT_MONITOR_CMD_SET      (0)     /* out, in, gain -> 1 if set, 0 if no route free */
+#define DIRECT_MONITOR_CMD_STATS    (1)     /* -> calls, min, max, total low, total high */
+#define DIRECT_MONITOR_CMD_RESET    (2)     /* -> 0 */
+
+#if (DIRECT_MONITOR_ENABLE)
+
+#if (DIRECT_MONITOR_MAX_GAIN > (6 * 256))
+#error DIRECT_MONITOR_MAX_GAIN must be at most +6dB
+#endif
+
+#include <xs1.h>
+
+/* Audio thread end of the control channel, set on AUDIO_IO_TILE before audio starts */
+unsafe chanend uc_directMonitor;
+
+/* Routes, sorted by output so that each output is loaded and stored once per frame. Owned by
+ * the audio thread */
+static unsigned g_dmNumRoutes = 0;
+static unsigned g_dmRouteOut[DIRECT_MONITOR_MAX_ROUTES];
+static unsigned g_dmRouteIn[DIRECT_MONITOR_MAX_ROUTES];
+static int g_dmRouteGain[DIRECT_MONITOR_MAX_ROUTES];
+
+static unsigned g_dmCalls = 0;
+static unsigned g_dmMin = 0;
+static unsigned g_dmMax = 0;
+static unsigned long long g_dmTotal = 0;
+
+/* Adds, updates or (gain 0) removes the route from in to out */
+#pragma unsafe arrays
+static unsigned DirectMonitorSetRoute(unsigned out, unsigned in, int gain)
+{
+    unsigned n = g_dmNumRoutes;
+    unsigned r = 0;
+
+    while((r < n) && ((g_dmRouteOut[r] < out) || ((g_dmRouteOut[r] == out) && (g_dmRouteIn[r] < in))))
+    {
+        r++;
+    }
+
+    if((r < n) && (g_dmRouteOut[r] == out) && (g_dmRouteIn[r] == in))
+    {
+        if(gain)
+        {
+            g_dmRouteGain[r] = gain;
+        }
+        else
+        {
+            for(unsigned i = r + 1; i < n; i++)
+            {
+                g_dmRouteOut[i - 1] = g_dmRouteOut[i];
+                g_dmRouteIn[i - 1] = g_dmRouteIn[i];
+                g_dmRouteGain[i - 1] = g_dmRouteGain[i];
+            }
+            g_dmNumRoutes = n - 1;
+        }
+        return 1;
+    }
+
+    if(!gain)
+    {
+        return 1;
+    }
+
+    if(n == DIRECT_MONITOR_MAX_ROUTES)
+    {
+        return 0;
+    }
+
+    for(unsigned i = n; i > r; i--)
+    {
+        g_dmRouteOut[i] = g_dmRouteOut[i - 1];
+        g_dmRouteIn[i] = g_dmRouteIn[i - 1];
+        g_dmRouteGain[i] = g_dmRouteGain[i - 1];
+    }
+    g_dmRouteOut[r] = out;
+    g_dmRouteIn[r] = in;
+    g_dmRouteGain[r] = gain;
+    g_dmNumRoutes = n + 1;
+    return 1;
+}
+
+static void DirectMonitorCommand(chanend c, unsigned cmd)
+{
+    switch(cmd)
+    {
+        case DIRECT_MONITOR_CMD_SET:
+        {
+            unsigned out = inuint(c);
+            unsigned in = inuint(c);
+            int gain = inuint(c);
+            outuint(c, DirectMonitorSetRoute(out, in, gain));
+            break;
+        }
+
+        case DIRECT_MONITOR_CMD_STATS:
+            outuint(c, g_dmCalls);
+            outuint(c, g_dmMin);
+            outuint(c, g_dmMax);
+            outuint(c, (unsigned) g_dmTotal);
+            outuint(c, (unsigned)(g_dmTotal >> 32));
+            break;
+
+        default:
+            g_dmCalls = 0;
+            g_dmMin = 0;
+            g_dmMax = 0;
+            g_dmTotal = 0;
+            outuint(c, 0);
+            break;
+    }
+}
+
+/* Mixes the routed inputs into the outputs, then handles at most one control command */
+#pragma unsafe arrays
+void DirectMonitor(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[])
+{
+    timer t;
+    unsigned start, end;
+    const unsigned n = g_dmNumRoutes;
+    unsigned r = 0;
+
+    t :> start;
+
+    while(r < n)
+    {
+        const unsigned out = g_dmRouteOut[r];
+        long long acc = ((long long)(int) sampsFromUsbToAudio[out]) << DIRECT_MONITOR_GAIN_Q;
+
+        do
+        {
+            acc += (long long) g_dmRouteGain[r] * (int) sampsFromAudioToUsb[g_dmRouteIn[r]];
+            r++;
+        }
+        while((r < n) && (g_dmRouteOut[r] == out));
+
+        acc >>= DIRECT_MONITOR_GAIN_Q;
+        if(acc > 0x7FFFFFFFLL)
+            acc = 0x7FFFFFFFLL;
+        else if(acc < -0x80000000LL)
+            acc = -0x80000000LL;
+        sampsFromUsbToAudio[out] = (unsigned) acc;
+    }
+
+    unsafe
+    {
+        unsigned cmd;
+
+        select
+        {
+            case inuint_byref((chanend) uc_directMonitor, cmd):
+                DirectMonitorCommand((chanend) uc_directMonitor, cmd);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    t :> end;
+    end -= start;
+
+    if((g_dmCalls == 0) || (end < g_dmMin))
+        g_dmMin = end;
+    if(end > g_dmMax)
+        g_dmMax = end;
+    g_dmCalls++;
+    g_dmTotal += end;
+}
+
+#if (DIRECT_MONITOR_ENDPOINT0)
+#include "xud_device.h"
+
+/* From lib_xua */
+unsigned db_to_mult(int db, int db_frac_bits, int result_frac_bits);
+
+/* Crosspoint gains as requested, in 1/256 dB. Owned by Endpoint 0 */
+static short g_dmGainDb[DIRECT_MONITOR_INS * DIRECT_MONITOR_OUTS];
+static int g_dmGainDbInit = 0;
+
+static unsigned DirectMonitorSetGain(chanend c, unsigned index, int db)
+{
+    unsigned gain = 0;
+
+    if(db != (short) DIRECT_MONITOR_GAIN_OFF)
+    {
+        if(db < DIRECT_MONITOR_MIN_GAIN)
+            db = DIRECT_MONITOR_MIN_GAIN;
+        else if(db > DIRECT_MONITOR_MAX_GAIN)
+            db = DIRECT_MONITOR_MAX_GAIN;
+        gain = db_to_mult(db, 8, DIRECT_MONITOR_GAIN_Q);
+    }
+
+    outuint(c, DIRECT_MONITOR_CMD_SET);
+    outuint(c, index % DIRECT_MONITOR_OUTS);
+    outuint(c, index / DIRECT_MONITOR_OUTS);
+    outuint(c, gain);
+
+    if(!inuint(c))
+    {
+        return 0;
+    }
+
+    g_dmGainDb[index] = db;
+    return 1;
+}
+
+/* Handles the direct monitor controls, returns XUD_RES_ERR for any other request */
+int DirectMonitorRequest(XUD_ep ep0_out, XUD_ep ep0_in, USB_SetupPacket_t &sp, chanend c)
+{
+    unsigned char buffer[16];
+    const unsigned cs = sp.wValue >> 8;
+    const unsigned cn = sp.wValue & 0xff;
+
+    if((sp.bmRequestType.Type != USB_BM_REQTYPE_TYPE_CLASS)
+        || (sp.bmRequestType.Recipient != USB_BM_REQTYPE_RECIP_INTER)
+        || ((sp.wIndex >> 8) != DIRECT_MONITOR_UNIT_ID))
+    {
+        return XUD_RES_ERR;
+    }
+
+    if(!g_dmGainDbInit)
+    {
+        for(unsigned i = 0; i < (DIRECT_MONITOR_INS * DIRECT_MONITOR_OUTS); i++)
+        {
+            g_dmGainDb[i] = (short) DIRECT_MONITOR_GAIN_OFF;
+        }
+        g_dmGainDbInit = 1;
+    }
+
+    if((cs == DIRECT_MONITOR_CS_GAIN) && (cn < (DIRECT_MONITOR_INS * DIRECT_MONITOR_OUTS)))
+    {
+        if(sp.bmRequestType.Direction == USB_BM_REQTYPE_DIRECTION_H2D)
+        {
+            unsigned length;
+
+            if(sp.bRequest != DIRECT_MONITOR_REQ_CUR)
+                return XUD_RES_ERR;
+
+            XUD_Result_t result = XUD_GetBuffer(ep0_out, buffer, length);
+            if(result != XUD_RES_OKAY)
+                return result;
+
+            if((length != 2) || !DirectMonitorSetGain(c, cn, (short)(buffer[0] | (buffer[1] << 8))))
+                return XUD_RES_ERR;
+
+            return XUD_DoSetRequestStatus(ep0_in);
+        }
+        else if(sp.bRequest == DIRECT_MONITOR_REQ_CUR)
+        {
+            buffer[0] = g_dmGainDb[cn];
+            buffer[1] = g_dmGainDb[cn] >> 8;
+            return XUD_DoGetRequest(ep0_out, ep0_in, buffer, 2, sp.wLength);
+        }
+        else if(sp.bRequest == DIRECT_MONITOR_REQ_RANGE)
+        {
+            /* One subrange: min, max, resolution */
+            buffer[0] = 1;
+            buffer[1] = 0;
+            buffer[2] = DIRECT_MONITOR_MIN_GAIN & 0xff;
+            buffer[3] = (DIRECT_MONITOR_MIN_GAIN >> 8) & 0xff;
+            buffer[4] = DIRECT_MONITOR_MAX_GAIN & 0xff;
+            buffer[5] = (DIRECT_MONITOR_MAX_GAIN >> 8) & 0xff;
+            buffer[6] = 1;
+            buffer[7] = 0;
+            return XUD_DoGetRequest(ep0_out, ep0_in, buffer, 8, sp.wLength);
+        }
+    }
+    else if((cs == DIRECT_MONITOR_CS_CYCLES) && (cn == 0) && (sp.bRequest == DIRECT_MONITOR_REQ_CUR))
+    {
+        if(sp.bmRequestType.Direction == USB_BM_REQTYPE_DIRECTION_H2D)
+        {
+            if(sp.wLength)
+            {
+                unsigned length;
+
+                XUD_Result_t result = XUD_GetBuffer(ep0_out, buffer, length);
+                if(result != XUD_RES_OKAY)
+                    return result;
+            }
+
+            outuint(c, DIRECT_MONITOR_CMD_RESET);
+            (void) inuint(c);
+            return XUD_DoSetRequestStatus(ep0_in);
+        }
+        else
+        {
+            unsigned stats[4];
+
+            outuint(c, DIRECT_MONITOR_CMD_STATS);
+            stats[0] = inuint(c);
+            stats[1] = inuint(c);
+            stats[3] = inuint(c);
+
+            unsigned long long total = inuint(c);
+            total |= ((unsigned long long) inuint(c)) << 32;
+            stats[2] = stats[0] ? (unsigned)(total / stats[0]) : 0;
+
+            for(unsigned i = 0; i < 16; i++)
+            {
+                buffer[i] = stats[i >> 2] >> (8 * (i & 3));
+            }
+            return XUD_DoGetRequest(ep0_out, ep0_in, buffer, 16, sp.wLength);
+        }
+    }
+
+    return XUD_RES_ERR;
+}
+#endif
+
+#endif
+
+#endif
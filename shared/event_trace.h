@@ -0,0 +1,299 @@
+#ifndef _EVENT_TRACE_H_
+#define _EVENT_TRACE_H_
+
+/*
+ * Event trace: a timestamped record of sample rate changes, stream start/stop, suspend/resume,
+ * HID reports and clock events, for working out what led up to a dropout without stopping the
+ * audio. Unlike print.h it never blocks the caller, so can be left in production firmware.
+ *
+ * EventTrace(event, arg) stores the reference timer (100MHz ticks) and the event in a ring of
+ * the calling hardware thread. Each ring has a single writer, so there is no lock and no wait,
+ * and a call is a dozen or so instructions. A ring keeps the last EVENT_TRACE_RING_EVENTS - 1
+ * events of its thread, older ones are overwritten.
+ *
+ * EventTraceRead() merges the rings of a tile into time order. It runs alongside the writers: an
+ * event overwritten while it was being read is left out. Timestamps are compared relative to the
+ * time of the read, so events more than 21s old (half the timer wrap) may be out of order.
+ *
+ * Events are read:
+ *
+ *   - over VENDOR_REQUEST_EVENT_TRACE (shared/vendor_requests.h), handled by EventTraceRequest()
+ *     from VendorRequests(). Endpoint 0 reads the rings of XUD_TILE itself and asks the other
+ *     tile for the others: EventTraceTask(), which otherwise waits, or a task serving other
+ *     requests as well that calls EventTraceCommand()
+ *   - with EVENT_TRACE_XSCOPE, on the EVENT_TRACE xscope probe as each is recorded, as
+ *     (event << 24) | arg. This adds an xscope write, some tens of instructions, to the caller,
+ *     and needs the probe in the application's config.xscope
+ *
+ * Include with EVENT_TRACE_DEFINE defined in one C source file (the rings, EventTrace() and
+ * EventTraceRead()) and one XC source file (EventTraceTask(), EventTraceCommand() and
+ * EventTraceRequest()) per
+ * application; elsewhere without.
+ */
+
+#include "xua_conf.h"
+
+#ifndef EVENT_TRACE_ENABLE
+#define EVENT_TRACE_ENABLE          (0)
+#endif
+
+/* Events kept per hardware thread, a power of 2 */
+#ifndef EVENT_TRACE_RING_EVENTS
+#define EVENT_TRACE_RING_EVENTS     (16)
+#endif
+
+#ifndef EVENT_TRACE_XSCOPE
+#define EVENT_TRACE_XSCOPE          (0)
+#endif
+
+/* Most events returned by one vendor request */
+#ifndef EVENT_TRACE_READ_EVENTS
+#define EVENT_TRACE_READ_EVENTS     (32)
+#endif
+
+#define EVENT_TRACE_THREADS         (8)
+
+/* Events, arg is 24 bits */
+#define EVENT_TRACE_HW_CONFIG       (1)     /* AudioHwConfig() called, arg the sample rate */
+#define EVENT_TRACE_HW_CONFIG_DONE  (2)     /* AudioHwConfig() returning, arg the time it took in us */
+#define EVENT_TRACE_STREAM_START    (3)     /* UserAudioStreamStart() */
+#define EVENT_TRACE_STREAM_STOP     (4)     /* UserAudioStreamStop() */
+#define EVENT_TRACE_SUSPEND         (5)     /* XUD_UserSuspend() */
+#define EVENT_TRACE_RESUME          (6)     /* XUD_UserResume() */
+#define EVENT_TRACE_HID             (7)     /* UserHIDPoll() has a new report, arg the report byte */
+#define EVENT_TRACE_PLL_LOCK        (8)     /* MCLK PLL locked, arg the time it took in us,
+                                             * EVENT_TRACE_ARG_MAX if it timed out or
+                                             * EVENT_TRACE_ARG_MAX - 1 if left to lock once the
+                                             * reference starts */
+#define EVENT_TRACE_PLL_SLIP        (9)     /* Software PLL lost the reference, arg the slips so far */
+
+#define EVENT_TRACE_ARG_MAX         (0xFFFFFF)
+
+/* Event word: event id and arg */
+#define EVENT_TRACE_WORD(event, arg)    (((event) << 24) | ((arg) & EVENT_TRACE_ARG_MAX))
+#define EVENT_TRACE_EVENT(word)         ((word) >> 24)
+#define EVENT_TRACE_ARG(word)           ((word) & EVENT_TRACE_ARG_MAX)
+
+/* Reference timer and hardware thread of the caller, replaceable for host builds */
+#ifndef EVENT_TRACE_TIME
+#define EVENT_TRACE_TIME()          ({unsigned _t; asm volatile("gettime %0" : "=r"(_t)); _t;})
+#endif
+
+#ifndef EVENT_TRACE_THREAD
+#define EVENT_TRACE_THREAD()        ({unsigned _id; asm volatile("get %0, id" : "=r"(_id)); _id;})
+#endif
+
+/* Commands from EventTraceRequest() to EventTraceTask(), sent as VENDOR_REQUEST_CMD() */
+#define EVENT_TRACE_CMD_READ        (0)     /* -> time of the read, events recorded, n, n x (time, word) */
+
+#if (EVENT_TRACE_ENABLE)
+#include <xccompat.h>
+
+#if (EVENT_TRACE_RING_EVENTS & (EVENT_TRACE_RING_EVENTS - 1))
+#error EVENT_TRACE_RING_EVENTS must be a power of 2
+#endif
+
+/* Records event for the calling thread */
+void EventTrace(unsigned event, unsigned arg);
+
+/* Copies the most recent events of the tile, at most max, oldest first into events as pairs of
+ * words (time, EVENT_TRACE_WORD()). Returns the number copied. now is set to the time of the
+ * read and total to the number of events recorded on the tile since start-up */
+unsigned EventTraceRead(unsigned events[], unsigned max, REFERENCE_PARAM(unsigned, now),
+    REFERENCE_PARAM(unsigned, total));
+
+#ifdef __XC__
+/* Answers EVENT_TRACE_CMD_READ on c with the events of its tile, for EventTraceRequest() on the
+ * XUD tile */
+void EventTraceTask(chanend c);
+
+/* Answers one command, already taken from c */
+void EventTraceCommand(chanend c, unsigned cmd);
+#endif
+
+#if defined(EVENT_TRACE_DEFINE) && !defined(__XC__)
+#if (EVENT_TRACE_XSCOPE)
+#include <xscope.h>
+#endif
+
+/* Stops the compiler moving the event stores past the index update */
+#ifndef EVENT_TRACE_BARRIER
+#define EVENT_TRACE_BARRIER()       asm volatile("" ::: "memory")
+#endif
+
+#define EVENT_TRACE_IDX(i)          ((i) & (EVENT_TRACE_RING_EVENTS - 1))
+
+/* Written by the owning thread only */
+static unsigned g_eventTrace[EVENT_TRACE_THREADS][EVENT_TRACE_RING_EVENTS][2];
+static volatile unsigned g_eventTraceHead[EVENT_TRACE_THREADS];
+
+void EventTrace(unsigned event, unsigned arg)
+{
+    const unsigned thread = EVENT_TRACE_THREAD();
+    const unsigned head = g_eventTraceHead[thread];
+    unsigned *e = g_eventTrace[thread][EVENT_TRACE_IDX(head)];
+
+    e[0] = EVENT_TRACE_TIME();
+    e[1] = EVENT_TRACE_WORD(event, arg);
+    EVENT_TRACE_BARRIER();
+    g_eventTraceHead[thread] = head + 1;
+
+#if (EVENT_TRACE_XSCOPE)
+    xscope_int(EVENT_TRACE, e[1]);
+#endif
+}
+
+unsigned EventTraceRead(unsigned events[], unsigned max, unsigned *now, unsigned *total)
+{
+    /* Snapshot of all rings, as age (ticks before now) and event word */
+    unsigned age[EVENT_TRACE_THREADS * EVENT_TRACE_RING_EVENTS];
+    unsigned word[EVENT_TRACE_THREADS * EVENT_TRACE_RING_EVENTS];
+    unsigned n = 0;
+    unsigned sum = 0;
+
+    *now = EVENT_TRACE_TIME();
+
+    for(unsigned t = 0; t < EVENT_TRACE_THREADS; t++)
+    {
+        /* The slot after the newest event may be being written */
+        const unsigned head = g_eventTraceHead[t];
+        const unsigned first = n;
+        const unsigned count = (head < EVENT_TRACE_RING_EVENTS) ? head : (EVENT_TRACE_RING_EVENTS - 1);
+
+        EVENT_TRACE_BARRIER();
+        for(unsigned i = head - count; i != head; i++)
+        {
+            age[n] = *now - g_eventTrace[t][EVENT_TRACE_IDX(i)][0];
+            word[n] = g_eventTrace[t][EVENT_TRACE_IDX(i)][1];
+            n++;
+        }
+        EVENT_TRACE_BARRIER();
+
+        /* Drop the oldest events if the thread wrote over them during the copy */
+        const unsigned written = g_eventTraceHead[t] - head;
+        if((written + count) >= EVENT_TRACE_RING_EVENTS)
+        {
+            const unsigned over = written + count + 1 - EVENT_TRACE_RING_EVENTS;
+            const unsigned lost = (over < count) ? over : count;
+            for(unsigned i = first; i < n - lost; i++)
+            {
+                age[i] = age[i + lost];
+                word[i] = word[i + lost];
+            }
+            n -= lost;
+        }
+        sum += g_eventTraceHead[t];
+    }
+    *total = sum;
+
+    /* Oldest first. Insertion sort, each ring is already in order */
+    for(unsigned i = 1; i < n; i++)
+    {
+        const unsigned a = age[i];
+        const unsigned w = word[i];
+        unsigned j = i;
+
+        while((j > 0) && (age[j - 1] < a))
+        {
+            age[j] = age[j - 1];
+            word[j] = word[j - 1];
+            j--;
+        }
+        age[j] = a;
+        word[j] = w;
+    }
+
+    const unsigned skip = (n > max) ? (n - max) : 0;
+    for(unsigned i = skip; i < n; i++)
+    {
+        events[2 * (i - skip)] = *now - age[i];
+        events[2 * (i - skip) + 1] = word[i];
+    }
+    return n - skip;
+}
+#endif
+
+#if defined(EVENT_TRACE_DEFINE) && defined(__XC__)
+#include "xud_device.h"
+#include "vendor_requests.h"
+
+void EventTraceCommand(chanend c, unsigned cmd)
+{
+    unsigned events[2 * EVENT_TRACE_READ_EVENTS];
+    unsigned now, total;
+
+    /* EVENT_TRACE_CMD_READ is the only command */
+    const unsigned n = EventTraceRead(events, EVENT_TRACE_READ_EVENTS, now, total);
+
+    outuint(c, now);
+    outuint(c, total);
+    outuint(c, n);
+    for(unsigned i = 0; i < (2 * n); i++)
+    {
+        outuint(c, events[i]);
+    }
+}
+
+void EventTraceTask(chanend c)
+{
+    while(1)
+    {
+        EventTraceCommand(c, inuint(c));
+    }
+}
+
+/* Handles VENDOR_REQUEST_EVENT_TRACE, returns XUD_RES_ERR for any other request. c is the
+ * channel to EventTraceTask(), or the task calling EventTraceCommand(), on the other tile */
+int EventTraceRequest(XUD_ep ep0_out, XUD_ep ep0_in, USB_SetupPacket_t &sp, chanend c)
+{
+    unsigned events[2 * EVENT_TRACE_READ_EVENTS];
+    unsigned char buffer[4 * (3 + (2 * EVENT_TRACE_READ_EVENTS))];
+    unsigned now, total, n;
+
+    if((sp.bmRequestType.Type != USB_BM_REQTYPE_TYPE_VENDOR)
+        || (sp.bmRequestType.Recipient != USB_BM_REQTYPE_RECIP_DEV)
+        || (sp.bRequest != VENDOR_REQUEST_EVENT_TRACE)
+        || (sp.bmRequestType.Direction != USB_BM_REQTYPE_DIRECTION_D2H))
+    {
+        return XUD_RES_ERR;
+    }
+
+    if(sp.wIndex == XUD_TILE)
+    {
+        n = EventTraceRead(events, EVENT_TRACE_READ_EVENTS, now, total);
+    }
+    else if(sp.wIndex < 2)
+    {
+        outuint(c, VENDOR_REQUEST_CMD(VENDOR_REQUEST_EVENT_TRACE, EVENT_TRACE_CMD_READ));
+        now = inuint(c);
+        total = inuint(c);
+        n = inuint(c);
+        for(unsigned i = 0; i < (2 * n); i++)
+        {
+            events[i] = inuint(c);
+        }
+    }
+    else
+    {
+        return XUD_RES_ERR;
+    }
+
+    for(unsigned i = 0; i < 4; i++)
+    {
+        buffer[i] = now >> (8 * i);
+        buffer[4 + i] = total >> (8 * i);
+        buffer[8 + i] = n >> (8 * i);
+    }
+    for(unsigned i = 0; i < (8 * n); i++)
+    {
+        buffer[12 + i] = events[i >> 2] >> (8 * (i & 3));
+    }
+    return XUD_DoGetRequest(ep0_out, ep0_in, buffer, 12 + (8 * n), sp.wLength);
+}
+#endif
+
+#else
+#define EventTrace(event, arg)
+#endif
+
+#endif
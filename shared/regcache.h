@@ -0,0 +1,134 @@
+#ifndef _REGCACHE_H_
+#define _REGCACHE_H_
+
+#include <stdint.h>
+
+/*
+ * Shadow register cache for the codec drivers.
+ *
+ * Holds the last value written to each register of REGCACHE_NUM_DEVS devices so that a driver
+ * can skip writes of a value a register already holds, and trim register bursts down to the
+ * registers that change. A configuration is then sent as the difference from the current one,
+ * for example a sample rate change only writes the rate dependent registers.
+ *
+ * Devices are numbered 0 to REGCACHE_NUM_DEVS - 1 by the driver, registers 0 to
+ * REGCACHE_NUM_REGS - 1 (a driver for a paged device can use page * 128 + register). A register
+ * is unknown until it is written through the cache. Drivers must call RegCacheInvalidate() when
+ * a device is reset (reset pin or reset register) and must not write registers that change by
+ * themselves (status, self-clearing bits) through the cache.
+ *
+ * RegCacheWrite() and RegCacheBurst() record the new value before the caller writes it. If the
+ * write fails (NACK, bus error, or a write whose completion is not known) the driver must call
+ * RegCacheInvalidate() for the device, otherwise later writes of that value would be skipped.
+ *
+ * I2C bytes are counted as the device address, register and data bytes of each write (start,
+ * stop and acks are not counted). g_regCacheBytesWritten/Saved accumulate from start-up, and
+ * RegCacheCfgStart()/RegCacheCfgEnd() around a configuration (e.g. in AudioHwConfig()) leave
+ * its figures in g_regCacheCfgBytesWritten/Saved for reading with a debugger or over xscope.
+ */
+
+#ifndef REGCACHE_NUM_DEVS
+#error REGCACHE_NUM_DEVS must be defined before including regcache.h
+#endif
+
+#ifndef REGCACHE_NUM_REGS
+#define REGCACHE_NUM_REGS           (128)
+#endif
+
+/* Device address and register bytes of each write */
+#define REGCACHE_WRITE_BYTES        (2)
+
+/* Result of RegCacheBurst(): offset of the first register to write and how many */
+#define REGCACHE_FIRST(range)       ((range) >> 16)
+#define REGCACHE_COUNT(range)       ((range) & 0xFFFF)
+
+uint8_t g_regCache[REGCACHE_NUM_DEVS][REGCACHE_NUM_REGS];
+uint32_t g_regCacheValid[REGCACHE_NUM_DEVS][(REGCACHE_NUM_REGS + 31) / 32];
+
+unsigned g_regCacheBytesWritten = 0;
+unsigned g_regCacheBytesSaved = 0;
+unsigned g_regCacheCfgBytesWritten = 0;
+unsigned g_regCacheCfgBytesSaved = 0;
+unsigned g_regCacheCfgStartWritten = 0;
+unsigned g_regCacheCfgStartSaved = 0;
+
+/* Forgets all registers of a device, e.g. after it has been reset */
+void RegCacheInvalidate(unsigned dev)
+{
+    for(unsigned i = 0; i < (REGCACHE_NUM_REGS + 31) / 32; i++)
+    {
+        g_regCacheValid[dev][i] = 0;
+    }
+}
+
+/* Marks reg as holding val, returns 1 if it did not already */
+static inline unsigned RegCacheUpdate(unsigned dev, unsigned reg, unsigned val)
+{
+    const uint32_t bit = 1u << (reg & 31);
+
+    if((g_regCacheValid[dev][reg >> 5] & bit) && (g_regCache[dev][reg] == val))
+    {
+        return 0;
+    }
+
+    g_regCache[dev][reg] = (uint8_t) val;
+    g_regCacheValid[dev][reg >> 5] |= bit;
+    return 1;
+}
+
+/* Returns 1 if val needs writing to reg, in which case the caller must write it (the cache now
+ * holds val), or 0 if the register already holds val */
+unsigned RegCacheWrite(unsigned dev, unsigned reg, unsigned val)
+{
+    if(RegCacheUpdate(dev, reg, val))
+    {
+        g_regCacheBytesWritten += REGCACHE_WRITE_BYTES + 1;
+        return 1;
+    }
+
+    g_regCacheBytesSaved += REGCACHE_WRITE_BYTES + 1;
+    return 0;
+}
+
+/* For a burst of len registers from reg, values from data[offset], returns the range that needs
+ * writing as REGCACHE_FIRST() (offset from reg) and REGCACHE_COUNT() (0 if none). The range runs
+ * from the first to the last register that changes, so unchanged registers between them are
+ * rewritten rather than splitting the burst. The caller must write the range */
+unsigned RegCacheBurst(unsigned dev, unsigned reg, const uint8_t data[], unsigned offset, unsigned len)
+{
+    unsigned first = len;
+    unsigned last = 0;
+
+    for(unsigned i = 0; i < len; i++)
+    {
+        if(RegCacheUpdate(dev, reg + i, data[offset + i]))
+        {
+            first = (first == len) ? i : first;
+            last = i;
+        }
+    }
+
+    if(first == len)
+    {
+        g_regCacheBytesSaved += REGCACHE_WRITE_BYTES + len;
+        return 0;
+    }
+
+    g_regCacheBytesWritten += REGCACHE_WRITE_BYTES + (last - first + 1);
+    g_regCacheBytesSaved += len - (last - first + 1);
+    return (first << 16) | (last - first + 1);
+}
+
+void RegCacheCfgStart()
+{
+    g_regCacheCfgStartWritten = g_regCacheBytesWritten;
+    g_regCacheCfgStartSaved = g_regCacheBytesSaved;
+}
+
+void RegCacheCfgEnd()
+{
+    g_regCacheCfgBytesWritten = g_regCacheBytesWritten - g_regCacheCfgStartWritten;
+    g_regCacheCfgBytesSaved = g_regCacheBytesSaved - g_regCacheCfgStartSaved;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef _UBM_TIMING_H_
+#define _UBM_TIMING_H_
+
+/*
+ * Cycle accounting for UserBufferManagement().
+ *
+ * Include this file before the application's definition of UserBufferManagement(). With
+ * UBM_TIMING_ENABLE set that definition is renamed and wrapped by a UserBufferManagement()
+ * that times each call with the reference timer (100MHz ticks). The wrapper and the statistics
+ * are in shared/ubm_timing.xc, built by including it from one XC source file per application.
+ *
+ * The sample rate is identified from the interval between calls (one call per sample frame), so
+ * no hook is needed in AudioHwConfig(). An interval matches a rate within 1/32 of its frame
+ * period. The closest rates, 44.1kHz and 48kHz (and their multiples), are 8.8% apart, so the
+ * windows of the rates are separate with room for jitter in when the audio thread makes the
+ * call. Calls whose interval does not match a known rate (e.g. the first call after audio
+ * restarts) are not recorded.
+ *
+ * For each rate the following are kept in g_ubmTiming[]:
+ *   - number of calls, min/max/total ticks
+ *   - a histogram of ticks as a fraction of the frame period, UBM_TIMING_HIST_BINS equal bins
+ *     from 0 to 100% plus a final bin for calls that took a whole frame or more
+ *   - deadline misses: calls longer than UBM_TIMING_BUDGET_PERCENT of the frame period
+ *
+ * The statistics for the current rate are streamed over xscope (probes in the application's
+ * config.xscope), one value every UBM_TIMING_REPORT_CALLS calls so that reporting never adds
+ * more than one probe write to a frame. A report is, in order: UBM_SAMFREQ, UBM_CALLS, UBM_MIN,
+ * UBM_AVG, UBM_MAX, UBM_MISSES then the UBM_TIMING_HIST_BINS + 1 histogram bins on UBM_HIST.
+ *
+ * Recording costs some tens of instructions per call, outside of the timed section.
+ */
+
+#ifndef UBM_TIMING_ENABLE
+#define UBM_TIMING_ENABLE           (0)
+#endif
+
+#ifndef UBM_TIMING_HIST_BINS
+#define UBM_TIMING_HIST_BINS        (16)
+#endif
+
+/* Share of the frame period UserBufferManagement() may use before a call counts as a miss. The
+ * audio thread also has its own per-frame work outside UserBufferManagement() (the I2S port
+ * I/O, the exchange with the decoupler or mixer and the volume), assumed here to need up to 40%
+ * of the frame at the highest rates. A call that takes the whole frame means the audio thread
+ * has already slipped, so 100 only counts misses after the fact */
+#ifndef UBM_TIMING_BUDGET_PERCENT
+#define UBM_TIMING_BUDGET_PERCENT   (60)
+#endif
+
+#ifndef UBM_TIMING_REPORT_CALLS
+#define UBM_TIMING_REPORT_CALLS     (1000)
+#endif
+
+#define UBM_TIMING_NUM_FREQS        (8)
+#define UBM_TIMING_PERIOD(f)        (XS1_TIMER_HZ / (f))
+#define UBM_TIMING_BUDGET(f)        ((UBM_TIMING_PERIOD(f) * UBM_TIMING_BUDGET_PERCENT) / 100)
+
+#if (UBM_TIMING_ENABLE)
+typedef struct
+{
+    unsigned calls;
+    unsigned min;
+    unsigned max;
+    unsigned long long total;
+    unsigned misses;
+    unsigned hist[UBM_TIMING_HIST_BINS + 1];
+} ubm_timing_t;
+
+/* Rates told apart, and the statistics per rate indexed as g_ubmTimingFreqs[] */
+extern const unsigned g_ubmTimingFreqs[UBM_TIMING_NUM_FREQS];
+extern ubm_timing_t g_ubmTiming[UBM_TIMING_NUM_FREQS];
+
+/* Clears the statistics for all rates */
+void UbmTimingReset();
+
+/* The application's UserBufferManagement(), renamed below. The UserBufferManagement() that lib_xua
+ * calls is the wrapper in ubm_timing.xc */
+void UbmTimedUserBufferManagement(unsigned sampsFromUsbToAudio[], unsigned sampsFromAudioToUsb[]);
+
+#ifndef UBM_TIMING_DEFINE
+#define UserBufferManagement UbmTimedUserBufferManagement
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef _VENDOR_REQUESTS_H_
+#define _VENDOR_REQUESTS_H_
+
+/*
+ * Vendor specific control requests handled by the applications' VendorRequests().
+ *
+ * All are device recipient, vendor type requests on Endpoint 0 (bmRequestType 0x40 host to
+ * device, 0xC0 device to host). Values in the data stage are little-endian. Requests that an
+ * application does not support are stalled.
+ *
+ * bRequest codes are allocated here so that they do not clash between features or apps.
+ *
+ * Commands passed on from a handler to the task that serves the request carry the bRequest code
+ * in bits 15:8 (VENDOR_REQUEST_CMD()), so that one task can serve several requests.
+ */
+
+#define VENDOR_REQUEST_CMD(request, cmd)    (((request) << 8) | (cmd))
+#define VENDOR_REQUEST_CMD_REQUEST(word)    ((word) >> 8)
+#define VENDOR_REQUEST_CMD_CMD(word)        ((word) & 0xFF)
+
+/* DSP parameter (DspSetParam()/DspGetParam()): wValue is the parameter id, wIndex 0,
+ * data is the value as a 4 byte signed integer */
+#define VENDOR_REQUEST_DSP_PARAM        (0x01)
+
+/* Logical core load (CoreLoadRequest(), app_usb_aud_xk_316_mc extensions/core_load.h): wValue 0,
+ * wIndex the tile. Device to host, 128 bytes: 32-bit words windows since reset, window length in
+ * ms, mask of the instrumented cores, then for each of the 8 cores of the tile its load in the
+ * last window, the peak window and the average since reset, all in 1/1000 of the core, then the
+ * idle and last count rates of the tile (counts per ms) and its free fraction in the last window,
+ * the lowest window and on average since reset, in 1/1000. Host to device with no data stage
+ * restarts the statistics of the tile */
+#define VENDOR_REQUEST_CORE_LOAD        (0x02)
+
+/* Event trace (EventTraceRequest(), shared/event_trace.h): wValue 0, wIndex the tile. Device to
+ * host only: 32-bit words time of the read, events recorded on the tile since start-up and the
+ * number of events n that follow, then n events oldest first, each as the reference timer (100MHz)
+ * at the event and (event << 24) | arg. At most 268 bytes (32 events) */
+#define VENDOR_REQUEST_EVENT_TRACE      (0x03)
+
+/* Channel levels (MeterRequest(), app_usb_aud_xk_316_mc extensions/meter.h): wIndex 0. Device to
+ * host, 4 + 6 x channels bytes: 16-bit periods metered since reset, 8-bit number of host to
+ * device and device to host channels, then for each channel, host to device first, 16-bit peak
+ * and RMS of the last period (65535 full scale) and clipped samples since reset (saturating).
+ * Host to device with no data stage: wValue 0 restarts the clip counts, 1 to 100 sets the update
+ * rate in Hz */
+#define VENDOR_REQUEST_METER            (0x04)
+
+/* Dropout counters (XrunRequest(), app_usb_aud_xk_316_mc extensions/xrun.h): wValue 0, wIndex 0.
+ * Device to host, 32 bytes: 32-bit counts since reset of I2S slips, frames lost in them, host to
+ * device silence gaps, device to host silence gaps, audio restarts, PLL lock timeouts, SW PLL
+ * slips and SW PLL losses of lock. Host to device with no data stage resets them */
+#define VENDOR_REQUEST_XRUN             (0x05)
+
+/* Latency stages (LatencyRequest(), app_usb_aud_xk_316_mc extensions/latency.h): wIndex 0.
+ * Device to host, 40 bytes: 32-bit sample rate, mask of the stages the marker has been seen at
+ * since armed (bit 0 USB out, 1 I2S out, 2 I2S in, 3 USB in), then for each stage the frame
+ * since the audio restarted and the reference timer (100MHz), 0 if not seen. Host to device
+ * with no data stage: wValue 0 arms for a marker from the host, 1 also inserts one at I2S out */
+#define VENDOR_REQUEST_LATENCY          (0x06)
+
+#endif
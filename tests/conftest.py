@@ -21,6 +21,12 @@ def pytest_addoption(parser):
     parser.addini("xk_316_mc_harness", help="XTAG ID for xk_316_mc harness")
     parser.addini("xk_evk_xu316_dut", help="XTAG ID for xk_evk_xu316 DUT")
     parser.addini("xk_evk_xu316_harness", help="XTAG ID for xk_evk_xu316 harness")
+    parser.addini(
+        "xk_316_mc_sw_pll_ref_link",
+        type="bool",
+        default=False,
+        help="xk_316_mc DUT has X0D00 linked to X0D12, for the SW_PLL_ENABLE configs",
+    )
 
 
 boards = ["xk_216_mc", "xk_316_mc", "xk_evk_xu316"]
@@ -104,6 +110,7 @@ def pytest_sessionstart(session):
     exclude_app = ["app_usb_aud_xk_evk_xu316_extrai2s"]
 
     test_level = session.config.getoption("level")
+    sw_pll_ref_link = session.config.getini("xk_316_mc_sw_pll_ref_link")
 
     for app_dir in usb_audio_dir.iterdir():
         app_name = app_dir.name
@@ -114,6 +121,9 @@ def pytest_sessionstart(session):
 
         # Get all the configs, and determine which will be fully- or partially-tested
         allconfigs_cmd = ["xmake", "allconfigs"]
+        # The SW_PLL_ENABLE configs need a modified board
+        if board == "xk_316_mc" and sw_pll_ref_link:
+            allconfigs_cmd.append("SW_PLL_REF_LINK=1")
         ret = subprocess.run(
             allconfigs_cmd, capture_output=True, text=True, cwd=app_dir
         )
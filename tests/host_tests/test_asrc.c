@@ -0,0 +1,232 @@
+/* Checks the ASRC filter against ideal resampling of a sine, then runs the extrai2s ASRC with
+ * simulated clocks to check the rate estimate, ring levels and output level */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "extra_i2s_ring.h"
+#include "extra_i2s_asrc.h"
+#include "asrc.h"
+
+#ifndef XS1_TIMER_HZ
+#define XS1_TIMER_HZ        (100000000)
+#endif
+
+#define TEST_AMPLITUDE      (0.5 * 2147483648.0)
+#define TEST_FRAMES         (20000)
+
+/* Resampling noise allowed, relative to the signal */
+#define TEST_MIN_SNR_DB     (95.0)
+
+static asrc_t g_asrc;
+
+/* Resamples a sine of freq (fraction of the input rate) by step and returns the SNR of the
+ * output against the sine at the exact output positions */
+static double filter_snr(double freq, double step)
+{
+    const uint64_t stepQ32 = (uint64_t) llround(step * 4294967296.0);
+    uint64_t pos = 0;
+    unsigned pushed = 0;
+    double sigPow = 0, errPow = 0;
+
+    asrc_init(&g_asrc, 1);
+
+    for(unsigned k = 0; k < TEST_FRAMES; k++)
+    {
+        int32_t coefs[ASRC_TAPS];
+        int32_t y;
+
+        for(unsigned n = pos >> 32; n > 0; n--)
+        {
+            const int32_t x = (int32_t) lround(TEST_AMPLITUDE * sin(2.0 * M_PI * freq * pushed));
+            asrc_push(&g_asrc, &x);
+            pushed++;
+        }
+        pos = (uint32_t) pos;
+
+        asrc_coefs(coefs, (uint32_t) pos);
+        asrc_output(&g_asrc, coefs, &y);
+
+        /* Output is for ASRC_TAPS / 2 frames before the newest input, plus the fraction */
+        const double at = (double) pushed - 1 - (ASRC_TAPS / 2) + (pos / 4294967296.0);
+        if(at > ASRC_TAPS)
+        {
+            const double ideal = TEST_AMPLITUDE * sin(2.0 * M_PI * freq * at);
+            sigPow += ideal * ideal;
+            errPow += (y - ideal) * (y - ideal);
+        }
+        pos += stepQ32;
+    }
+    return 10.0 * log10(sigPow / errPow);
+}
+
+static int test_filter()
+{
+    const double freqs[] = {1000.0 / 48000, 10000.0 / 48000, 18000.0 / 48000};
+    const double ppms[] = {0, 100, -100, 5000, -10000};
+    int fail = 0;
+
+    for(unsigned f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++)
+    {
+        for(unsigned p = 0; p < sizeof(ppms) / sizeof(ppms[0]); p++)
+        {
+            double snr = filter_snr(freqs[f], 1.0 + (ppms[p] * 1e-6));
+            int bad = (snr < TEST_MIN_SNR_DB);
+            printf("%s: filter freq=%.4f ppm=%+.0f snr=%.1fdB\n", bad ? "FAIL" : "PASS", freqs[f], ppms[p], snr);
+            fail |= bad;
+        }
+    }
+    return fail;
+}
+
+/* Clock simulation: the extra interface runs ppm off the 48kHz USB clock, both with timestamp
+ * jitter, and the ASRC threads are polled every EXTRA_I2S_ASRC_POLL_TICKS */
+#define SIM_FS              (48000.0)
+#define SIM_SECONDS         (20)
+#define SIM_JITTER_TICKS    (50)
+#define SIM_FREQ            (1000.0)
+
+static unsigned sim_stamp(double t)
+{
+    return (unsigned)(long long) llround(t + (rand() % (2 * SIM_JITTER_TICKS + 1)) - SIM_JITTER_TICKS);
+}
+
+static int sim_clocks(double ppm, int expectLock)
+{
+    const double periodUsb = XS1_TIMER_HZ / SIM_FS;
+    const double periodI2s = XS1_TIMER_HZ / (SIM_FS * (1.0 + (ppm * 1e-6)));
+    const double end = SIM_SECONDS * (double) XS1_TIMER_HZ;
+    double tUsb = 0, tI2s = 0.37 * periodI2s, tPoll = 0;
+    unsigned nI2s = 0;
+    double lockTime = -1;
+    double sumSq = 0;
+    unsigned numSq = 0;
+    unsigned fillMin = EXTRA_I2S_RING_FRAMES, fillMax = 0;
+
+    ExtraI2sAsrcInit();
+
+    while((tUsb < end) || (tI2s < end))
+    {
+        if((tI2s <= tUsb) && (tI2s <= tPoll))
+        {
+            int32_t in[EXTRA_I2S_CHAN_COUNT_IN];
+            int32_t out[EXTRA_I2S_CHAN_COUNT_OUT];
+
+            for(unsigned ch = 0; ch < EXTRA_I2S_CHAN_COUNT_IN; ch++)
+            {
+                in[ch] = (int32_t) lround(TEST_AMPLITUDE * sin(2.0 * M_PI * SIM_FREQ * tI2s / XS1_TIMER_HZ));
+            }
+            ExtraI2sAsrcClock(EXTRA_I2S_CLOCK_I2S, sim_stamp(tI2s));
+            ExtraI2sRingReceive(in);
+            ExtraI2sRingSend(out);
+            tI2s += periodI2s;
+            nI2s++;
+        }
+        else if(tUsb <= tPoll)
+        {
+            unsigned fromUsb[EXTRA_I2S_CHAN_INDEX_OUT + EXTRA_I2S_CHAN_COUNT_OUT] = {0};
+            unsigned toUsb[EXTRA_I2S_CHAN_INDEX_IN + EXTRA_I2S_CHAN_COUNT_IN];
+
+            ExtraI2sAsrcClock(EXTRA_I2S_CLOCK_USB, sim_stamp(tUsb));
+            ExtraI2sRingAudio(fromUsb, toUsb);
+
+            /* Level over the last quarter */
+            if(tUsb > (end * 0.75))
+            {
+                double y = (int32_t) toUsb[EXTRA_I2S_CHAN_INDEX_IN];
+                sumSq += y * y;
+                numSq++;
+            }
+            tUsb += periodUsb;
+        }
+        else
+        {
+            ExtraI2sAsrcUpdate();
+            for(unsigned path = 0; path < EXTRA_I2S_ASRC_NUM_PATHS; path++)
+            {
+                if(ExtraI2sAsrcSchedule(path))
+                {
+                    for(unsigned t = 0; t < EXTRA_I2S_ASRC_THREADS; t++)
+                    {
+                        ExtraI2sAsrcCoefs(path, t);
+                    }
+                    for(unsigned t = 0; t < EXTRA_I2S_ASRC_THREADS; t++)
+                    {
+                        ExtraI2sAsrcProcess(path, t);
+                    }
+                    ExtraI2sAsrcCommit(path);
+                }
+            }
+
+            if(ExtraI2sAsrcLocked())
+            {
+                if(lockTime < 0)
+                    lockTime = tPoll / XS1_TIMER_HZ;
+
+                /* Source ring level once settled */
+                if(tPoll > (end / 2))
+                {
+                    unsigned fill = RingFill(&g_ringIn);
+                    fillMin = (fill < fillMin) ? fill : fillMin;
+                    fillMax = (fill > fillMax) ? fill : fillMax;
+                }
+            }
+            tPoll += EXTRA_I2S_ASRC_POLL_TICKS;
+        }
+    }
+
+    unsigned errors = 0;
+    for(unsigned c = EXTRA_I2S_IN_OVERRUNS; c <= EXTRA_I2S_OUT_UNDERRUNS; c++)
+    {
+        errors += ExtraI2sRingCount(c);
+    }
+
+    const double levelDb = numSq ? 10.0 * log10((sumSq / numSq) / (TEST_AMPLITUDE * TEST_AMPLITUDE / 2)) : -999;
+    int fail;
+
+    if(expectLock)
+    {
+        fail = (lockTime < 0) || (lockTime > 0.5) || (abs(ExtraI2sAsrcPpm() - (int) ppm) > 5) || errors
+            || (fabs(levelDb) > 0.01) || (fillMin == 0) || (fillMax == EXTRA_I2S_RING_FRAMES);
+    }
+    else
+    {
+        fail = (lockTime >= 0) || errors || (levelDb > -200);
+    }
+
+    printf("%s: clocks ppm=%+.0f lock_time=%.3fs ppm_est=%+d ring_errors=%u level=%.3fdB source_fill=%u-%u\n",
+        fail ? "FAIL" : "PASS", ppm, lockTime, ExtraI2sAsrcPpm(), errors, levelDb, fillMin, fillMax);
+    return fail;
+}
+
+int main()
+{
+    const double ppms[] = {0, 100, -300, 5000, -9000};
+    int fail = 0;
+
+    srand(1);
+    asrc_init_filter();
+
+    fail |= test_filter();
+
+    /* ASRC state is global, so each clock scenario runs in its own process */
+    for(unsigned p = 0; p <= sizeof(ppms) / sizeof(ppms[0]); p++)
+    {
+        fflush(stdout);
+        pid_t pid = fork();
+        if(pid == 0)
+        {
+            int ret = (p < sizeof(ppms) / sizeof(ppms[0])) ? sim_clocks(ppms[p], 1) : sim_clocks(20000, 0);
+            fflush(stdout);
+            _exit(ret);
+        }
+
+        int status;
+        waitpid(pid, &status, 0);
+        fail |= !WIFEXITED(status) || WEXITSTATUS(status);
+    }
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
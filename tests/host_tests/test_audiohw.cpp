@@ -0,0 +1,661 @@
+/* Profiles the codec configuration of a board application without hardware: the board's
+ * audiohw.xc (with shared/cs2100.h), lowered to C++ by xc_lower.py, runs AudioHwInit() and
+ * AudioHwConfig() for a series of sample rates against a model of the board's I2C bus.
+ *
+ * The bus model records every transaction and checks it against a model of each chip: the
+ * device answers at that address (and I2C mux channel, and is not held in reset), the register
+ * exists and the write is allowed in the chip's current state. Time is simulated: delays and
+ * timer waits cost what they ask for and each transaction its bus time at the application's I2C
+ * speed, so the time of each step is what the application spends in it on the board.
+ *
+ * One line is printed per step:
+ *
+ *   PROFILE <profile> <step> kbps=<app I2C speed> transactions=<n> bytes=<n>
+ *       bus_us_100k=<bus time at 100kbps> bus_us_400k=<at 400kbps> wait_us=<delays> total_us=<n>
+ *
+ * and test_host.py compares these with audiohw_profile.txt. The build (see the Makefile) picks
+ * the board (AUDIOHW_BOARD_316, AUDIOHW_BOARD_216 or AUDIOHW_BOARD_EVK), the application
+ * configuration and the lowered source (AUDIOHW_LOWERED) */
+
+/* Host versions of the functions xc_lower.py replaces: the 216 codec service is called directly
+ * rather than over a channel */
+#define HOST_FUNCTION_AudioHwService2
+#define HOST_FUNCTION_AudioHwService
+#define HOST_FUNCTION_SeqRun \
+    static unsigned SeqRun() \
+    { \
+        i2c_master_if i2c; \
+        const unsigned failures = SeqPlay(g_audioHwSeq, g_audioHwSeqLen, i2c); \
+        g_audioHwSeqLen = 0; \
+        if(failures & ~AUDIOHW_SEQ_UNLOCKED) \
+        { \
+            g_audioHwFailures += failures & ~AUDIOHW_SEQ_UNLOCKED; \
+            SeqFailed(); \
+        } \
+        return !(failures & AUDIOHW_SEQ_UNLOCKED); \
+    }
+
+/* The EVK's CODEC sequences are played as they are sent rather than by the remote on the other
+ * tile, so the bring-up is in the time of AudioHwInit() although it runs in the background on
+ * the board. The completion is taken by the next poll */
+#define HOST_FUNCTION_AudioHwRemote2
+#define HOST_FUNCTION_AudioHwRemote
+#define HOST_FUNCTION_CodecSeqPoll \
+    static unsigned CodecSeqPoll(unsigned timeoutMs) \
+    { \
+        g_codecSeqPending = 0; \
+        return 1; \
+    }
+#define HOST_FUNCTION_CodecSeqStart \
+    static unsigned g_hostCodecPage = 0; \
+    static unsigned g_hostCodecFailures = 0; \
+    static void CodecSeqStart(const unsigned seq[], unsigned len) \
+    { \
+        i2c_master_if i2c; \
+        g_hostCodecFailures += SeqPlay(seq, len, g_hostCodecPage, i2c); \
+        g_codecSeqPending = 1; \
+    }
+
+#include AUDIOHW_LOWERED
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(AUDIOHW_BOARD_316)
+#define HOST_I2C_KBPS               (I2C_SPEED_KBPS)
+#else
+#define HOST_I2C_KBPS               (AUDIOHW_I2C_KBPS)
+#endif
+
+/* CS2100 lock time in reference periods, the data sheet typical for references below 200kHz.
+ * The reference is assumed to be running, except in sync mode where PllWaitLock() does not wait
+ * (CS2100_REF_AT_CONFIG) */
+#define CS2100_MODEL_LOCK_PERIODS   (100)
+
+/*
+ * Simulated time, in reference timer ticks
+ */
+static unsigned long long g_hostTime = 0;
+static unsigned long long g_hostWaitTicks = 0;
+
+unsigned HostTime()
+{
+    return (unsigned) g_hostTime;
+}
+
+void HostWait(unsigned ticks)
+{
+    g_hostTime += ticks;
+    g_hostWaitTicks += ticks;
+}
+
+void HostWaitUntil(unsigned time)
+{
+    const int ticks = (int) (time - (unsigned) g_hostTime);
+    if(ticks > 0)
+    {
+        HostWait(ticks);
+    }
+}
+
+void HostChanAbort(const char *op)
+{
+    printf("FAIL: channel %s reached on the host\n", op);
+    exit(1);
+}
+
+/*
+ * Chip models
+ */
+typedef enum
+{
+    CHIP_PCA9540B,
+    CHIP_CS2100,
+    CHIP_PCM5122,
+    CHIP_PCM1865,
+    CHIP_CS4384,
+    CHIP_CS5368,
+    CHIP_AIC3204,
+} chip_t;
+
+#define NO_MUX                      (-1)
+
+typedef struct
+{
+    const char *name;
+    chip_t chip;
+    uint8_t addr;
+    int muxChan;                    /* PCA9540B channel it is on, NO_MUX if not behind the mux */
+    unsigned resetGpio;             /* GPIO bit holding it in reset when low, 0 if none */
+    uint8_t regs[128];
+    uint8_t ptr;                    /* Register of the next byte */
+    unsigned incr;                  /* Register address auto-increments in this transaction */
+    unsigned long long lockTime;    /* CS2100: when the PLL locks */
+    unsigned page;                  /* AIC3204: selected page, regs holds page 0 */
+    uint8_t page1[128];             /* AIC3204: page 1 registers */
+} device_t;
+
+#if defined(AUDIOHW_BOARD_316)
+static device_t g_devices[] =
+{
+    {"PCA9540B", CHIP_PCA9540B, PCA9540B_I2C_DEVICE_ADDR, NO_MUX},
+    {"CS2100", CHIP_CS2100, CS2100_I2C_DEVICE_ADDR, 1},
+    {"PCM5122_0", CHIP_PCM5122, PCM5122_0_I2C_DEVICE_ADDR, 0},
+    {"PCM5122_1", CHIP_PCM5122, PCM5122_1_I2C_DEVICE_ADDR, 0},
+    {"PCM5122_2", CHIP_PCM5122, PCM5122_2_I2C_DEVICE_ADDR, 0},
+    {"PCM5122_3", CHIP_PCM5122, PCM5122_3_I2C_DEVICE_ADDR, 0},
+    {"PCM1865_0", CHIP_PCM1865, PCM1865_0_I2C_DEVICE_ADDR, 0},
+    {"PCM1865_1", CHIP_PCM1865, PCM1865_1_I2C_DEVICE_ADDR, 0},
+};
+#elif defined(AUDIOHW_BOARD_EVK)
+static device_t g_devices[] =
+{
+    {"AIC3204", CHIP_AIC3204, AIC3204_I2C_DEVICE_ADDR, NO_MUX},
+};
+#else
+static device_t g_devices[] =
+{
+    {"CS2100", CHIP_CS2100, CS2100_I2C_DEVICE_ADDR, NO_MUX},
+    {"CS4384", CHIP_CS4384, CS4384_I2C_ADDR, NO_MUX, P_GPIO_DAC_RST_N},
+    {"CS5368", CHIP_CS5368, CS5368_I2C_ADDR, NO_MUX, P_GPIO_ADC_RST_N},
+};
+#endif
+
+#define NUM_DEVICES                 (sizeof(g_devices) / sizeof(g_devices[0]))
+
+static int g_muxChan = NO_MUX;      /* Selected PCA9540B channel */
+static unsigned g_gpio = 0;         /* 216 GPIO port */
+static unsigned g_modelErrors = 0;
+static const char *g_step = "";
+
+static void ModelError(const device_t *d, const char *fmt, ...)
+{
+    va_list args;
+
+    printf("ERROR %s %s: ", g_step, d ? d->name : "bus");
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+    g_modelErrors++;
+}
+
+static int InSet(unsigned reg, const uint8_t set[], unsigned n)
+{
+    for(unsigned i = 0; i < n; i++)
+    {
+        if(set[i] == reg)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#define IN_SET(reg, set)            InSet(reg, set, sizeof(set))
+
+/* Registers modelled, writable */
+static const uint8_t g_pcm5122Regs[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x07, 0x08, 0x09, 0x0C, 0x0E,
+    0x14, 0x15, 0x16, 0x17, 0x18, 0x1B, 0x1C, 0x1D, 0x1E, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x28,
+    0x29, 0x41, 0x55};
+static const uint8_t g_pcm1865Regs[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x06, 0x07, 0x08, 0x09, 0x0B,
+    0x0C, 0x0D, 0x10, 0x11, 0x12, 0x20, 0x70};
+static const uint8_t g_cs2100Regs[] = {0x02, 0x03, 0x05, 0x06, 0x07, 0x08, 0x09, 0x16, 0x17, 0x1E};
+static const uint8_t g_cs5368Regs[] = {0x01, 0x03, 0x04, 0x06, 0x08, 0x0A};
+static const uint8_t g_aic3204Page0Regs[] = {0x01, 0x0B, 0x0C, 0x0D, 0x0E, 0x12, 0x13, 0x14, 0x1B,
+    0x3C, 0x3D, 0x3F, 0x40, 0x41, 0x42, 0x51, 0x52};
+static const uint8_t g_aic3204Page1Regs[] = {0x01, 0x02, 0x03, 0x04, 0x09, 0x0A, 0x0C, 0x0D, 0x10,
+    0x11, 0x14, 0x34, 0x36, 0x37, 0x39, 0x3B, 0x3C, 0x3D, 0x47, 0x7B};
+
+/* AIC3204 registers after reset that audiohw.xc reads or relies on: the clock dividers (1,
+ * powered down) and the DAC and ADC muted */
+static void Aic3204Reset(device_t *d)
+{
+    memset(d->regs, 0, sizeof(d->regs));
+    memset(d->page1, 0, sizeof(d->page1));
+    d->page = 0;
+    d->regs[0x0B] = 0x01;
+    d->regs[0x0C] = 0x01;
+    d->regs[0x12] = 0x01;
+    d->regs[0x13] = 0x01;
+    d->regs[0x40] = 0x0C;
+    d->regs[0x52] = 0x88;
+}
+
+/* DAC (and ADC) powered with their clock dividers running, and unmuted */
+#define AIC3204_DAC_POWERED(d)      (((d)->regs[0x3F] & 0xC0) != 0)
+#define AIC3204_DAC_CLOCKED(d)      (((d)->regs[0x0B] & 0x80) && ((d)->regs[0x0C] & 0x80))
+#define AIC3204_ADC_POWERED(d)      (((d)->regs[0x51] & 0xC0) != 0)
+#define AIC3204_ADC_CLOCKED(d)      (((d)->regs[0x12] & 0x80) && ((d)->regs[0x13] & 0x80))
+#define AIC3204_UNMUTED(d)          (!((d)->regs[0x40] & 0x0C) && !((d)->regs[0x52] & 0x88))
+
+static void RegWrite(device_t *d, unsigned reg, uint8_t val)
+{
+    switch(d->chip)
+    {
+        case CHIP_PCA9540B:
+            /* Every byte is the control register */
+            if((val != 0x00) && (val != 0x04) && (val != 0x05))
+            {
+                ModelError(d, "control 0x%02X is not a channel select", val);
+            }
+            g_muxChan = (val & 0x04) ? (val & 1) : NO_MUX;
+            return;
+
+        case CHIP_PCM5122:
+            if(!IN_SET(reg, g_pcm5122Regs))
+            {
+                ModelError(d, "register 0x%02X is not modelled", reg);
+            }
+            else if((reg == 0x00) && val)
+            {
+                ModelError(d, "page %u is not modelled", val);
+            }
+            else if(((reg == 0x04) || (reg == 0x0E) || ((reg >= 0x14) && (reg <= 0x25))) && !(d->regs[0x02] & 0x10))
+            {
+                /* Clock tree changes are made in standby */
+                ModelError(d, "clock register 0x%02X written out of standby", reg);
+            }
+
+            if((reg == 0x01) && (val & 0x01))
+            {
+                /* Register reset */
+                memset(d->regs, 0, sizeof(d->regs));
+                return;
+            }
+            break;
+
+        case CHIP_PCM1865:
+            if(!IN_SET(reg, g_pcm1865Regs))
+            {
+                ModelError(d, "register 0x%02X is not modelled", reg);
+            }
+            else if(reg == 0x00)
+            {
+                if(val == 0xFE)
+                {
+                    /* Register reset */
+                    memset(d->regs, 0, sizeof(d->regs));
+                    return;
+                }
+                if(val)
+                {
+                    ModelError(d, "page %u is not modelled", val);
+                }
+            }
+            break;
+
+        case CHIP_CS2100:
+            if(!IN_SET(reg, g_cs2100Regs))
+            {
+                ModelError(d, "register 0x%02X is not writable", reg);
+            }
+#if !defined(AUDIOHW_BOARD_EVK)
+            else if((reg >= 0x06) && (reg <= 0x09) && (val != d->regs[reg]))
+            {
+                /* New ratio, the PLL re-locks */
+                d->lockTime = g_hostTime + (unsigned long long) CS2100_MODEL_LOCK_PERIODS * XS1_TIMER_HZ / PLL_SYNC_FREQ;
+            }
+#endif
+            break;
+
+        case CHIP_CS4384:
+            /* The control port is entered by setting CPEN in Mode Control 1 */
+            if((reg < 0x02) || (reg > 0x16))
+            {
+                ModelError(d, "register 0x%02X is not writable", reg);
+            }
+            else if((reg == 0x02) && !(val & 0x80))
+            {
+                ModelError(d, "Mode Control 1 written without CPEN");
+            }
+            else if((reg != 0x02) && !(d->regs[0x02] & 0x80))
+            {
+                ModelError(d, "register 0x%02X written before CPEN", reg);
+            }
+            else if(((reg == 0x03) || (reg == 0x04)) && !(d->regs[0x02] & 0x41))
+            {
+                /* Interface format changes with the DAC frozen or powered down */
+                ModelError(d, "register 0x%02X written while running", reg);
+            }
+            break;
+
+        case CHIP_CS5368:
+            if(!IN_SET(reg, g_cs5368Regs))
+            {
+                ModelError(d, "register 0x%02X is not writable", reg);
+            }
+            else if((reg == 0x01) && !(val & 0x80))
+            {
+                ModelError(d, "Global Mode Control written without CP-EN");
+            }
+            else if((reg != 0x01) && !(d->regs[0x01] & 0x80))
+            {
+                ModelError(d, "register 0x%02X written before CP-EN", reg);
+            }
+            break;
+
+        case CHIP_AIC3204:
+            /* The page control register is register 0 of every page */
+            if(reg == 0x00)
+            {
+                if(val > 1)
+                {
+                    ModelError(d, "page %u is not modelled", val);
+                }
+                d->page = val;
+                return;
+            }
+            if(d->page == 1)
+            {
+                if(!IN_SET(reg, g_aic3204Page1Regs))
+                {
+                    ModelError(d, "page 1 register 0x%02X is not modelled", reg);
+                }
+                d->page1[reg & 0x7F] = val;
+                return;
+            }
+            if(!IN_SET(reg, g_aic3204Page0Regs))
+            {
+                ModelError(d, "register 0x%02X is not modelled", reg);
+            }
+            else if((reg == 0x01) && (val & 0x01))
+            {
+                /* Software reset */
+                Aic3204Reset(d);
+                return;
+            }
+            break;
+    }
+
+    d->regs[reg & 0x7F] = val;
+
+    if(d->chip == CHIP_AIC3204)
+    {
+        /* The converters are powered up after their clock dividers, and unmuted once powered */
+        if((AIC3204_DAC_POWERED(d) && !AIC3204_DAC_CLOCKED(d)) || (AIC3204_ADC_POWERED(d) && !AIC3204_ADC_CLOCKED(d)))
+        {
+            ModelError(d, "converter powered up without its clock dividers");
+        }
+        if(((reg == 0x40) && !(val & 0x0C) && !AIC3204_DAC_POWERED(d)) ||
+            ((reg == 0x52) && !(val & 0x88) && !AIC3204_ADC_POWERED(d)))
+        {
+            ModelError(d, "converter unmuted while powered down");
+        }
+    }
+}
+
+static uint8_t RegRead(device_t *d, unsigned reg)
+{
+#if !defined(AUDIOHW_BOARD_EVK)
+    if((d->chip == CHIP_CS2100) && (reg == CS2100_DEVICE_CONTROL))
+    {
+        return (g_hostTime < d->lockTime) ? CS2100_UNLOCK : 0;
+    }
+#endif
+    if((d->chip == CHIP_AIC3204) && (d->page == 1) && reg)
+    {
+        return d->page1[reg & 0x7F];
+    }
+    return d->regs[reg & 0x7F];
+}
+
+/* The device answering addr, NULL if none */
+static device_t *FindDevice(uint8_t addr)
+{
+    device_t *found = NULL;
+
+    for(unsigned i = 0; i < NUM_DEVICES; i++)
+    {
+        device_t *d = &g_devices[i];
+
+        if((d->addr != addr) || ((d->muxChan != NO_MUX) && (d->muxChan != g_muxChan)))
+        {
+            continue;
+        }
+        if(d->resetGpio && !(g_gpio & d->resetGpio))
+        {
+            continue;
+        }
+        if(found)
+        {
+            ModelError(d, "answers at 0x%02X with %s", addr, found->name);
+        }
+        found = d;
+    }
+    return found;
+}
+
+#if defined(AUDIOHW_BOARD_216)
+void set_gpio(unsigned bit, unsigned value)
+{
+    g_gpio = value ? (g_gpio | bit) : (g_gpio & ~bit);
+
+    /* Held in reset, registers return to defaults */
+    for(unsigned i = 0; i < NUM_DEVICES; i++)
+    {
+        if((g_devices[i].resetGpio == bit) && !value)
+        {
+            memset(g_devices[i].regs, 0, sizeof(g_devices[i].regs));
+        }
+    }
+}
+#endif
+
+/*
+ * Bus: a start (or repeated start) and stop are a bit time each, a byte is 9 with the ACK
+ */
+static unsigned g_busOpen = 0;
+static unsigned g_busBits = 0;
+static unsigned g_busBytes = 0;
+static unsigned g_transactions = 0;
+
+static void BusBits(unsigned bits)
+{
+    g_busBits += bits;
+    g_hostTime += (unsigned long long) bits * XS1_TIMER_HZ / (HOST_I2C_KBPS * 1000);
+}
+
+void HostI2cStop()
+{
+    if(!g_busOpen)
+    {
+        ModelError(NULL, "stop without a start");
+    }
+    BusBits(1);
+    g_busOpen = 0;
+    g_transactions++;
+}
+
+i2c_res_t HostI2cWrite(uint8_t addr, const uint8_t buf[], size_t n, size_t &num_bytes_sent, int send_stop_bit)
+{
+    device_t *d = FindDevice(addr);
+
+    g_busOpen = 1;
+    BusBits(1 + 9);
+    g_busBytes++;
+    num_bytes_sent = 0;
+
+    if(d)
+    {
+        for(size_t i = 0; i < n; i++)
+        {
+            if((i == 0) && (d->chip != CHIP_PCA9540B))
+            {
+                /* Register address, PCM1865 and AIC3204 always auto-increment */
+                d->incr = (d->chip == CHIP_PCM1865) || (d->chip == CHIP_AIC3204) || (buf[0] & 0x80);
+                d->ptr = buf[0] & 0x7F;
+            }
+            else
+            {
+                if((i > 1) && !d->incr)
+                {
+                    ModelError(d, "burst to 0x%02X without auto-increment", d->ptr);
+                }
+                RegWrite(d, d->ptr, buf[i]);
+                d->ptr = d->incr ? ((d->ptr + 1) & 0x7F) : d->ptr;
+            }
+        }
+        BusBits(9 * n);
+        g_busBytes += n;
+        num_bytes_sent = n;
+    }
+
+    if(send_stop_bit)
+    {
+        HostI2cStop();
+    }
+    return d ? I2C_ACK : I2C_NACK;
+}
+
+i2c_res_t HostI2cRead(uint8_t addr, uint8_t buf[], size_t n, int send_stop_bit)
+{
+    device_t *d = FindDevice(addr);
+
+    g_busOpen = 1;
+    BusBits(1 + 9);
+    g_busBytes++;
+
+    if(d)
+    {
+        for(size_t i = 0; i < n; i++)
+        {
+            buf[i] = RegRead(d, d->ptr);
+            d->ptr = d->incr ? ((d->ptr + 1) & 0x7F) : d->ptr;
+        }
+        BusBits(9 * n);
+        g_busBytes += n;
+    }
+
+    if(send_stop_bit)
+    {
+        HostI2cStop();
+    }
+    return d ? I2C_ACK : I2C_NACK;
+}
+
+/*
+ * Profile
+ */
+static unsigned g_fail = 0;
+
+static void check(const char *name, int ok)
+{
+    printf("%s: %s %s\n", ok ? "PASS" : "FAIL", AUDIOHW_PROFILE, name);
+    g_fail |= !ok;
+}
+
+typedef struct
+{
+    unsigned long long time;
+    unsigned long long waitTicks;
+    unsigned busBits;
+    unsigned busBytes;
+    unsigned transactions;
+} counters_t;
+
+static counters_t Counters()
+{
+    counters_t c = {g_hostTime, g_hostWaitTicks, g_busBits, g_busBytes, g_transactions};
+    return c;
+}
+
+/* Prints the profile line of step, from counters at its start. Returns the time it took (us) */
+static unsigned Report(const char *step, counters_t start)
+{
+    const counters_t end = Counters();
+    const unsigned bits = end.busBits - start.busBits;
+    const unsigned totalUs = (unsigned) ((end.time - start.time) / XS1_TIMER_MHZ);
+
+    printf("PROFILE %s %s kbps=%u transactions=%u bytes=%u bus_us_100k=%u bus_us_400k=%u "
+        "wait_us=%u total_us=%u\n", AUDIOHW_PROFILE, step, HOST_I2C_KBPS,
+        end.transactions - start.transactions, end.busBytes - start.busBytes, bits * 10,
+        (bits * 10 + 3) / 4, (unsigned) ((end.waitTicks - start.waitTicks) / XS1_TIMER_MHZ), totalUs);
+    return totalUs;
+}
+
+typedef struct
+{
+    const char *step;
+    unsigned samFreq;
+    unsigned dsdMode;
+} config_t;
+
+/* First configuration at start-up, then changes within and between rate families */
+static const config_t g_configs[] =
+{
+    {"44100", 44100, 0},
+    {"48000", 48000, 0},
+    {"96000", 96000, 0},
+    {"192000", 192000, 0},
+    {"44100", 44100, 0},
+    {"88200", 88200, 0},
+    {"176400", 176400, 0},
+    {"48000", 48000, 0},
+#if defined(AUDIOHW_BOARD_216)
+    {"dsd64", 2822400, DSD_MODE_NATIVE},
+    {"44100", 44100, 0},
+#endif
+};
+
+int main()
+{
+    counters_t start;
+
+#if defined(AUDIOHW_BOARD_EVK)
+    Aic3204Reset(&g_devices[0]);
+#endif
+
+    g_step = "init";
+    start = Counters();
+    AudioHwInit();
+    Report(g_step, start);
+
+#if defined(AUDIOHW_BOARD_EVK)
+    /* The audio thread unmutes the CODEC once it has seen the bring-up complete, and then sees
+     * the unmute complete */
+    g_step = "unmute";
+    start = Counters();
+    AudioHwPoll();
+    AudioHwPoll();
+    Report(g_step, start);
+    check("CODEC unmuted", (g_codecState == CODEC_STATE_READY) && AIC3204_UNMUTED(&g_devices[0]));
+#endif
+
+    for(unsigned i = 0; i < sizeof(g_configs) / sizeof(g_configs[0]); i++)
+    {
+        const config_t *c = &g_configs[i];
+        const unsigned mClk = (c->samFreq % 22050) ? MCLK_48 : MCLK_441;
+        char name[64];
+
+        g_step = c->step;
+        start = Counters();
+        AudioHwConfig(c->samFreq, mClk, c->dsdMode, 24, 24);
+        const unsigned us = Report(g_step, start);
+
+#if defined(AUDIOHW_BOARD_EVK)
+        /* The CODEC takes any rate without a change of configuration */
+        (void) us;
+        (void) name;
+#else
+        /* The application's own measurement of the configuration agrees with the model */
+        snprintf(name, sizeof(name), "%s g_audioHwCfgTicks", c->step);
+        check(name, us == g_audioHwCfgTicks / XS1_TIMER_MHZ);
+#endif
+    }
+
+    check("model errors", g_modelErrors == 0);
+#if defined(AUDIOHW_BOARD_EVK)
+    check("CODEC sequence failures", g_hostCodecFailures == 0);
+#else
+    check("CS2100 lock timeouts", g_pllLockFails == 0);
+#endif
+#if defined(AUDIOHW_BOARD_216)
+    check("codec service failures", g_audioHwFailures == 0);
+#endif
+
+    printf("%s\n", g_fail ? "FAIL" : "PASS");
+    return g_fail;
+}
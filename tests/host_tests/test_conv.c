@@ -0,0 +1,182 @@
+/* Checks conv_process() against a direct-form convolution of the same taps */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "conv.h"
+
+#define TEST_PARTS          (8)     /* Signal length in partition periods, after any load */
+#define TEST_MAX_LEN        ((CONV_MAX_TAPS * 3) + (TEST_PARTS * CONV_PART_SIZE))
+#define TEST_AMPLITUDE      (1 << 28)
+
+/* Error allowed relative to TEST_AMPLITUDE, float accumulation limits this */
+#define TEST_MAX_ERROR      (1e-5)
+
+static conv_t g_conv;
+static float g_taps[2][CONV_MAX_TAPS];
+static int32_t g_in[TEST_MAX_LEN];
+static int32_t g_out[TEST_MAX_LEN];
+
+static void make_taps(float taps[], unsigned numTaps)
+{
+    /* Decaying noise, normalised so the output cannot clip */
+    double sum = 0;
+    for(unsigned i = 0; i < numTaps; i++)
+    {
+        taps[i] = (float)(((rand() / (double) RAND_MAX) - 0.5) * exp(-3.0 * i / numTaps));
+        sum += fabs(taps[i]);
+    }
+    for(unsigned i = 0; i < numTaps; i++)
+    {
+        taps[i] /= sum;
+    }
+}
+
+/* Runs conv_process() over len samples, numFrames per call */
+static void run(unsigned start, unsigned len, unsigned numFrames)
+{
+    for(unsigned i = start; i < start + len; i += numFrames)
+    {
+        conv_process(&g_conv, &g_out[i], numFrames, 1);
+    }
+}
+
+/* Largest difference between g_out[start..start+len) and taps applied to g_in from origin
+ * (the filter state is zero before origin) */
+static double max_error(const float taps[], unsigned numTaps, unsigned origin, unsigned start, unsigned len)
+{
+    double maxErr = 0;
+
+    for(unsigned n = start; n < start + len; n++)
+    {
+        double y = 0;
+        for(unsigned k = 0; (k < numTaps) && (k <= (n - origin)); k++)
+        {
+            y += (double) taps[k] * g_in[n - k];
+        }
+
+        double err = fabs(y - g_out[n]) / TEST_AMPLITUDE;
+        if(err > maxErr)
+        {
+            maxErr = err;
+        }
+    }
+    return maxErr;
+}
+
+static void make_input(unsigned len)
+{
+    for(unsigned i = 0; i < len; i++)
+    {
+        g_in[i] = (int32_t)(((rand() / (double) RAND_MAX) - 0.5) * 2 * TEST_AMPLITUDE);
+        g_out[i] = g_in[i];
+    }
+}
+
+static int test_taps(unsigned numTaps, unsigned numFrames)
+{
+    const unsigned len = numTaps + (TEST_PARTS * CONV_PART_SIZE);
+    unsigned origin = 0;
+    unsigned loadPeriods = 0;
+
+    make_taps(g_taps[0], numTaps);
+    make_input(TEST_MAX_LEN);
+
+    conv_init(&g_conv);
+    conv_load(&g_conv, g_taps[0], numTaps);
+
+    /* Load takes effect at a partition boundary, output is from silence at that point */
+    while(conv_loading(&g_conv))
+    {
+        run(origin, CONV_PART_SIZE, numFrames);
+        origin += CONV_PART_SIZE;
+        loadPeriods++;
+    }
+    run(origin, len, numFrames);
+
+    double err = max_error(g_taps[0], numTaps, origin, origin, len);
+    int fail = (err > TEST_MAX_ERROR) || (loadPeriods > 2);
+    printf("%s: taps=%u frames_per_call=%u load_periods=%u max_error=%g\n",
+        fail ? "FAIL" : "PASS", numTaps, numFrames, loadPeriods, err);
+    return fail;
+}
+
+/* Swaps to a second filter while running and checks the mute and the new response */
+static int test_reload(unsigned numTaps, unsigned numFrames)
+{
+    const unsigned len = numTaps + (TEST_PARTS * CONV_PART_SIZE);
+    unsigned origin = 0;
+    int fail = 0;
+
+    make_taps(g_taps[0], numTaps);
+    make_taps(g_taps[1], numTaps);
+    make_input(TEST_MAX_LEN);
+
+    conv_init(&g_conv);
+
+    /* Pass-through until loaded */
+    run(0, CONV_PART_SIZE, numFrames);
+    fail |= (max_error((const float[]){1.0f}, 1, 0, 0, CONV_PART_SIZE) > TEST_MAX_ERROR);
+    origin += CONV_PART_SIZE;
+
+    conv_load(&g_conv, g_taps[0], numTaps);
+    while(conv_loading(&g_conv))
+    {
+        run(origin, CONV_PART_SIZE, numFrames);
+        origin += CONV_PART_SIZE;
+    }
+    const unsigned firstOrigin = origin;
+    run(origin, len, numFrames);
+    origin += len;
+
+    /* Request mid-period, the old filter runs to the end of the period */
+    const unsigned reqAt = origin + numFrames;
+    run(origin, numFrames, numFrames);
+    conv_load(&g_conv, g_taps[1], numTaps);
+    origin += numFrames;
+    while(conv_loading(&g_conv))
+    {
+        run(origin, numFrames, numFrames);
+        origin += numFrames;
+    }
+
+    const unsigned periodEnd = ((reqAt + CONV_PART_SIZE - 1) / CONV_PART_SIZE) * CONV_PART_SIZE;
+    double errOld = max_error(g_taps[0], numTaps, firstOrigin, reqAt - numFrames, periodEnd - reqAt + numFrames);
+    for(unsigned i = periodEnd; i < origin; i++)
+    {
+        fail |= (g_out[i] != 0);
+    }
+
+    run(origin, len, numFrames);
+    double errNew = max_error(g_taps[1], numTaps, origin, origin, len);
+
+    fail |= (errOld > TEST_MAX_ERROR) || (errNew > TEST_MAX_ERROR) || ((origin - periodEnd) != CONV_PART_SIZE);
+    printf("%s: reload taps=%u frames_per_call=%u mute=%u max_error_old=%g max_error_new=%g\n",
+        fail ? "FAIL" : "PASS", numTaps, numFrames, origin - periodEnd, errOld, errNew);
+    return fail;
+}
+
+int main()
+{
+    const unsigned numTaps[] = {1, 100, CONV_HEAD_TAPS, CONV_HEAD_TAPS + 1, 1000, 4096, 16384};
+    const unsigned numFrames[] = {1, 4, CONV_PART_SIZE};
+    int fail = 0;
+
+    srand(1);
+
+    for(unsigned t = 0; t < sizeof(numTaps) / sizeof(numTaps[0]); t++)
+    {
+        for(unsigned f = 0; f < sizeof(numFrames) / sizeof(numFrames[0]); f++)
+        {
+            if(numTaps[t] <= CONV_MAX_TAPS)
+            {
+                fail |= test_taps(numTaps[t], numFrames[f]);
+            }
+        }
+    }
+
+    fail |= test_reload(1000, 4);
+    fail |= test_reload(4096, 16);
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
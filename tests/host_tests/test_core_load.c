@@ -0,0 +1,174 @@
+/* Checks the core load profiler against cores with known busy patterns: work at the frame and
+ * block rates (including a period equal to the mean sample interval, which fixed interval
+ * sampling would alias to 0 or 100%), bursts longer than a sample, always busy, never busy and
+ * uninstrumented cores. Then the free fraction of the tile from the counts of the polling loop */
+#include <stdio.h>
+#include <stdlib.h>
+#include "core_load.h"
+
+#define TEST_SECONDS            (5)
+#define TEST_TICKS_PER_SEC      (100000000)
+
+/* Largest error of a window load, and of the average over the whole run, in 1/1000 */
+#define TEST_MAX_WINDOW_ERR     (25)
+#define TEST_MAX_AVG_ERR        (5)
+
+typedef struct
+{
+    const char *name;
+    unsigned period;            /* Ticks, 0 for the same state throughout */
+    unsigned busyTicks;         /* Busy at the start of each period */
+    unsigned load;              /* Expected, 1/1000 */
+} pattern_t;
+
+/* Core 5 upwards are not instrumented */
+#define TEST_NUM_CORES          (5)
+
+static const pattern_t g_patterns[TEST_NUM_CORES] =
+{
+    {"frame rate 48kHz", 2083, 833, 400},
+    {"sample interval", CORE_LOAD_SAMPLE_TICKS, 300, 300},
+    {"block rate 4 frames", 8333, 6250, 750},
+    {"always busy", 0, 1, 1000},
+    {"never busy", 0, 0, 0},
+};
+
+/* Bursts of 10ms every 30ms, a window load depends on where its ends fall */
+static const pattern_t g_burst = {"bursts", 3000000, 1000000, 333};
+
+static int check(const char *name, int ok)
+{
+    printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+    return !ok;
+}
+
+static unsigned busy_at(const pattern_t *p, unsigned long long t)
+{
+    if(p->period == 0)
+    {
+        return p->busyTicks != 0;
+    }
+    return (t % p->period) < p->busyTicks;
+}
+
+int main()
+{
+    unsigned report[CORE_LOAD_REPORT_WORDS];
+    unsigned maxErr[TEST_NUM_CORES] = {0};
+    unsigned burstMin = 1000, burstMax = 0;
+    unsigned intervalMin = ~0u, intervalMax = 0;
+    unsigned long long t = 0;
+    unsigned long long intervals = 0;
+    unsigned windows = 0;
+    int fail = 0;
+    char s[128];
+
+    CoreLoadReset();
+
+    while(t < (unsigned long long) TEST_SECONDS * TEST_TICKS_PER_SEC)
+    {
+        for(unsigned i = 0; i < TEST_NUM_CORES; i++)
+        {
+            if(busy_at(&g_patterns[i], t))
+                CoreLoadBusy(i);
+            else
+                CoreLoadIdle(i);
+        }
+
+        if(busy_at(&g_burst, t))
+            CoreLoadBusy(TEST_NUM_CORES);
+        else
+            CoreLoadIdle(TEST_NUM_CORES);
+
+        if(CoreLoadSample())
+        {
+            windows++;
+            CoreLoadReport(report);
+
+            for(unsigned i = 0; i < TEST_NUM_CORES; i++)
+            {
+                const int err = abs((int) report[CORE_LOAD_REPORT_LAST(i)] - (int) g_patterns[i].load);
+                if(err > maxErr[i])
+                    maxErr[i] = err;
+            }
+
+            const unsigned burst = report[CORE_LOAD_REPORT_LAST(TEST_NUM_CORES)];
+            if(burst < burstMin)
+                burstMin = burst;
+            if(burst > burstMax)
+                burstMax = burst;
+        }
+
+        const unsigned interval = CoreLoadInterval();
+        if(interval < intervalMin)
+            intervalMin = interval;
+        if(interval > intervalMax)
+            intervalMax = interval;
+        intervals++;
+        t += interval;
+    }
+
+    CoreLoadReport(report);
+
+    for(unsigned i = 0; i < TEST_NUM_CORES; i++)
+    {
+        const unsigned avg = report[CORE_LOAD_REPORT_AVG(i)];
+
+        printf("%s: expected %u, average %u, peak %u, largest window error %u\n", g_patterns[i].name,
+            g_patterns[i].load, avg, report[CORE_LOAD_REPORT_PEAK(i)], maxErr[i]);
+
+        snprintf(s, sizeof(s), "%s window", g_patterns[i].name);
+        fail |= check(s, maxErr[i] <= TEST_MAX_WINDOW_ERR);
+        snprintf(s, sizeof(s), "%s average", g_patterns[i].name);
+        fail |= check(s, abs((int) avg - (int) g_patterns[i].load) <= TEST_MAX_AVG_ERR);
+    }
+
+    /* A 100ms window holds three or four bursts of 10ms: 30% to 40% */
+    printf("%s: average %u, windows %u to %u, peak %u\n", g_burst.name,
+        report[CORE_LOAD_REPORT_AVG(TEST_NUM_CORES)], burstMin, burstMax, report[CORE_LOAD_REPORT_PEAK(TEST_NUM_CORES)]);
+    fail |= check("bursts average", abs((int) report[CORE_LOAD_REPORT_AVG(TEST_NUM_CORES)] - (int) g_burst.load) <= TEST_MAX_AVG_ERR);
+    fail |= check("bursts windows", (burstMin >= 300 - TEST_MAX_WINDOW_ERR) && (burstMax <= 400 + TEST_MAX_WINDOW_ERR));
+    fail |= check("bursts peak", report[CORE_LOAD_REPORT_PEAK(TEST_NUM_CORES)] == burstMax);
+
+    fail |= check("always busy peak", report[CORE_LOAD_REPORT_PEAK(3)] == 1000);
+    fail |= check("instrumented mask", report[CORE_LOAD_REPORT_MASK] == ((1 << (TEST_NUM_CORES + 1)) - 1));
+
+    /* The window length is CORE_LOAD_WINDOW_MS on average */
+    printf("windows %u, intervals %u to %u, mean %.1f ticks\n", windows, intervalMin, intervalMax,
+        (double) t / intervals);
+    fail |= check("window count", report[CORE_LOAD_REPORT_WINDOWS] == windows);
+    fail |= check("window length", abs((int) windows - (TEST_SECONDS * 1000 / CORE_LOAD_WINDOW_MS)) <= 1);
+    fail |= check("interval range", (intervalMin >= CORE_LOAD_SAMPLE_TICKS / 2)
+        && (intervalMax < (3 * CORE_LOAD_SAMPLE_TICKS) / 2));
+
+    /* An idle tile, then five eighths of its rate: eight active cores. The windows are a little
+     * apart in length, as the sample intervals are random */
+    CoreLoadReset();
+    CoreLoadCount(1200000, 10000000);
+    CoreLoadCount(760000, 10130000);
+    CoreLoadReport(report);
+    printf("idle rate %u, rate %u, free last %u, lowest %u, average %u\n", report[CORE_LOAD_REPORT_IDLE_RATE],
+        report[CORE_LOAD_REPORT_RATE], report[CORE_LOAD_REPORT_FREE_LAST], report[CORE_LOAD_REPORT_FREE_MIN],
+        report[CORE_LOAD_REPORT_FREE_AVG]);
+    fail |= check("idle rate", report[CORE_LOAD_REPORT_IDLE_RATE] == 12000);
+    fail |= check("free last", abs((int) report[CORE_LOAD_REPORT_FREE_LAST] - 625) <= 1);
+    fail |= check("free lowest", report[CORE_LOAD_REPORT_FREE_MIN] == report[CORE_LOAD_REPORT_FREE_LAST]);
+    fail |= check("free average", abs((int) report[CORE_LOAD_REPORT_FREE_AVG] - 811) <= 1);
+
+    /* A faster window recalibrates, and the idle rate outlives a reset */
+    CoreLoadCount(1250000, 10000000);
+    CoreLoadReset();
+    CoreLoadReport(report);
+    fail |= check("recalibrate", (report[CORE_LOAD_REPORT_IDLE_RATE] == 12500) && (report[CORE_LOAD_REPORT_FREE_AVG] == 0));
+    CoreLoadCount(1200000, 10000000);
+    CoreLoadReport(report);
+    fail |= check("free against idle rate", report[CORE_LOAD_REPORT_FREE_LAST] == 960);
+
+    CoreLoadReset();
+    CoreLoadReport(report);
+    fail |= check("reset", (report[CORE_LOAD_REPORT_WINDOWS] == 0) && (report[CORE_LOAD_REPORT_PEAK(3)] == 0)
+        && (report[CORE_LOAD_REPORT_AVG(0)] == 0) && (report[CORE_LOAD_REPORT_MASK] != 0));
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
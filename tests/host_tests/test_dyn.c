@@ -0,0 +1,279 @@
+/* Checks the compressor/limiter: the ceiling holds for any input, the latency, the compressor
+ * static curve and channel linking */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "dynamics.h"
+
+#define TEST_CHANS          (4)
+#define TEST_FRAMES         (48000)
+#define TEST_SAMP_FREQ      (48000)
+
+/* Compressor static curve error allowed */
+#define TEST_MAX_CURVE_DB   (0.05)
+
+/* Limiter settled level error allowed, below the ceiling */
+#define TEST_MAX_LIMIT_DB   (0.2)
+
+static dyn_t g_dyn;
+static int32_t g_in[TEST_FRAMES][TEST_CHANS];
+static int32_t g_out[TEST_FRAMES][TEST_CHANS];
+
+static double level_db(double x)
+{
+    return 20.0 * log10(fabs(x) / 2147483648.0);
+}
+
+static int32_t from_db(double db)
+{
+    const double x = pow(10.0, db / 20.0) * 2147483648.0;
+    return (x >= 2147483647.0) ? INT32_MAX : (int32_t) lround(x);
+}
+
+static double rand_unit()
+{
+    return (rand() / (double) RAND_MAX) * 2.0 - 1.0;
+}
+
+static void set_params(int threshold, int ratio, int makeup, int ceiling, int link)
+{
+    dyn_set_param(&g_dyn, DYN_PARAM_COMP_THRESHOLD, threshold);
+    dyn_set_param(&g_dyn, DYN_PARAM_COMP_RATIO, ratio);
+    dyn_set_param(&g_dyn, DYN_PARAM_COMP_MAKEUP, makeup);
+    dyn_set_param(&g_dyn, DYN_PARAM_LIM_CEILING, ceiling);
+    dyn_set_param(&g_dyn, DYN_PARAM_LINK, link);
+}
+
+/* Runs g_in through, numFrames per call */
+static void run(unsigned numFrames)
+{
+    for(unsigned f = 0; f < TEST_FRAMES; f++)
+    {
+        for(unsigned ch = 0; ch < TEST_CHANS; ch++)
+        {
+            g_out[f][ch] = g_in[f][ch];
+        }
+    }
+
+    for(unsigned f = 0; f < TEST_FRAMES; f += numFrames)
+    {
+        dyn_process(&g_dyn, &g_out[f][0], numFrames, TEST_CHANS);
+    }
+}
+
+/* Full scale noise with loud bursts and single sample spikes, output must never pass the
+ * ceiling and must get close to it once a steady level is reached */
+static int test_ceiling(int ceiling, int makeup, int link, unsigned numFrames)
+{
+    const int32_t limit = from_db(ceiling / 256.0);
+    int32_t peak = 0;
+    int fail = 0;
+
+    for(unsigned f = 0; f < TEST_FRAMES; f++)
+    {
+        for(unsigned ch = 0; ch < TEST_CHANS; ch++)
+        {
+            double x = rand_unit() * ((((f / 1000) % 3) == 0) ? 1.0 : 0.1);
+            if((rand() % 500) == 0)
+            {
+                x = (x < 0) ? -1.0 : 1.0;
+            }
+            /* Ends in a steady +6dB square wave for the settled level */
+            if(f >= (TEST_FRAMES - 4800))
+            {
+                x = ((f / 24) & 1) ? 1.0 : -1.0;
+            }
+            g_in[f][ch] = (x >= 1.0) ? INT32_MAX : (int32_t)(x * 2147483648.0);
+        }
+    }
+
+    dyn_init(&g_dyn, TEST_CHANS, TEST_SAMP_FREQ);
+    set_params(0, 100, makeup, ceiling, link);
+    run(numFrames);
+
+    for(unsigned f = 0; f < TEST_FRAMES; f++)
+    {
+        for(unsigned ch = 0; ch < TEST_CHANS; ch++)
+        {
+            const int32_t a = abs(g_out[f][ch]);
+            fail |= (a > limit);
+            peak = (a > peak) ? a : peak;
+        }
+    }
+
+    /* Settled level, in the last 10ms */
+    int32_t settled = 0;
+    for(unsigned f = TEST_FRAMES - 480; f < TEST_FRAMES; f++)
+    {
+        const int32_t a = abs(g_out[f][0]);
+        settled = (a > settled) ? a : settled;
+    }
+    const double settledErr = (ceiling / 256.0) - level_db(settled);
+    fail |= (settledErr > TEST_MAX_LIMIT_DB);
+
+    printf("%s: ceiling ceiling_db=%.2f makeup_db=%.2f link=%d frames_per_call=%u peak_db=%.3f settled_below_db=%.3f\n",
+        fail ? "FAIL" : "PASS", ceiling / 256.0, makeup / 256.0, link, numFrames, level_db(peak), settledErr);
+    return fail;
+}
+
+/* Below threshold and ceiling the output is the input, delayed by exactly DYN_LATENCY_FRAMES */
+static int test_latency(unsigned numFrames)
+{
+    int fail = 0;
+
+    for(unsigned f = 0; f < TEST_FRAMES; f++)
+    {
+        for(unsigned ch = 0; ch < TEST_CHANS; ch++)
+        {
+            g_in[f][ch] = (int32_t)(rand_unit() * 0.25 * 2147483648.0);
+        }
+    }
+
+    dyn_init(&g_dyn, TEST_CHANS, TEST_SAMP_FREQ);
+    set_params(0, 400, 0, 0, 1);
+    run(numFrames);
+
+    for(unsigned f = 0; f < TEST_FRAMES; f++)
+    {
+        for(unsigned ch = 0; ch < TEST_CHANS; ch++)
+        {
+            const int32_t expected = (f >= DYN_LATENCY_FRAMES) ? g_in[f - DYN_LATENCY_FRAMES][ch] : 0;
+            fail |= (g_out[f][ch] != expected);
+        }
+    }
+
+    printf("%s: latency frames=%d frames_per_call=%u\n", fail ? "FAIL" : "PASS", DYN_LATENCY_FRAMES, numFrames);
+    return fail;
+}
+
+/* Steady level in, settled level out must follow threshold + (level - threshold) / ratio + makeup */
+static int test_curve(int threshold, int ratio, int makeup)
+{
+    const double levels[] = {-40.0, -24.0, -18.0, -12.0, -6.0, -3.0};
+    double maxErr = 0;
+
+    for(unsigned l = 0; l < sizeof(levels) / sizeof(levels[0]); l++)
+    {
+        const int32_t x = from_db(levels[l]);
+
+        for(unsigned f = 0; f < TEST_FRAMES; f++)
+        {
+            for(unsigned ch = 0; ch < TEST_CHANS; ch++)
+            {
+                g_in[f][ch] = x;
+            }
+        }
+
+        dyn_init(&g_dyn, TEST_CHANS, TEST_SAMP_FREQ);
+        set_params(threshold, ratio, makeup, 0, 0);
+        run(4);
+
+        const double t = threshold / 256.0;
+        double expected = levels[l];
+        if(levels[l] > t)
+        {
+            expected = t + ((levels[l] - t) * 100.0 / ratio);
+        }
+        expected += makeup / 256.0;
+
+        /* Limiter is at 0dB, stay clear of it */
+        if(expected > -0.5)
+        {
+            continue;
+        }
+
+        const double err = fabs(level_db(g_out[TEST_FRAMES - 1][0]) - expected);
+        maxErr = (err > maxErr) ? err : maxErr;
+    }
+
+    const int fail = (maxErr > TEST_MAX_CURVE_DB);
+    printf("%s: curve threshold_db=%.2f ratio=%.2f makeup_db=%.2f max_error_db=%.4f\n",
+        fail ? "FAIL" : "PASS", threshold / 256.0, ratio / 100.0, makeup / 256.0, maxErr);
+    return fail;
+}
+
+/* A loud channel 0 with a quiet channel 1: linked they get the same gain, unlinked channel 1
+ * is untouched */
+static int test_link(int link)
+{
+    int fail = 0;
+
+    for(unsigned f = 0; f < TEST_FRAMES; f++)
+    {
+        const double s = sin(2.0 * M_PI * 1000.0 * f / TEST_SAMP_FREQ);
+        g_in[f][0] = (int32_t)(s * 0.9 * 2147483648.0);
+        g_in[f][1] = (int32_t)(s * 0.01 * 2147483648.0);
+        g_in[f][2] = 0;
+        g_in[f][3] = 0;
+    }
+
+    dyn_init(&g_dyn, TEST_CHANS, TEST_SAMP_FREQ);
+    set_params(-20 * 256, 400, 0, -6 * 256, link);
+    run(4);
+
+    double maxDiff = 0;
+    for(unsigned f = TEST_FRAMES / 2; f < TEST_FRAMES; f++)
+    {
+        const int32_t *in = g_in[f - DYN_LATENCY_FRAMES];
+
+        if(abs(in[1]) < (1 << 22))
+        {
+            continue;
+        }
+
+        const double g1 = (double) g_out[f][1] / in[1];
+        const double diff = link ? fabs(g1 - ((double) g_out[f][0] / in[0])) : fabs(g1 - 1.0);
+        maxDiff = (diff > maxDiff) ? diff : maxDiff;
+    }
+
+    fail = (maxDiff > 0.01);
+    printf("%s: link=%d max_gain_diff=%.5f\n", fail ? "FAIL" : "PASS", link, maxDiff);
+    return fail;
+}
+
+static int test_params()
+{
+    int value = 0;
+    int fail = 0;
+
+    dyn_init(&g_dyn, TEST_CHANS, TEST_SAMP_FREQ);
+
+    fail |= !dyn_set_param(&g_dyn, DYN_PARAM_COMP_RATIO, 100000);
+    fail |= !dyn_get_param(&g_dyn, DYN_PARAM_COMP_RATIO, &value) || (value != 2000);
+    fail |= !dyn_set_param(&g_dyn, DYN_PARAM_LIM_CEILING, 256);
+    fail |= !dyn_get_param(&g_dyn, DYN_PARAM_LIM_CEILING, &value) || (value != 0);
+    fail |= dyn_set_param(&g_dyn, DYN_NUM_PARAMS, 0);
+    fail |= dyn_get_param(&g_dyn, DYN_NUM_PARAMS, &value);
+
+    printf("%s: params\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
+
+int main()
+{
+    const unsigned numFrames[] = {1, 4, 16};
+    int fail = 0;
+
+    srand(1);
+
+    for(unsigned i = 0; i < sizeof(numFrames) / sizeof(numFrames[0]); i++)
+    {
+        fail |= test_latency(numFrames[i]);
+        fail |= test_ceiling(-256, 0, 1, numFrames[i]);
+        fail |= test_ceiling(-256, 0, 0, numFrames[i]);
+    }
+    fail |= test_ceiling(0, 12 * 256, 1, 4);
+    fail |= test_ceiling(-12 * 256, 18 * 256, 0, 4);
+
+    fail |= test_curve(-20 * 256, 400, 0);
+    fail |= test_curve(-12 * 256, 200, 6 * 256);
+    fail |= test_curve(-30 * 256, 1000, 0);
+
+    fail |= test_link(1);
+    fail |= test_link(0);
+
+    fail |= test_params();
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,234 @@
+/* Checks the event trace rings: merging the threads of a tile into time order, ring wrap, the
+ * read limit, timer wrap and a thread writing over the events being read */
+#include <stdio.h>
+
+/* Simulated reference timer and hardware thread */
+static unsigned g_time;
+static unsigned g_thread;
+
+/* Called at each barrier, see test_overwrite() */
+static void (*g_barrierHook)(void);
+
+static void barrier()
+{
+    if(g_barrierHook)
+    {
+        g_barrierHook();
+    }
+}
+
+#define EVENT_TRACE_ENABLE          (1)
+#define EVENT_TRACE_TIME()          (g_time)
+#define EVENT_TRACE_THREAD()        (g_thread)
+#define EVENT_TRACE_BARRIER()       barrier()
+#define EVENT_TRACE_DEFINE
+#include "../../shared/event_trace.h"
+
+#define N                           (EVENT_TRACE_RING_EVENTS)
+#define MAX_EVENTS                  (EVENT_TRACE_THREADS * N)
+
+static unsigned g_events[2 * MAX_EVENTS];
+static unsigned g_now;
+static unsigned g_total;
+
+static int check(const char *name, int ok)
+{
+    printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+    return !ok;
+}
+
+static void record(unsigned thread, unsigned time, unsigned event, unsigned arg)
+{
+    g_thread = thread;
+    g_time = time;
+    EventTrace(event, arg);
+}
+
+static unsigned read_events(unsigned max)
+{
+    return EventTraceRead(g_events, max, &g_now, &g_total);
+}
+
+/* Events are oldest first, relative to the time of the read */
+static int in_order(unsigned n)
+{
+    for(unsigned i = 1; i < n; i++)
+    {
+        if((g_now - g_events[2 * i]) > (g_now - g_events[2 * (i - 1)]))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Threads 0 to 2 interleaved, each event's arg is its time so the pairs can be checked */
+static int test_merge()
+{
+    int fail = 0;
+    unsigned n, ok = 1;
+
+    record(1, 1000, EVENT_TRACE_HW_CONFIG, 1000);
+    record(0, 1100, EVENT_TRACE_STREAM_START, 1100);
+    record(2, 1200, EVENT_TRACE_HID, 1200);
+    record(1, 1300, EVENT_TRACE_HW_CONFIG_DONE, 1300);
+    record(0, 1400, EVENT_TRACE_STREAM_STOP, 1400);
+    record(2, 1500, EVENT_TRACE_HID, 1500);
+
+    g_time = 2000;
+    n = read_events(MAX_EVENTS);
+
+    fail |= check("merge count", n == 6);
+    fail |= check("merge total", g_total == 6);
+    fail |= check("merge now", g_now == 2000);
+    for(unsigned i = 0; i < n; i++)
+    {
+        ok &= (g_events[2 * i] == 1000 + (100 * i)) && (EVENT_TRACE_ARG(g_events[(2 * i) + 1]) == g_events[2 * i]);
+    }
+    fail |= check("merge order", ok && in_order(n));
+    fail |= check("merge event ids", (EVENT_TRACE_EVENT(g_events[1]) == EVENT_TRACE_HW_CONFIG)
+        && (EVENT_TRACE_EVENT(g_events[11]) == EVENT_TRACE_HID));
+
+    /* The newest events when over the limit */
+    n = read_events(4);
+    fail |= check("limit count", n == 4);
+    fail |= check("limit newest", (g_events[0] == 1200) && (g_events[6] == 1500));
+
+    return fail;
+}
+
+/* Thread 3 records more than its ring holds */
+static int test_wrap()
+{
+    int fail = 0;
+    unsigned n, ok = 1;
+
+    for(unsigned i = 0; i < 3 * N; i++)
+    {
+        record(3, 10000 + i, EVENT_TRACE_PLL_SLIP, i);
+    }
+
+    g_time = 20000;
+    n = read_events(MAX_EVENTS);
+
+    /* Threads 0 to 2 from test_merge() and the last N - 1 of thread 3 */
+    fail |= check("wrap count", n == 6 + (N - 1));
+    fail |= check("wrap total", g_total == 6 + (3 * N));
+    for(unsigned i = 0; i < N - 1; i++)
+    {
+        const unsigned *e = &g_events[2 * (6 + i)];
+        ok &= (e[0] == 10000 + (2 * N) + 1 + i) && (EVENT_TRACE_ARG(e[1]) == (2 * N) + 1 + i);
+    }
+    fail |= check("wrap newest kept", ok && in_order(n));
+
+    return fail;
+}
+
+/* Events either side of the timer wrapping, read after it */
+static int test_timer_wrap()
+{
+    int fail = 0;
+    unsigned n;
+
+    record(4, 0xFFFFFF00, EVENT_TRACE_SUSPEND, 0);
+    record(5, 0xFFFFFFF0, EVENT_TRACE_RESUME, 0);
+    record(4, 0x00000010, EVENT_TRACE_STREAM_START, 0);
+
+    g_time = 0x00000100;
+    n = read_events(3);
+
+    fail |= check("timer wrap count", n == 3);
+    fail |= check("timer wrap order", (g_events[0] == 0xFFFFFF00) && (g_events[2] == 0xFFFFFFF0)
+        && (g_events[4] == 0x00000010));
+
+    return fail;
+}
+
+/* Thread 6 writes while its ring is being read: after the read has taken the ring's head, before
+ * it copies the ring */
+#define OVERWRITE_THREAD            (6)
+#define OVERWRITE_TIME              (0x100000)
+
+static unsigned g_barriers;
+static unsigned g_overwrite;
+
+static void overwrite_hook()
+{
+    /* Two barriers per thread in EventTraceRead(), the first after reading the head */
+    if(g_barriers++ == (2 * OVERWRITE_THREAD))
+    {
+        const unsigned now = g_time;
+
+        g_barrierHook = 0;
+        for(unsigned i = 0; i < g_overwrite; i++)
+        {
+            record(OVERWRITE_THREAD, OVERWRITE_TIME + N + i, EVENT_TRACE_PLL_LOCK, N + i);
+        }
+        g_thread = 0;
+        g_time = now;
+        g_barrierHook = overwrite_hook;
+    }
+}
+
+static int test_overwrite()
+{
+    int fail = 0;
+    char s[64];
+
+    for(g_overwrite = 0; g_overwrite <= N; g_overwrite++)
+    {
+        unsigned n, found = 0, ok = 1;
+
+        /* Fill the ring afresh, arg is the event's position in the thread */
+        for(unsigned i = 0; i < N; i++)
+        {
+            record(OVERWRITE_THREAD, OVERWRITE_TIME + i, EVENT_TRACE_PLL_LOCK, i);
+        }
+
+        g_time = OVERWRITE_TIME + (4 * N);
+        g_barriers = 0;
+        g_barrierHook = overwrite_hook;
+        n = read_events(MAX_EVENTS);
+        g_barrierHook = 0;
+
+        /* Only the events written before the read, each intact */
+        for(unsigned i = 0; i < n; i++)
+        {
+            const unsigned *e = &g_events[2 * i];
+            if(EVENT_TRACE_EVENT(e[1]) == EVENT_TRACE_PLL_LOCK)
+            {
+                ok &= (e[0] == OVERWRITE_TIME + EVENT_TRACE_ARG(e[1])) && (EVENT_TRACE_ARG(e[1]) < N);
+                found++;
+            }
+        }
+
+        /* The first write goes to the free slot after the head, but the thread may then be part
+         * way through the next, so each write costs the oldest event */
+        const unsigned expected = (g_overwrite < N - 1) ? (N - 1 - g_overwrite) : 0;
+        snprintf(s, sizeof(s), "overwrite %u during read", g_overwrite);
+        fail |= check(s, ok && (found == expected) && in_order(n));
+
+        /* Start each pass from an empty ring of thread 6, the others keep their events */
+        for(unsigned i = 0; i < N; i++)
+        {
+            g_eventTrace[OVERWRITE_THREAD][i][0] = 0;
+            g_eventTrace[OVERWRITE_THREAD][i][1] = 0;
+        }
+        g_eventTraceHead[OVERWRITE_THREAD] = 0;
+    }
+
+    return fail;
+}
+
+int main()
+{
+    int fail = 0;
+
+    fail |= test_merge();
+    fail |= test_wrap();
+    fail |= test_timer_wrap();
+    fail |= test_overwrite();
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,132 @@
+/* Checks the latency stages: a marker from the host through each stage in order, only the first
+ * marker after arming, low bits ignored, the firmware's marker, and clearing on restart */
+#include <stdio.h>
+#include "latency.h"
+
+/* Reference timer, see xua_conf.h */
+unsigned g_testTime;
+
+#define CHANS   (4)
+
+/* Frames of silence in both directions between the audio thread and I2S, a marker sent to I2S
+ * comes back after this many frames */
+#define LOOP_FRAMES (3)
+
+static unsigned g_loop[LOOP_FRAMES];
+static unsigned g_loopPos;
+
+static int check(const char *name, int ok)
+{
+    printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+    return !ok;
+}
+
+static void restart(unsigned fs)
+{
+    for(unsigned i = 0; i < LOOP_FRAMES; i++)
+    {
+        g_loop[i] = 0;
+    }
+    g_loopPos = 0;
+    LatencySetSampFreq(fs);
+}
+
+/* One frame through the hooks, as UserBufferManagement() calls them, with the host's sample
+ * on LATENCY_CHAN. The samples to I2S return through the loop */
+static void frame(unsigned fromHost)
+{
+    unsigned out[CHANS] = {0};
+    unsigned in[CHANS] = {0};
+
+    g_testTime += 2083;
+    out[LATENCY_CHAN] = fromHost;
+    in[LATENCY_CHAN] = g_loop[g_loopPos];
+
+    LatencyFrameIn(out, in);
+    LatencyFrameOut(out, in);
+
+    g_loop[g_loopPos] = out[LATENCY_CHAN];
+    g_loopPos = (g_loopPos + 1) % LOOP_FRAMES;
+}
+
+static void frames(unsigned n)
+{
+    for(unsigned i = 0; i < n; i++)
+    {
+        frame(0);
+    }
+}
+
+static unsigned g_report[LATENCY_REPORT_WORDS];
+
+static unsigned seen()
+{
+    LatencyReport(g_report);
+    return g_report[LATENCY_REPORT_SEEN];
+}
+
+static unsigned stage(unsigned s)
+{
+    return g_report[LATENCY_REPORT_FRAME(s)];
+}
+
+#define ALL_STAGES  ((1 << LATENCY_NUM_STAGES) - 1)
+
+int main()
+{
+    int fail = 0;
+
+    restart(48000);
+    frames(10);
+    fail |= check("nothing seen", (seen() == 0) && (g_report[LATENCY_REPORT_SAMFREQ] == 48000));
+
+    /* A marker from the host, low bits of a 32-bit stream set */
+    LatencyArm(0);
+    frames(5);
+    frame(LATENCY_MARKER | 0x7F);
+    frames(LOOP_FRAMES - 1);
+    fail |= check("out stages", seen() == ((1 << LATENCY_STAGE_USB_OUT) | (1 << LATENCY_STAGE_I2S_OUT)));
+    frame(0);
+    fail |= check("all stages", seen() == ALL_STAGES);
+    fail |= check("frames", (stage(LATENCY_STAGE_USB_OUT) == 16) && (stage(LATENCY_STAGE_I2S_OUT) == 16)
+        && (stage(LATENCY_STAGE_I2S_IN) == 16 + LOOP_FRAMES) && (stage(LATENCY_STAGE_USB_IN) == 16 + LOOP_FRAMES));
+    fail |= check("time", g_report[LATENCY_REPORT_TIME(LATENCY_STAGE_I2S_IN)]
+        - g_report[LATENCY_REPORT_TIME(LATENCY_STAGE_I2S_OUT)] == LOOP_FRAMES * 2083);
+
+    /* A second marker is not recorded until armed again */
+    frame(LATENCY_MARKER);
+    frames(LOOP_FRAMES);
+    fail |= check("first marker only", (seen() == ALL_STAGES) && (stage(LATENCY_STAGE_USB_OUT) == 16));
+
+    /* Near misses */
+    LatencyArm(0);
+    frame(LATENCY_MARKER ^ 0x100);
+    frame(LATENCY_MARKER >> 1);
+    frames(LOOP_FRAMES);
+    fail |= check("not a marker", seen() == 0);
+
+    /* Inserted by the firmware, after the audio thread's next frame: not from USB */
+    LatencyArm(1);
+    frame(0);
+    fail |= check("injected", seen() == (1 << LATENCY_STAGE_I2S_OUT));
+    frames(LOOP_FRAMES);
+    fail |= check("injected loop", (seen() == ((1 << LATENCY_STAGE_I2S_OUT) | (1 << LATENCY_STAGE_I2S_IN)
+        | (1 << LATENCY_STAGE_USB_IN))) && (stage(LATENCY_STAGE_I2S_IN) - stage(LATENCY_STAGE_I2S_OUT) == LOOP_FRAMES));
+    frames(LOOP_FRAMES * 2);
+    fail |= check("injected once", stage(LATENCY_STAGE_I2S_IN) - stage(LATENCY_STAGE_I2S_OUT) == LOOP_FRAMES);
+
+    /* A restart clears the stages and drops a measurement armed before it */
+    LatencyArm(1);
+    restart(96000);
+    frames(LOOP_FRAMES * 2);
+    fail |= check("restart", (seen() == 0) && (g_report[LATENCY_REPORT_SAMFREQ] == 96000));
+
+    /* Frames counted from the restart */
+    LatencyArm(0);
+    frame(LATENCY_MARKER);
+    frames(LOOP_FRAMES);
+    fail |= check("after restart", (seen() == ALL_STAGES) && (stage(LATENCY_STAGE_USB_OUT) == LOOP_FRAMES * 2 + 1));
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,211 @@
+/* Checks the channel meter against signals with known levels: a sine, silence, a full scale
+ * square wave (clipping throughout), DC and bursts of clipping, and the hand over of periods to
+ * MeterCollect() when it is on time, late, and after rate and sample rate changes, up to the
+ * longest period */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "meter.h"
+
+#define TEST_FS             (0x7FFFFFFF)
+
+/* Largest error of a peak or RMS, in 1/1000 of full scale */
+#define TEST_MAX_LEVEL_ERR  (2)
+
+/* MeterCollect() polled every 1ms at 48kHz */
+#define TEST_POLL_FRAMES    (48)
+
+/* Clipped samples per period on the burst channel */
+#define TEST_BURST_CLIPS    (10)
+
+typedef struct
+{
+    const char *name;
+    double peak;                /* Expected, of full scale */
+    double rms;
+} signal_t;
+
+/* Expected RMS of the clip bursts channel set in main() */
+static signal_t g_signals[METER_NUM_CHANS] =
+{
+    {"sine -6dB", 0.5, 0.5 / M_SQRT2},
+    {"silence", 0, 0},
+    {"square full scale", 1.0, 1.0},
+    {"DC -12dB", 0.25, 0.25},
+    {"sine with clip bursts", 1.0, 0},
+    {"silence in", 0, 0},
+    {"sine 1kHz -20dB", 0.1, 0.1 / M_SQRT2},
+    {"silence in 2", 0, 0},
+};
+
+static unsigned long long g_frame = 0;
+static unsigned g_periodFrames = 2400;
+
+static int check(const char *name, int ok)
+{
+    printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+    return !ok;
+}
+
+static int sample(double x)
+{
+    const double s = x * 2147483648.0;
+
+    if(s >= 2147483647.0)
+        return 0x7FFFFFFF;
+    if(s <= -2147483648.0)
+        return (int) 0x80000000;
+    return (int) s;
+}
+
+static void play(unsigned frames)
+{
+    unsigned out[METER_CHANS_OUT];
+    unsigned in[METER_CHANS_IN];
+
+    for(unsigned f = 0; f < frames; f++, g_frame++)
+    {
+        const double t = (double) g_frame / 48000;
+        const unsigned pos = g_frame % g_periodFrames;
+
+        out[0] = sample(0.5 * sin(2 * M_PI * 997 * t));
+        out[1] = 0;
+        out[2] = sample(((g_frame / 24) & 1) ? -1.0 : 1.0);
+        out[3] = sample(-0.25);
+
+        /* Full scale for the first TEST_BURST_CLIPS frames of each period */
+        in[0] = (pos < TEST_BURST_CLIPS) ? sample(1.0) : sample(0.3 * sin(2 * M_PI * 1000 * t));
+        in[1] = 0;
+        in[2] = sample(0.1 * sin(2 * M_PI * 1000 * t));
+        in[3] = 0;
+
+        MeterFrame(out, in);
+    }
+}
+
+/* Frames of the period taken, 0 if none was complete */
+static unsigned collect()
+{
+    unsigned report[METER_REPORT_WORDS];
+
+    if(!MeterCollect())
+        return 0;
+
+    MeterReport(report);
+    return report[METER_REPORT_FRAMES];
+}
+
+/* Plays and collects at the poll interval until a period of the expected length is taken */
+static unsigned settle(unsigned frames)
+{
+    for(unsigned i = 0; i < 1000 + (4 * frames) / TEST_POLL_FRAMES; i++)
+    {
+        play(TEST_POLL_FRAMES);
+        if(collect() == frames)
+            return 1;
+    }
+    return 0;
+}
+
+static unsigned err(unsigned level, double expected)
+{
+    return (unsigned) (fabs(((double) level / TEST_FS) - expected) * 1000 + 0.5);
+}
+
+int main()
+{
+    unsigned report[METER_REPORT_WORDS];
+    unsigned maxPeakErr[METER_NUM_CHANS] = {0};
+    unsigned maxRmsErr[METER_NUM_CHANS] = {0};
+    unsigned framesOk = 1;
+    unsigned collected = 0;
+    int fail = 0;
+    char s[128];
+
+    g_signals[METER_CHANS_OUT].rms = sqrt((TEST_BURST_CLIPS + (0.045 * (g_periodFrames - TEST_BURST_CLIPS)))
+        / g_periodFrames);
+
+    MeterSetSampFreq(48000);
+
+    /* On time: the first period then 20 more */
+    while(collected < 21)
+    {
+        play(TEST_POLL_FRAMES);
+        if(MeterCollect())
+        {
+            collected++;
+            MeterReport(report);
+            framesOk &= (report[METER_REPORT_FRAMES] == g_periodFrames);
+
+            for(unsigned i = 0; i < METER_NUM_CHANS; i++)
+            {
+                const unsigned pe = err(report[METER_REPORT_PEAK(i)], g_signals[i].peak);
+                const unsigned re = err(report[METER_REPORT_RMS(i)], g_signals[i].rms);
+                if(pe > maxPeakErr[i])
+                    maxPeakErr[i] = pe;
+                if(re > maxRmsErr[i])
+                    maxRmsErr[i] = re;
+            }
+        }
+    }
+
+    for(unsigned i = 0; i < METER_NUM_CHANS; i++)
+    {
+        printf("%s: peak error %u, RMS error %u\n", g_signals[i].name, maxPeakErr[i], maxRmsErr[i]);
+        snprintf(s, sizeof(s), "%s levels", g_signals[i].name);
+        fail |= check(s, (maxPeakErr[i] <= TEST_MAX_LEVEL_ERR) && (maxRmsErr[i] <= TEST_MAX_LEVEL_ERR));
+    }
+    fail |= check("period frames", framesOk);
+    fail |= check("updates", report[METER_REPORT_UPDATES] == 21);
+
+    /* Every sample of the square wave clips, and the bursts */
+    fail |= check("square clips", report[METER_REPORT_CLIPS(2)] == 21 * g_periodFrames);
+    fail |= check("burst clips", report[METER_REPORT_CLIPS(METER_CHANS_OUT)] == 21 * TEST_BURST_CLIPS);
+    fail |= check("no clips", (report[METER_REPORT_CLIPS(0)] == 0) && (report[METER_REPORT_CLIPS(3)] == 0)
+        && (report[METER_REPORT_CLIPS(METER_CHANS_OUT + 2)] == 0));
+
+    /* Quarters of 8 channels: outputs 2-3 and inputs 0-1 */
+    fail |= check("clip quarters", MeterClipQuarters() == 0x6);
+
+    /* Late: a period waits to be taken, the audio thread carries on with the next until it is */
+    play(3 * g_periodFrames);
+    fail |= check("late waiting period", collect() == g_periodFrames);
+    fail |= check("late nothing pending", collect() == 0);
+    play(1);
+    fail |= check("late carried on", collect() > 2 * g_periodFrames);
+    MeterReport(report);
+    fail |= check("late levels", err(report[METER_REPORT_PEAK(0)], 0.5) <= TEST_MAX_LEVEL_ERR
+        && err(report[METER_REPORT_RMS(0)], 0.5 / M_SQRT2) <= TEST_MAX_LEVEL_ERR);
+
+    /* Update rate, from the next period */
+    fail |= check("rate out of range", !MeterSetRate(METER_MIN_RATE_HZ - 1) && !MeterSetRate(METER_MAX_RATE_HZ + 1));
+    fail |= check("rate", MeterSetRate(100) && settle(480));
+
+    /* Sample rate change, at 100Hz */
+    MeterSetSampFreq(96000);
+    fail |= check("sample rate", settle(960));
+
+    /* The slowest rate at 192kHz: a period of full scale squares beyond the range of a signed sum */
+    MeterSetSampFreq(192000);
+    fail |= check("slowest rate", MeterSetRate(METER_MIN_RATE_HZ) && settle(192000 / METER_MIN_RATE_HZ));
+    MeterReport(report);
+    fail |= check("slowest rate levels", err(report[METER_REPORT_RMS(2)], 1.0) <= TEST_MAX_LEVEL_ERR
+        && err(report[METER_REPORT_RMS(0)], 0.5 / M_SQRT2) <= TEST_MAX_LEVEL_ERR);
+
+    /* Not taken for longer than the longest period: the period stops at its limit */
+    play(192000 / METER_MIN_RATE_HZ);
+    play(2 * METER_MAX_PERIOD_FRAMES);
+    fail |= check("longest period waiting", collect() == 192000 / METER_MIN_RATE_HZ);
+    play(1);
+    fail |= check("longest period", collect() == METER_MAX_PERIOD_FRAMES);
+    MeterReport(report);
+    fail |= check("longest period levels", err(report[METER_REPORT_RMS(2)], 1.0) <= TEST_MAX_LEVEL_ERR);
+
+    MeterReset();
+    MeterReport(report);
+    fail |= check("reset", (report[METER_REPORT_UPDATES] == 0) && (report[METER_REPORT_CLIPS(2)] == 0)
+        && (report[METER_REPORT_PEAK(0)] != 0));
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
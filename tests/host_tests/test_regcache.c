@@ -0,0 +1,107 @@
+/* Checks the codec shadow register cache: skipped writes, burst trimming, invalidation and the
+ * I2C byte counts */
+#include <stdio.h>
+
+#define REGCACHE_NUM_DEVS   (2)
+#include "../../shared/regcache.h"
+
+static int check(const char *name, int ok)
+{
+    printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+    return !ok;
+}
+
+static int test_write()
+{
+    int fail = 0;
+
+    RegCacheInvalidate(0);
+    RegCacheInvalidate(1);
+
+    fail |= check("write unknown", RegCacheWrite(0, 0x10, 0x00) == 1);
+    fail |= check("write same", RegCacheWrite(0, 0x10, 0x00) == 0);
+    fail |= check("write different", RegCacheWrite(0, 0x10, 0x55) == 1);
+    fail |= check("write other device", RegCacheWrite(1, 0x10, 0x55) == 1);
+    fail |= check("write last register", (RegCacheWrite(0, REGCACHE_NUM_REGS - 1, 1) == 1)
+        && (RegCacheWrite(0, REGCACHE_NUM_REGS - 1, 1) == 0));
+
+    RegCacheInvalidate(0);
+    fail |= check("write after invalidate", RegCacheWrite(0, 0x10, 0x55) == 1);
+    fail |= check("invalidate other device", RegCacheWrite(1, 0x10, 0x55) == 0);
+
+    return fail;
+}
+
+static int test_burst()
+{
+    const uint8_t a[] = {0xFF, 0x03, 0x03, 0x07, 0x00, 0x02, 0x00};
+    const uint8_t b[] = {0xFF, 0x03, 0x03, 0x03, 0x01, 0x01, 0x00};
+    const uint8_t c[] = {0xFF, 0x03, 0x04, 0x03, 0x01, 0x01, 0x05};
+    unsigned range;
+    int fail = 0;
+
+    RegCacheInvalidate(0);
+
+    /* Offset 1 skips the first byte of each array */
+    range = RegCacheBurst(0, 0x1C, a, 1, 6);
+    fail |= check("burst unknown", (REGCACHE_FIRST(range) == 0) && (REGCACHE_COUNT(range) == 6));
+
+    range = RegCacheBurst(0, 0x1C, a, 1, 6);
+    fail |= check("burst same", REGCACHE_COUNT(range) == 0);
+
+    /* Registers 2 to 4 change */
+    range = RegCacheBurst(0, 0x1C, b, 1, 6);
+    fail |= check("burst trimmed", (REGCACHE_FIRST(range) == 2) && (REGCACHE_COUNT(range) == 3));
+
+    /* 1 and 5 change, 2 to 4 do not but are inside the range */
+    range = RegCacheBurst(0, 0x1C, c, 1, 6);
+    fail |= check("burst gap", (REGCACHE_FIRST(range) == 1) && (REGCACHE_COUNT(range) == 5));
+
+    fail |= check("burst then write", RegCacheWrite(0, 0x1C + 5, 0x05) == 0);
+
+    return fail;
+}
+
+static int test_bytes()
+{
+    const uint8_t data[] = {1, 2, 3, 4};
+    const uint8_t data2[] = {1, 2, 9, 4};
+    int fail = 0;
+
+    RegCacheInvalidate(0);
+    g_regCacheBytesWritten = 0;
+    g_regCacheBytesSaved = 0;
+
+    RegCacheCfgStart();
+    (void) RegCacheWrite(0, 0x02, 0x10);    /* 3 written */
+    (void) RegCacheBurst(0, 0x20, data, 0, 4);  /* 6 written */
+    RegCacheCfgEnd();
+    fail |= check("bytes first config", (g_regCacheCfgBytesWritten == 9) && (g_regCacheCfgBytesSaved == 0));
+
+    RegCacheCfgStart();
+    (void) RegCacheWrite(0, 0x02, 0x10);    /* 3 saved */
+    (void) RegCacheBurst(0, 0x20, data2, 0, 4); /* 3 written, 3 saved */
+    RegCacheCfgEnd();
+    fail |= check("bytes second config", (g_regCacheCfgBytesWritten == 3) && (g_regCacheCfgBytesSaved == 6));
+
+    RegCacheCfgStart();
+    (void) RegCacheBurst(0, 0x20, data2, 0, 4); /* 6 saved */
+    RegCacheCfgEnd();
+    fail |= check("bytes same config", (g_regCacheCfgBytesWritten == 0) && (g_regCacheCfgBytesSaved == 6));
+
+    fail |= check("bytes total", (g_regCacheBytesWritten == 12) && (g_regCacheBytesSaved == 12));
+
+    return fail;
+}
+
+int main()
+{
+    int fail = 0;
+
+    fail |= test_write();
+    fail |= test_burst();
+    fail |= test_bytes();
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,238 @@
+/* Checks software MCLK recovery against reference edge timestamps: lock time, phase error and
+ * frequency tracking, using synthetic references (host/source clock offset, drift, edge jitter
+ * and a dropout).
+ *
+ * Recorded timestamps (e.g. captured from a SW_PLL_TRACE build) can be played with:
+ *
+ *   test_sw_pll <trace file> <MCLK Hz> <reference Hz>
+ *
+ * one timestamp per line, optionally prefixed "SWPLL " as printed by the device */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sw_pll.h"
+
+typedef struct
+{
+    unsigned mclk;
+    unsigned ctl;
+    unsigned div;
+    unsigned frac;
+    int err_ppb;
+} app_pll_setting_t;
+
+#include "../../shared/apppll_table.h"
+
+/* Lock within, and phase error once locked */
+#define TEST_MAX_LOCK_MS        (400)
+#define TEST_MAX_PHASE_NS       (SW_PLL_LOCK_NS)
+
+/* Average MCLK error from the reference once locked */
+#define TEST_MAX_TRACK_PPM      (0.2)
+
+#define TEST_MAX_EDGES          (20000)
+
+static unsigned g_ticks[TEST_MAX_EDGES];
+
+static int check(const char *name, int ok)
+{
+    printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+    return !ok;
+}
+
+static const app_pll_setting_t *trim_setting(unsigned mclk)
+{
+    for(unsigned i = 0; i < APP_PLL_NUM_SETTINGS; i++)
+    {
+        if(g_appPllTrimSettings[i].mclk == mclk)
+        {
+            return &g_appPllTrimSettings[i];
+        }
+    }
+    return NULL;
+}
+
+/* MCLK output (Hz) for a FRAC value with the CTL and DIV of s */
+static double mclk_hz(const app_pll_setting_t *s, unsigned frac)
+{
+    const unsigned r = s->ctl & 0x3F;
+    const unsigned od = ((s->ctl >> 23) & 0x7) + 1;
+    const unsigned fod = (s->div & 0x1FF) + 1;
+    double fd = ((s->ctl >> 8) & 0x1FFF) + 1;
+
+    if(frac & 0x80000000)
+    {
+        fd += (((frac >> 8) & 0xFF) + 1) / (double) ((frac & 0xFF) + 1);
+    }
+    return 24000000.0 / (r + 1) * fd / (4.0 * od * fod);
+}
+
+/* Uniform in [-1, 1] */
+static double rand_unit()
+{
+    return (rand() / (double) RAND_MAX) * 2.0 - 1.0;
+}
+
+/* Reference edges at ref Hz, ppm from the local crystal plus drift (ppm peak, period in s), each
+ * edge with up to jitterNs of random timing error. Edges in [gapStart, gapEnd) s are missing.
+ * Timestamps start just before the 32 bit timer wraps */
+static unsigned make_trace(unsigned ref, double ppm, double driftPpm, double driftPeriod,
+    double jitterNs, double gapStart, double gapEnd, double seconds)
+{
+    unsigned n = 0;
+    double t = 0;
+
+    srand(1);
+    while((t < seconds) && (n < TEST_MAX_EDGES))
+    {
+        const double p = ppm + driftPpm * sin(2 * M_PI * t / driftPeriod);
+        t += 1.0 / (ref * (1 + p / 1e6));
+
+        if((t >= gapStart) && (t < gapEnd))
+        {
+            continue;
+        }
+
+        const double ticks = t * SW_PLL_TIMER_HZ + rand_unit() * jitterNs / 10.0;
+        g_ticks[n++] = 0xFFF00000u + (unsigned) llround(ticks);
+    }
+    return n;
+}
+
+typedef struct
+{
+    unsigned locked;
+    double lockMs;
+    double maxPhaseNs;          /* After lock */
+    double trackPpm;            /* MCLK average vs reference over the second half */
+    unsigned jitterPs;
+} result_t;
+
+/* Plays numTicks edges, trackRefPpm is the reference offset over the second half (for the
+ * tracking result) */
+static result_t run(unsigned mclk, unsigned ref, unsigned numTicks, double trackRefPpm)
+{
+    const app_pll_setting_t *s = trim_setting(mclk);
+    result_t res = {0, 0, 0, 0, 0};
+    double cycles = 0;
+    double cyclesTime = 0;
+    unsigned half = numTicks / 2;
+
+    SwPllInit(mclk, ref, s->ctl, s->div, s->frac, g_ticks[0] - 100000);
+    unsigned frac = s->frac;
+
+    for(unsigned i = 0; i < numTicks; i++)
+    {
+        if(i > half)
+        {
+            const double dt = (unsigned) (g_ticks[i] - g_ticks[i - 1]) / (double) SW_PLL_TIMER_HZ;
+            cycles += mclk_hz(s, frac) * dt;
+            cyclesTime += dt;
+        }
+
+        const unsigned newFrac = SwPllUpdate(g_ticks[i]);
+        if(newFrac)
+        {
+            frac = newFrac;
+        }
+
+        if(g_swPllLocked && !res.locked)
+        {
+            res.locked = 1;
+            res.lockMs = g_swPllLockTicks / (SW_PLL_TIMER_HZ / 1000.0);
+        }
+        if(res.locked && (i > half) && (fabs(g_swPllPhaseNs) > res.maxPhaseNs))
+        {
+            res.maxPhaseNs = fabs(g_swPllPhaseNs);
+        }
+    }
+
+    res.locked = g_swPllLocked;
+    res.jitterPs = SwPllJitterPs();
+    if(cyclesTime > 0)
+    {
+        res.trackPpm = ((cycles / cyclesTime) / (mclk * (1 + trackRefPpm / 1e6)) - 1) * 1e6;
+    }
+
+    printf("MCLK %u ref %u: locked %u in %.1fms, max phase %.0fns, jitter %ups, tracking %.3fppm, "
+        "correction %dppb, slips %u\n", mclk, ref, res.locked, res.lockMs, res.maxPhaseNs,
+        res.jitterPs, res.trackPpm, g_swPllPpb, g_swPllSlips);
+    return res;
+}
+
+static int check_result(const char *name, result_t res, double trackPpm)
+{
+    int fail = 0;
+    char s[128];
+
+    snprintf(s, sizeof(s), "%s lock", name);
+    fail |= check(s, res.locked && (res.lockMs <= TEST_MAX_LOCK_MS));
+    snprintf(s, sizeof(s), "%s phase", name);
+    fail |= check(s, res.maxPhaseNs <= TEST_MAX_PHASE_NS);
+    if(trackPpm)
+    {
+        snprintf(s, sizeof(s), "%s tracking", name);
+        fail |= check(s, fabs(res.trackPpm) <= trackPpm);
+    }
+    return fail;
+}
+
+static int run_file(const char *path, unsigned mclk, unsigned ref)
+{
+    FILE *f = fopen(path, "r");
+    char line[128];
+    unsigned n = 0;
+
+    if(f == NULL || trim_setting(mclk) == NULL)
+    {
+        printf("Cannot open %s or no setting for MCLK %u\n", path, mclk);
+        return 1;
+    }
+
+    while(fgets(line, sizeof(line), f) && (n < TEST_MAX_EDGES))
+    {
+        const char *p = strncmp(line, "SWPLL ", 6) ? line : line + 6;
+        g_ticks[n++] = (unsigned) strtoul(p, NULL, 10);
+    }
+    fclose(f);
+
+    /* The reference offset is not known, so tracking is not checked */
+    return check_result(path, run(mclk, ref, n, 0), 0);
+}
+
+int main(int argc, char *argv[])
+{
+    int fail = 0;
+    unsigned n;
+
+    if(argc == 4)
+    {
+        return run_file(argv[1], (unsigned) atoi(argv[2]), (unsigned) atoi(argv[3]));
+    }
+
+    /* Sync mode: SOF derived 500Hz reference from a host 230ppm fast, 500ns of edge jitter */
+    n = make_trace(500, 230, 0, 1, 500, 0, 0, 8);
+    fail |= check_result("sync 24.576MHz", run(48000 * 512, 500, n, 230), TEST_MAX_TRACK_PPM);
+
+    /* S/PDIF input: 300Hz reference from a source 85ppm slow, drifting 10ppm over 20s */
+    n = make_trace(300, -85, 10, 20, 200, 0, 0, 20);
+    fail |= check_result("spdif 22.5792MHz", run(44100 * 512, 300, n, 0), 0);
+
+    /* Close to the range limit at 1024fs */
+    n = make_trace(500, -480, 0, 1, 500, 0, 0, 8);
+    fail |= check_result("sync 45.1584MHz", run(44100 * 1024, 500, n, -480), TEST_MAX_TRACK_PPM);
+
+    n = make_trace(500, 300, 0, 1, 500, 0, 0, 8);
+    fail |= check_result("sync 49.152MHz", run(48000 * 1024, 500, n, 300), TEST_MAX_TRACK_PPM);
+
+    /* Reference lost for 200ms (e.g. S/PDIF cable pulled), recovery re-locks */
+    n = make_trace(300, 40, 0, 1, 200, 2, 2.2, 8);
+    result_t res = run(44100 * 256, 300, n, 40);
+    fail |= check("dropout slip", g_swPllSlips >= 1);
+    fail |= check("dropout relock", res.locked);
+    fail |= check("dropout tracking", fabs(res.trackPpm) <= TEST_MAX_TRACK_PPM);
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,164 @@
+/* Checks the dropout counters: I2S slips and the frames lost in them, silence gaps in either direction,
+ * what is not counted (jitter, pauses, partial or single frame silence, restarts), the clock
+ * status, reset and timer wrap */
+#include <stdio.h>
+#include "xrun.h"
+
+/* Reference timer, see xua_conf.h */
+unsigned g_testTime;
+
+/* Clock status, normally from shared/cs2100.h and sw_pll.c */
+unsigned g_pllLockFails = 0;
+unsigned g_swPllSlips = 0;
+unsigned g_swPllUnlocks = 0;
+
+static unsigned long long g_frameTicksQ16;     /* Frame period, ticks << 16 */
+static unsigned long long g_timeQ16;
+
+static int check(const char *name, int ok)
+{
+    printf("%s: %s\n", ok ? "PASS" : "FAIL", name);
+    return !ok;
+}
+
+static void restart(unsigned fs)
+{
+    g_frameTicksQ16 = (100000000ull << 16) / fs;
+    XrunSetSampFreq(fs);
+}
+
+/* Plays frames at the frame period, late by lateTicks for the first. Channels in the out and in
+ * masks are silent */
+static void play(unsigned frames, unsigned lateTicks, unsigned silentOut, unsigned silentIn)
+{
+    unsigned out[XRUN_CHANS_OUT];
+    unsigned in[XRUN_CHANS_IN];
+
+    g_timeQ16 += (unsigned long long) lateTicks << 16;
+
+    for(unsigned f = 0; f < frames; f++)
+    {
+        g_timeQ16 += g_frameTicksQ16;
+        g_testTime = (unsigned) (g_timeQ16 >> 16);
+
+        for(unsigned i = 0; i < XRUN_CHANS_OUT; i++)
+        {
+            out[i] = (silentOut & (1 << i)) ? 0 : ((f + 1) << 8);
+        }
+        for(unsigned i = 0; i < XRUN_CHANS_IN; i++)
+        {
+            in[i] = (silentIn & (1 << i)) ? 0 : ((f + 1) << 8);
+        }
+        XrunFrame(out, in);
+    }
+}
+
+#define ALL_OUT     ((1 << XRUN_CHANS_OUT) - 1)
+#define ALL_IN      ((1 << XRUN_CHANS_IN) - 1)
+
+static unsigned count(unsigned counter)
+{
+    unsigned counts[XRUN_NUM_COUNTERS];
+
+    XrunRead(counts);
+    return counts[counter];
+}
+
+static unsigned total()
+{
+    unsigned counts[XRUN_NUM_COUNTERS];
+    unsigned sum = 0;
+
+    XrunRead(counts);
+    for(unsigned i = 0; i < XRUN_NUM_COUNTERS; i++)
+    {
+        sum += counts[i];
+    }
+    return sum;
+}
+
+int main()
+{
+    int fail = 0;
+
+    /* Nothing is counted before the first rate */
+    g_timeQ16 = 0;
+    play(1000, 1000000, 0, 0);
+    fail |= check("no rate", total() == 0);
+
+    /* Starting near the timer wrap, a second of audio with up to 40% of a frame of jitter */
+    g_timeQ16 = (unsigned long long) 0xFFF00000 << 16;
+    restart(48000);
+    play(1, 0, 0, 0);
+    for(unsigned i = 0; i < 4800; i++)
+    {
+        play(1, (i & 1) ? 800 : 0, 0, 0);
+        g_timeQ16 -= (i & 1) ? (800ull << 16) : 0;
+        play(9, 0, 0, 0);
+    }
+    fail |= check("restart counted", count(XRUN_RESTARTS) == 1);
+    fail |= check("clean audio", total() == count(XRUN_RESTARTS));
+
+    /* Late by one, then three frames */
+    play(10, 2083, 0, 0);
+    fail |= check("slip", (count(XRUN_I2S_SLIPS) == 1) && (count(XRUN_FRAMES_LOST) == 1));
+    play(10, 3 * 2083, 0, 0);
+    fail |= check("slip of 3 frames", (count(XRUN_I2S_SLIPS) == 2) && (count(XRUN_FRAMES_LOST) == 4));
+
+    /* Host to device silence: 10 frames, a single frame, some channels only, then a pause */
+    play(10, 0, ALL_OUT, 0);
+    play(10, 0, 0, 0);
+    fail |= check("out gap", (count(XRUN_OUT_SILENCE_GAPS) == 1) && (count(XRUN_IN_SILENCE_GAPS) == 0));
+    play(1, 0, ALL_OUT, 0);
+    play(10, 0, 0, 0);
+    fail |= check("single frame not a gap", count(XRUN_OUT_SILENCE_GAPS) == 1);
+    play(100, 0, 0x3, 0);
+    play(10, 0, 0, 0);
+    fail |= check("some channels not a gap", count(XRUN_OUT_SILENCE_GAPS) == 1);
+    play(48000 / 10, 0, ALL_OUT, 0);
+    play(10, 0, 0, 0);
+    fail |= check("pause not a gap", count(XRUN_OUT_SILENCE_GAPS) == 1);
+
+    /* Device to host, the longest run counted */
+    play((48000 / 1000) * XRUN_GAP_MAX_MS, 0, 0, ALL_IN);
+    play(10, 0, 0, 0);
+    fail |= check("in gap", (count(XRUN_IN_SILENCE_GAPS) == 1) && (count(XRUN_OUT_SILENCE_GAPS) == 1));
+
+    /* Restart at 96kHz after 100ms without frames, silence either side of it */
+    play(10, 0, ALL_OUT, ALL_IN);
+    g_timeQ16 += 10000000ull << 16;
+    restart(96000);
+    play(10, 0, ALL_OUT, ALL_IN);
+    play(10, 0, 0, 0);
+    fail |= check("restart", (count(XRUN_RESTARTS) == 2) && (count(XRUN_I2S_SLIPS) == 2)
+        && (count(XRUN_OUT_SILENCE_GAPS) == 1) && (count(XRUN_IN_SILENCE_GAPS) == 1));
+
+    /* Once there has been audio since the restart, silence is a gap again */
+    play(10, 0, ALL_OUT, 0);
+    play(10, 0, 0, 0);
+    fail |= check("gap at 96kHz", count(XRUN_OUT_SILENCE_GAPS) == 2);
+
+    /* A third of a frame late is jitter, two frames a slip */
+    play(10, 1041 / 3, 0, 0);
+    fail |= check("jitter at 96kHz", count(XRUN_I2S_SLIPS) == 2);
+    play(10, 2 * 1041, 0, 0);
+    fail |= check("slip at 96kHz", (count(XRUN_I2S_SLIPS) == 3) && (count(XRUN_FRAMES_LOST) == 6));
+
+    /* Clock status */
+    g_pllLockFails = 2;
+    g_swPllSlips = 3;
+    g_swPllUnlocks = 1;
+    fail |= check("clock", (count(XRUN_PLL_LOCK_FAILS) == 2) && (count(XRUN_PLL_SLIPS) == 3)
+        && (count(XRUN_PLL_UNLOCKS) == 1));
+
+    /* Reset, then counting from zero */
+    XrunReset();
+    fail |= check("reset", total() == 0);
+    play(10, 2 * 1041, 0, 0);
+    g_swPllSlips++;
+    fail |= check("after reset", (count(XRUN_I2S_SLIPS) == 1) && (count(XRUN_FRAMES_LOST) == 2)
+        && (count(XRUN_PLL_SLIPS) == 1) && (total() == 4));
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,9 @@
+/* Host stand-in for lib_xua's dsd_support.h, see xs1.h */
+#ifndef _DSD_SUPPORT_H_
+#define _DSD_SUPPORT_H_
+
+#define DSD_MODE_OFF            (0)
+#define DSD_MODE_NATIVE         (1)
+#define DSD_MODE_DOP            (2)
+
+#endif
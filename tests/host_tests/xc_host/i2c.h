@@ -0,0 +1,73 @@
+/* Host stand-in for lib_i2c, see xs1.h. The client side of i2c_master_if, with the transactions
+ * going to the bus model of the harness. write_reg() and read_reg() are as in lib_i2c */
+#ifndef _I2C_H_
+#define _I2C_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef unsigned i2c_res_t;
+enum { I2C_NACK, I2C_ACK };
+
+typedef unsigned i2c_regop_res_t;
+enum { I2C_REGOP_SUCCESS, I2C_REGOP_DEVICE_NACK, I2C_REGOP_INCOMPLETE };
+
+/* Provided by the harness */
+i2c_res_t HostI2cWrite(uint8_t addr, const uint8_t buf[], size_t n, size_t &num_bytes_sent, int send_stop_bit);
+i2c_res_t HostI2cRead(uint8_t addr, uint8_t buf[], size_t n, int send_stop_bit);
+void HostI2cStop();
+
+struct i2c_master_if
+{
+    i2c_res_t write(uint8_t addr, const uint8_t buf[], size_t n, size_t &num_bytes_sent, int send_stop_bit)
+    {
+        return HostI2cWrite(addr, buf, n, num_bytes_sent, send_stop_bit);
+    }
+
+    i2c_res_t read(uint8_t addr, uint8_t buf[], size_t n, int send_stop_bit)
+    {
+        return HostI2cRead(addr, buf, n, send_stop_bit);
+    }
+
+    void send_stop_bit()
+    {
+        HostI2cStop();
+    }
+
+    void shutdown() {}
+
+    i2c_regop_res_t write_reg(uint8_t addr, uint8_t reg, uint8_t data)
+    {
+        uint8_t a_data[2] = {reg, data};
+        size_t n;
+
+        write(addr, a_data, 2, n, 1);
+        if(n == 0)
+        {
+            return I2C_REGOP_DEVICE_NACK;
+        }
+        return (n < 2) ? I2C_REGOP_INCOMPLETE : I2C_REGOP_SUCCESS;
+    }
+
+    uint8_t read_reg(uint8_t addr, uint8_t reg, i2c_regop_res_t &result)
+    {
+        uint8_t a_reg[1] = {reg};
+        uint8_t data[1] = {0};
+        size_t n;
+
+        write(addr, a_reg, 1, n, 0);
+        if(n != 1)
+        {
+            result = I2C_REGOP_DEVICE_NACK;
+            send_stop_bit();
+            return 0;
+        }
+        result = (read(addr, data, 1, 1) == I2C_ACK) ? I2C_REGOP_SUCCESS : I2C_REGOP_DEVICE_NACK;
+        return data[0];
+    }
+
+    /* Reads as set up, for the "wait until global is set" loops */
+    operator unsigned() const { return 1; }
+};
+
+#endif
@@ -0,0 +1,16 @@
+/* Host stand-in for <platform.h>, see xs1.h. Port names of both boards' XN files */
+#ifndef _PLATFORM_H_
+#define _PLATFORM_H_
+
+#include <xs1.h>
+
+static unsigned tile[2];
+
+#define PORT_I2C                (0x20100)
+#define PORT_I2C_SCL            (0x10100)
+#define PORT_I2C_SDA            (0x10200)
+#define PORT_CTRL               (0x80000)
+#define PORT_PLL_REF            (0x10C00)
+#define PORT_CODEC_RST_N        (0x40000)
+
+#endif
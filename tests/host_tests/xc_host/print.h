@@ -0,0 +1,10 @@
+/* Host stand-in for <print.h>, see xs1.h */
+#ifndef _PRINT_H_
+#define _PRINT_H_
+
+#include <stdio.h>
+
+#define printstr(s)             printf("%s", s)
+#define printuintln(x)          printf("%u\n", (unsigned) (x))
+
+#endif
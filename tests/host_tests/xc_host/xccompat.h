@@ -0,0 +1,7 @@
+/* Host stand-in for <xccompat.h>, see xs1.h */
+#ifndef _XCCOMPAT_H_
+#define _XCCOMPAT_H_
+
+#define REFERENCE_PARAM(type, name) type *name
+
+#endif
@@ -0,0 +1,76 @@
+/* Host stand-in for <xs1.h>, for audiohw.xc lowered to C++ by xc_lower.py (see test_audiohw.cpp).
+ *
+ * Timers read and wait on the simulated reference timer of the harness, so delays cost no real
+ * time. Ports and channels are only declared: board_setup() port writes are ignored and channel
+ * I/O stops the harness, as audiohw.xc must not reach it on the host. */
+#ifndef _XS1_H_
+#define _XS1_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define XS1_TIMER_HZ            (100000000)
+#define XS1_TIMER_KHZ           (100000)
+#define XS1_TIMER_MHZ           (100)
+
+#define XS1_PORT_1G             (0x10600)
+#define XS1_PORT_1N             (0x10D00)
+#define XS1_PORT_1O             (0x10E00)
+#define XS1_PORT_8C             (0x80200)
+#define XS1_CLKBLK_5            (0x506)
+
+#define XS1_SSWITCH_SS_APP_PLL_CTL_NUM              (0x06)
+#define XS1_SSWITCH_SS_APP_PLL_FRAC_N_DIVIDER_NUM   (0x07)
+#define XS1_SSWITCH_SS_APP_CLK_DIVIDER_NUM          (0x08)
+
+struct timer {};
+
+struct port
+{
+    unsigned id;
+    port(unsigned i = 0) : id(i) {}
+};
+
+struct clock
+{
+    unsigned id;
+    clock(unsigned i = 0) : id(i) {}
+};
+
+struct chanend
+{
+    unsigned id;
+    chanend(unsigned i = 0) : id(i) {}
+
+    /* Reads as set up, for the "wait until global is set" loops */
+    operator unsigned() const { return 1; }
+};
+
+/* Provided by the harness */
+unsigned HostTime();
+void HostWaitUntil(unsigned time);
+void HostWait(unsigned ticks);
+void HostChanAbort(const char *op);
+
+static inline unsigned xc_in(timer &t) { return HostTime(); }
+static inline unsigned xc_timerafter(timer &t, unsigned time) { HostWaitUntil(time); return HostTime(); }
+static inline unsigned xc_in(port &p) { return 0; }
+static inline void xc_out(port &p, unsigned val) {}
+static inline unsigned xc_in(chanend &c) { HostChanAbort("input"); return 0; }
+static inline void xc_out(chanend &c, unsigned val) { HostChanAbort("output"); }
+
+static inline void delay_microseconds(unsigned us) { HostWait(us * XS1_TIMER_MHZ); }
+static inline void delay_milliseconds(unsigned ms) { HostWait(ms * XS1_TIMER_KHZ); }
+static inline void delay_seconds(unsigned s) { HostWait(s * XS1_TIMER_HZ); }
+
+static inline void set_port_drive_high(port &p) {}
+static inline unsigned peek(port &p) { return 0; }
+static inline void configure_clock_rate(clock &c, unsigned a, unsigned b) {}
+static inline void configure_port_clock_output(port &p, clock &c) {}
+static inline void start_clock(clock &c) {}
+
+/* AppPLL registers, only written */
+#define read_node_config_reg(tile, reg, data)   ((data) = 0)
+#define write_node_config_reg(tile, reg, data)  ((void) (data))
+
+#endif
@@ -0,0 +1,45 @@
+/* Host stand-in for lib_xua's xua.h, see xs1.h: the application's xua_conf.h and the lib_xua
+ * defaults that audiohw.xc uses */
+#ifndef _XUA_H_
+#define _XUA_H_
+
+#include "xua_conf.h"
+
+#define XUA_SYNCMODE_ASYNC      (0)
+#define XUA_SYNCMODE_SYNC       (1)
+#ifndef XUA_SYNCMODE
+#define XUA_SYNCMODE            (XUA_SYNCMODE_ASYNC)
+#endif
+
+#define XUA_PCM_FORMAT_I2S      (0)
+#define XUA_PCM_FORMAT_TDM      (1)
+#ifndef XUA_PCM_FORMAT
+#define XUA_PCM_FORMAT          (XUA_PCM_FORMAT_I2S)
+#endif
+
+#ifndef XUA_I2S_N_BITS
+#define XUA_I2S_N_BITS          (32)
+#endif
+
+#ifndef CODEC_MASTER
+#define CODEC_MASTER            (0)
+#endif
+
+#if (XUA_PCM_FORMAT == XUA_PCM_FORMAT_TDM)
+#define I2S_CHANS_PER_FRAME     (8)
+#else
+#define I2S_CHANS_PER_FRAME     (2)
+#endif
+
+#ifndef MIN_FREQ
+#define MIN_FREQ                (44100)
+#endif
+
+#ifndef DEFAULT_FREQ
+#define DEFAULT_FREQ            (MIN_FREQ)
+#endif
+
+#define XUA_POWERMODE_SELF      (0)
+#define XUA_POWERMODE_BUS       (1)
+
+#endif
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Lowers preprocessed XC (g++ -E -x c++ with the xc_host stand-in headers) to C++, for building
+the configuration code of audiohw.xc on the host, see test_audiohw.cpp.
+
+Only the subset of XC used by the audiohw.xc files is handled:
+
+    unsafe, client/server interface     removed, i2c_master_if is a C++ class (xc_host/i2c.h)
+    on tile[n]:, in/out port            removed, port is a C++ class
+    chanend ?c                          nullable chanend, as chanend c
+    t :> x, t :> void, p <: x           xc_in() and xc_out() of xc_host/xs1.h
+    t when timerafter(e) :> x           xc_timerafter()
+
+Functions using anything else (par, select) are replaced with --replace: the definition becomes
+HOST_FUNCTION_<name>, which the harness defines as a host version or as nothing.
+
+Usage:
+    g++ -E -dD -x c++ -D__XC__ -I xc_host ... audiohw.xc | python3 xc_lower.py [--replace f ...]
+"""
+import argparse
+import re
+import sys
+
+SUBS = [
+    (re.compile(r"\bunsafe\b"), ""),
+    (re.compile(r"\b(client|server)\s+interface\s+"), ""),
+    (re.compile(r"\bon\s+tile\s*\[[^\]]*\]\s*:"), ""),
+    (re.compile(r"\b(in|out)\s+(buffered\s+)?port\b"), "port"),
+    (re.compile(r"\bchanend\s*\?\s*"), "chanend "),
+    (re.compile(r"(\w+)\s+when\s+timerafter\s*\((.*)\)\s*:>\s*void\s*;"), r"(void) xc_timerafter(\1, \2);"),
+    (re.compile(r"(\w+)\s+when\s+timerafter\s*\((.*)\)\s*:>\s*([^;]+);"), r"\3 = xc_timerafter(\1, \2);"),
+    (re.compile(r"(\w+)\s*:>\s*void\s*;"), r"(void) xc_in(\1);"),
+    (re.compile(r"(\w+)\s*:>\s*([^;]+);"), r"\2 = xc_in(\1);"),
+    (re.compile(r"(\w+)\s*<:\s*([^;]+);"), r"xc_out(\1, \2);"),
+]
+
+PREPROCESSOR = re.compile(r"[ \t]*#")
+LINE_MARKER = re.compile(r'# \d+ "(.*)"')
+
+
+def lower(text):
+    """Applies SUBS to each line that is not a preprocessor line. The compiler's own macros (from
+    -dD) are dropped, the compiler defines them again"""
+    lines = []
+    builtin = False
+    for line in text.split("\n"):
+        marker = LINE_MARKER.match(line)
+        if marker:
+            builtin = marker.group(1) == "<built-in>"
+        elif builtin:
+            continue
+        elif not line.lstrip().startswith("#"):
+            for pattern, sub in SUBS:
+                line = pattern.sub(sub, line)
+        lines.append(line)
+    return "\n".join(lines)
+
+
+def top_level(text):
+    """Yields (index, char, brace depth) of the characters outside string and character literals.
+    Preprocessor lines are skipped, each yielding one "#" at its end"""
+    depth = 0
+    i = 0
+    line_start = True
+    while i < len(text):
+        c = text[i]
+        if line_start and PREPROCESSOR.match(text, i):
+            i = text.find("\n", i)
+            if i < 0:
+                return
+            yield i, "#", depth
+            continue
+        line_start = c == "\n"
+        if c in "\"'":
+            j = i + 1
+            while text[j] != c:
+                j += 2 if text[j] == "\\" else 1
+            i = j + 1
+            continue
+        yield i, c, depth
+        if c == "{":
+            depth += 1
+        elif c == "}":
+            depth -= 1
+        i += 1
+
+
+def replace_function(text, name):
+    """Replaces the definition of function name with HOST_FUNCTION_<name>"""
+    start = 0
+    paren = None
+    for i, c, depth in top_level(text):
+        if (c == "}" and depth == 1) or (c in ";#" and depth == 0):
+            # End of the previous declaration or definition
+            start = i + 1
+            paren = None
+        elif depth != 0:
+            continue
+        elif c == "(" and paren is None and re.search(r"\b" + re.escape(name) + r"\s*$", text[:i]):
+            paren = i
+        elif c == "{" and paren is not None:
+            # Definition found, up to the matching brace
+            for j, d, depth2 in top_level(text[i:]):
+                if d == "}" and depth2 == 1:
+                    end = i + j + 1
+                    # Ended with an empty declaration, so the next replacement does not take it
+                    # in as the start of its own definition
+                    return text[:start] + f"\nHOST_FUNCTION_{name};\n" + text[end:]
+    sys.exit(f"xc_lower.py: no definition of {name}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--replace", nargs="*", default=[], help="Functions the harness replaces")
+    args = parser.parse_args()
+
+    text = sys.stdin.read()
+    for name in args.replace:
+        text = replace_function(text, name)
+    sys.stdout.write(lower(text))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,23 @@
+#ifndef _XUA_CONF_H_
+#define _XUA_CONF_H_
+
+/* Minimal stand-in for the application xua_conf.h, enough to build the code under test */
+
+#define DSP_CONV_ENABLE    (1)
+#define DSP_DYN_ENABLE     (1)
+#define SW_PLL_ENABLE      (1)
+#define CORE_LOAD_ENABLE   (1)
+#define METER_ENABLE       (1)
+#define XRUN_ENABLE        (1)
+#define LATENCY_ENABLE     (1)
+
+#define NUM_USB_CHAN_OUT   (4)
+#define NUM_USB_CHAN_IN    (4)
+#define MAX_FREQ           (192000)
+
+/* Simulated reference timer, set by test_xrun.c and test_latency_stages.c */
+extern unsigned g_testTime;
+#define XRUN_TIME()        (g_testTime)
+#define LATENCY_TIME()     (g_testTime)
+
+#endif
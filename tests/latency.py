@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Measures the host to host round trip latency of a USB Audio device, and where it is spent in a
+device built with LATENCY_ENABLE (app_usb_aud_xk_316_mc/src/extensions/latency.h).
+
+A marker sample (LATENCY_MARKER) is played on one channel in silence and looked for on the same
+channel of the recording, in one full duplex PortAudio stream. The round trip is the frames
+between the marker leaving the stream's output buffer and arriving in its input buffer, so it
+includes the host's audio buffering, the USB driver and the device. The loop needs the device
+to return its outputs on its inputs: an I2S_LOOPBACK build of the 316 MC, or a cable. Through a
+cable the marker is no longer sample exact and a threshold on the level (--threshold) finds it.
+
+With --pid the device's LATENCY_ENABLE stages are armed before and read after each
+measurement with VENDOR_REQUEST_LATENCY (shared/vendor_requests.h). The frames between the
+marker arriving from USB and leaving for USB are the device's share of the round trip, those
+between I2S out and I2S in the I2S loop. --inject measures the I2S loop only, with a marker
+inserted by the firmware and no stream from the host.
+
+Needs sounddevice (PortAudio) and, for --pid, pyusb with access to the device.
+
+Usage:
+    python3 latency.py --device "XMOS xCORE.ai MC" --rates 44100 48000
+    python3 latency.py --device "XMOS xCORE.ai MC" --pid 0x16 --chans 8 8
+    python3 latency.py --pid 0x16 --inject
+"""
+import argparse
+import struct
+import time
+
+VENDOR_ID = 0x20B1
+VENDOR_REQUEST_LATENCY = 0x06
+
+# LATENCY_MARKER and LATENCY_MARKER_MASK in latency.h. The host sends and receives 32-bit
+# samples, the device passes the top 24 bits
+MARKER = 0x5A5A5A00
+MARKER_MASK = 0xFFFFFF00
+
+STAGES = ["usb_out", "i2s_out", "i2s_in", "usb_in"]
+REPORT_WORDS = 2 + 2 * len(STAGES)
+
+DEFAULT_RATES = [44100, 48000, 88200, 96000, 176400, 192000]
+
+
+class LatencyStages:
+    """
+    Marker stages of a device built with LATENCY_ENABLE, over pyusb. Vendor requests need access
+    to the device: a udev rule on Linux, and they are not possible through the Thesycon driver on
+    Windows.
+    """
+
+    def __init__(self, pid):
+        import usb.core
+
+        self.dev = usb.core.find(idVendor=VENDOR_ID, idProduct=pid)
+        if self.dev is None:
+            raise RuntimeError(f"Device {VENDOR_ID:04x}:{pid:04x} not found for the latency stages")
+
+    def arm(self, inject=False):
+        # Host to device, vendor, device recipient, no data stage
+        self.dev.ctrl_transfer(0x40, VENDOR_REQUEST_LATENCY, 1 if inject else 0, 0, None, timeout=1000)
+
+    def read(self):
+        """
+        The sample rate and, for each stage the marker has been seen at since armed, its frame
+        since the audio restarted and the reference timer
+        """
+        data = self.dev.ctrl_transfer(0xC0, VENDOR_REQUEST_LATENCY, 0, 0, 4 * REPORT_WORDS, timeout=1000)
+        if len(data) != 4 * REPORT_WORDS:
+            raise RuntimeError(f"Latency stages: expected {4 * REPORT_WORDS} bytes, got {len(data)}")
+
+        words = struct.unpack(f"<{REPORT_WORDS}I", bytes(data))
+        stages = {}
+        for i, name in enumerate(STAGES):
+            if words[1] & (1 << i):
+                stages[name] = (words[2 + 2 * i], words[3 + 2 * i])
+        return {"fs": words[0], "stages": stages}
+
+
+def stage_frames(stages, first, last):
+    """Frames from stage first to stage last, None if either was not seen"""
+    if first not in stages or last not in stages:
+        return None
+    return (stages[last][0] - stages[first][0]) & 0xFFFFFFFF
+
+
+def is_marker(sample, threshold):
+    if threshold is None:
+        return (sample & MARKER_MASK) == MARKER
+    return abs(struct.unpack("<i", struct.pack("<I", sample))[0]) >= threshold
+
+
+def measure_round_trip(device, fs, chans_out, chans_in, chan=0, settle=0.5, timeout=1.0, threshold=None):
+    """
+    Round trip in frames of a marker played on channel chan, None if it did not come back within
+    timeout seconds. The marker is played after settle seconds of silence, for the stream and
+    the device's clocks to settle
+    """
+    import sounddevice
+
+    marker_frame = int(settle * fs)
+    total_frames = marker_frame + int(timeout * fs)
+    marker = struct.pack("<I", MARKER)
+    recording = bytearray()
+    position = [0]
+
+    def callback(indata, outdata, frames, time_info, status):
+        start = position[0]
+        out = bytearray(len(outdata))
+        if start <= marker_frame < start + frames:
+            offset = 4 * ((marker_frame - start) * chans_out + chan)
+            out[offset : offset + 4] = marker
+        outdata[:] = out
+        recording.extend(indata)
+        position[0] = start + frames
+        if position[0] >= total_frames:
+            raise sounddevice.CallbackStop
+
+    with sounddevice.RawStream(
+        samplerate=fs,
+        device=device,
+        channels=(chans_in, chans_out),
+        dtype="int32",
+        callback=callback,
+    ) as stream:
+        while stream.active:
+            sounddevice.sleep(100)
+
+    for frame in range(marker_frame, len(recording) // (4 * chans_in)):
+        (sample,) = struct.unpack_from("<I", recording, 4 * (frame * chans_in + chan))
+        if is_marker(sample, threshold):
+            return frame - marker_frame
+    return None
+
+
+def measure_injected(stages, settle=0.1):
+    """I2S loop in frames with a marker inserted by the firmware, None if it did not come back"""
+    stages.arm(inject=True)
+    time.sleep(settle)
+    return stage_frames(stages.read()["stages"], "i2s_out", "i2s_in")
+
+
+def ms(frames, fs):
+    return "-" if frames is None else f"{frames} ({1000 * frames / fs:.3f}ms)"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="USB Audio round trip latency")
+    parser.add_argument("--device", help="PortAudio device name, or part of it")
+    parser.add_argument("--pid", type=lambda x: int(x, 0), help="USB product ID, to read the device's latency stages")
+    parser.add_argument("--rates", type=int, nargs="+", default=DEFAULT_RATES, help="Sample rates in Hz")
+    parser.add_argument("--chans", type=int, nargs=2, default=[2, 2], metavar=("OUT", "IN"), help="Stream channels")
+    parser.add_argument("--chan", type=int, default=0, help="Channel of the marker, LATENCY_CHAN in the firmware")
+    parser.add_argument("--threshold", type=int, help="Find the marker by level, for an analogue loop")
+    parser.add_argument("--inject", action="store_true", help="Only the I2S loop, with a marker from the firmware")
+    args = parser.parse_args()
+
+    stages = LatencyStages(args.pid) if args.pid is not None else None
+
+    if args.inject:
+        if stages is None:
+            parser.error("--inject needs --pid")
+        report = stages.read()
+        print(f"{report['fs']}Hz I2S loop: {ms(measure_injected(stages), report['fs'])}")
+        return
+
+    if args.device is None:
+        parser.error("--device is needed for the round trip")
+
+    print("Rate     Round trip            Device (USB out to USB in)  I2S loop")
+    for fs in args.rates:
+        if stages:
+            stages.arm()
+        frames = measure_round_trip(
+            args.device, fs, args.chans[0], args.chans[1], chan=args.chan, threshold=args.threshold
+        )
+        device_frames = i2s_frames = None
+        if stages:
+            report = stages.read()["stages"]
+            device_frames = stage_frames(report, "usb_out", "usb_in")
+            i2s_frames = stage_frames(report, "i2s_out", "i2s_in")
+        print(f"{fs:<8} {ms(frames, fs):<21} {ms(device_frames, fs):<27} {ms(i2s_frames, fs)}")
+
+
+if __name__ == "__main__":
+    main()
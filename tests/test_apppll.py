@@ -0,0 +1,63 @@
+from pathlib import Path
+import sys
+
+shared_dir = Path(__file__).parent.parent / "shared"
+sys.path.insert(0, str(shared_dir))
+import apppll_gen  # noqa: E402
+
+
+# The hand-derived settings that apppll.h used before apppll_table.h, as (MCLK, CTL, DIV, FRAC)
+previous_settings = [
+    (44100 * 256, 0x09009100, 0x80000009, 0x80000C10),
+    (48000 * 256, 0x0A006500, 0x80000009, 0x80000104),
+    (44100 * 512, 0x09009100, 0x8000000C, 0x80000C10),
+    (48000 * 512, 0x0A006500, 0x80000004, 0x80000104),
+    (44100 * 1024, 0x0A006F00, 0x80000002, 0x80001012),
+    (48000 * 1024, 0x0B808200, 0x80000001, 0x8000000D),
+]
+
+
+def test_apppll_decode():
+    # Documented outputs of the previous settings: 24.576MHz exact, 22.579186MHz (-0.641ppm),
+    # 45.157895MHz (-11.19ppm) and 49.151786MHz (-4.36ppm)
+    outputs = {mclk: apppll_gen.decode(ctl, div, frac) for mclk, ctl, div, frac in previous_settings}
+    assert outputs[48000 * 512] == 24576000
+    assert abs(apppll_gen.ppm(outputs[44100 * 512], 44100 * 512) - -0.641) < 0.001
+    assert abs(apppll_gen.ppm(outputs[44100 * 1024], 44100 * 1024) - -11.19) < 0.01
+    assert abs(apppll_gen.ppm(outputs[48000 * 1024], 48000 * 1024) - -4.36) < 0.01
+
+
+def test_apppll_previous():
+    # Each generated setting must be at least as accurate as the one it replaces
+    for mclk, ctl, div, frac in previous_settings:
+        s = apppll_gen.solve(mclk)
+        assert s is not None, f"No setting for {mclk}Hz"
+
+        old_ppm = apppll_gen.ppm(apppll_gen.decode(ctl, div, frac), mclk)
+        new_ppm = apppll_gen.ppm(apppll_gen.decode(s["ctl"], s["div"], s["frac"]), mclk)
+        print(f"{mclk}Hz: previous {old_ppm:.3f}ppm, generated {new_ppm:.3f}ppm")
+        assert abs(new_ppm) <= abs(old_ppm) + 0.0005
+        assert abs(new_ppm - s["ppm"]) < 0.0005
+
+        # Where it is no more accurate, it keeps the phase detector frequency of the previous
+        # setting, which was measured
+        if abs(new_ppm) >= abs(old_ppm) - 0.0005:
+            assert s["rd"] <= (ctl & 0x3F) + 1
+
+
+def test_apppll_limits():
+    # Generated settings fit the register fields and PLL limits, and decode to what they claim
+    for mclk in apppll_gen.DEFAULT_MCLKS + [16000 * 512, 32000 * 512]:
+        s = apppll_gen.solve(mclk)
+        assert s is not None, f"No setting for {mclk}Hz"
+        assert apppll_gen.decode(s["ctl"], s["div"], s["frac"]) == s["out"]
+        assert apppll_gen.VCO_MIN_HZ <= s["vco"] <= apppll_gen.VCO_MAX_HZ
+        assert apppll_gen.REF_HZ / s["rd"] >= apppll_gen.PFD_MIN_HZ
+        assert s["n"] <= apppll_gen.FRAC_N_MAX
+        assert abs(s["ppm"]) < 2
+
+
+def test_apppll_table():
+    # The table built into the applications is up to date with the generator
+    table = (shared_dir / "apppll_table.h").read_text()
+    assert table == apppll_gen.table(apppll_gen.DEFAULT_MCLKS)
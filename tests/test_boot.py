@@ -0,0 +1,113 @@
+from pathlib import Path
+import platform
+import pytest
+import re
+import subprocess
+import time
+
+from usb_audio_test_utils import (
+    get_firmware_path,
+    get_xtag_dut,
+    product_str_from_board_config,
+    query_device_found,
+    stop_xrun_app,
+)
+
+
+# Boot phase timestamps (shared/boot_time.h), from the "boottime" test support configs built with
+# BOOT_TIME_REPORT=1. These use the default (UAC 2.0) settings of each app.
+boot_testcases = [
+    ("xk_316_mc", "boottime"),
+    ("xk_evk_xu316", "boottime"),
+]
+
+# Phases each app marks, in the order they must happen
+boot_phases = {
+    "xk_316_mc": ["board_setup", "hw_init_start", "hw_init_done", "codec_ready", "first_audio"],
+    "xk_evk_xu316": ["hw_init_start", "hw_init_done", "codec_ready", "first_audio"],
+}
+
+# Limits in ms from the first mark on the time to first audio: the audio thread running with the
+# codecs configured and unmuted. On the EVK this includes the CODEC's 2.5s headphone soft-step,
+# which runs in the background while the audio thread starts with the CODEC muted.
+boot_limits_ms = {
+    "xk_316_mc": {"first_audio": 600},
+    "xk_evk_xu316": {"first_audio": 3500},
+}
+
+timer_ticks_per_ms = 100000
+
+
+def boot_uncollect(pytestconfig, board, config):
+    # XTAG not present
+    return not get_xtag_dut(pytestconfig, board)
+
+
+def run_boot(adapter_id, board, config):
+    firmware = get_firmware_path(board, config)
+    proc = subprocess.Popen(
+        ["xrun", "--adapter-id", adapter_id, "--xscope", firmware],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+        text=True,
+    )
+
+    try:
+        prod_str = product_str_from_board_config(board, "2")
+        enumerated = False
+        for _ in range(30):
+            time.sleep(1)
+            if query_device_found(prod_str):
+                enumerated = True
+                break
+
+        # Give the CODEC bring-up time to finish after enumeration
+        time.sleep(5)
+    finally:
+        # Terminating xrun leaves xgdb running, kill all xgdb processes (see AudioAnalyzerHarness)
+        proc.terminate()
+        time.sleep(1)
+        kill_cmd = ["taskkill", "/F", "/IM", "xgdb.exe"] if platform.system() == "Windows" else ["pkill", "-9", "xgdb"]
+        subprocess.run(kill_cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, timeout=5)
+        stop_xrun_app(adapter_id)
+
+    try:
+        out, _ = proc.communicate(timeout=5)
+    except subprocess.TimeoutExpired:
+        pytest.fail("Timeout getting xrun output")
+
+    return enumerated, out.splitlines()
+
+
+@pytest.mark.uncollect_if(func=boot_uncollect)
+@pytest.mark.parametrize(["board", "config"], boot_testcases)
+def test_boot(pytestconfig, board, config):
+    adapter_id = get_xtag_dut(pytestconfig, board)
+    enumerated, lines = run_boot(adapter_id, board, config)
+
+    marks = {}
+    for line in lines:
+        m = re.match(r"^BOOT (\w+) (\d+)$", line.strip())
+        if m:
+            marks[m.group(1)] = int(m.group(2))
+
+    output = "\n".join(lines)
+    if not enumerated:
+        pytest.fail(f"Device did not enumerate\n{output}")
+
+    missing = [p for p in boot_phases[board] if p not in marks]
+    if missing:
+        pytest.fail(f"Boot phases {missing} not reported\n{output}")
+
+    # Reference timer is 32 bits, ms from the first mark
+    first = marks[boot_phases[board][0]]
+    times_ms = {p: ((marks[p] - first) & 0xFFFFFFFF) / timer_ticks_per_ms for p in boot_phases[board]}
+    print(f"Boot phases (ms): {times_ms}")
+
+    order = [times_ms[p] for p in boot_phases[board]]
+    if order != sorted(order):
+        pytest.fail(f"Boot phases out of order: {times_ms}")
+
+    for phase, limit in boot_limits_ms[board].items():
+        if times_ms[phase] > limit:
+            pytest.fail(f"{phase} at {times_ms[phase]:.1f}ms, limit {limit}ms: {times_ms}")
@@ -0,0 +1,108 @@
+from pathlib import Path
+import pytest
+import re
+import shutil
+import subprocess
+
+
+# Host builds of application code, see host_tests/Makefile
+host_dir = Path(__file__).parent / "host_tests"
+
+
+def run_host_test(name):
+    if any(shutil.which(tool) is None for tool in ["make", "gcc", "g++"]):
+        pytest.skip("make, gcc and g++ are required for host tests")
+
+    ret = subprocess.run(["make", "-C", host_dir, name], capture_output=True, text=True, timeout=120)
+    assert ret.returncode == 0, f"Build of {name} failed\n{ret.stdout}\n{ret.stderr}"
+
+    ret = subprocess.run([host_dir / name], capture_output=True, text=True, timeout=600)
+    print(ret.stdout)
+    assert ret.returncode == 0, f"{name} failed\n{ret.stdout}\n{ret.stderr}"
+    return ret.stdout
+
+
+def test_conv():
+    run_host_test("test_conv")
+
+
+def test_asrc():
+    run_host_test("test_asrc")
+
+
+def test_dyn():
+    run_host_test("test_dyn")
+
+
+def test_regcache():
+    run_host_test("test_regcache")
+
+
+def test_sw_pll():
+    run_host_test("test_sw_pll")
+
+
+def test_core_load():
+    run_host_test("test_core_load")
+
+
+def test_event_trace():
+    run_host_test("test_event_trace")
+
+
+def test_meter():
+    run_host_test("test_meter")
+
+
+def test_xrun():
+    run_host_test("test_xrun")
+
+
+def test_latency_stages():
+    run_host_test("test_latency_stages")
+
+
+# Codec configuration profiles (test_audiohw.cpp), per board and application configuration. The
+# EVK applications share one audiohw.xc, extrai2s builds it with its own xua_conf.h
+audiohw_profiles = ["316_async", "316_sync", "216_async", "216_sync", "216_keepregs", "evk_async", "evk_extrai2s"]
+audiohw_profile_fields = ["transactions", "bytes", "total_us"]
+
+
+def audiohw_profile_steps(text, profile):
+    """(step, fields) of each PROFILE line of profile in text"""
+    steps = []
+    for line in text.splitlines():
+        words = line.split()
+        if len(words) > 2 and words[0] == "PROFILE" and words[1] == profile:
+            steps.append((words[2], {k: int(v) for k, v in re.findall(r"(\w+)=(\d+)", line)}))
+    return steps
+
+
+@pytest.mark.parametrize("profile", audiohw_profiles)
+def test_audiohw_profile(profile):
+    # Time spent in AudioHwInit() and each AudioHwConfig() (and on the EVK, the unmute from the
+    # audio thread) must not increase over the profile
+    # checked in. After an intended increase (or to keep a decrease) regenerate it with
+    # "make -C host_tests audiohw_profile"
+    current = audiohw_profile_steps(run_host_test(f"test_audiohw_{profile}"), profile)
+    baseline = audiohw_profile_steps((host_dir / "audiohw_profile.txt").read_text(), profile)
+    assert [s for s, _ in current] == [s for s, _ in baseline], "Steps differ from audiohw_profile.txt"
+
+    increases = []
+    for (step, fields), (_, base) in zip(current, baseline):
+        for f in audiohw_profile_fields:
+            if fields[f] > base[f]:
+                increases.append(f"{step} {f} {base[f]} -> {fields[f]}")
+            elif fields[f] < base[f]:
+                print(f"{step} {f} {base[f]} -> {fields[f]}, audiohw_profile.txt can be updated")
+
+    assert not increases, "Increases over audiohw_profile.txt:\n" + "\n".join(increases)
+
+
+# I2C speed of the 316 MC: fast-mode unless the CS2100 is on the bus (I2C_SPEED_KBPS in
+# user_main.h). This must be an expression rather than an #if, which would be evaluated before
+# lib_xua defines XUA_SYNCMODE and give 100kbps for every config
+@pytest.mark.parametrize(["profile", "kbps"], [("316_async", 400), ("316_sync", 100)])
+def test_audiohw_i2c_speed(profile, kbps):
+    steps = audiohw_profile_steps(run_host_test(f"test_audiohw_{profile}"), profile)
+    assert steps and all(fields["kbps"] == kbps for _, fields in steps)
@@ -0,0 +1,77 @@
+import pytest
+import os
+import platform
+
+from usb_audio_test_utils import get_xtag_dut, XrunDut
+from conftest import list_configs, get_config_features
+from latency import LatencyStages, measure_injected, measure_round_trip, stage_frames
+
+
+# I2S loopback builds of the configs with latency measurement (LATENCY_ENABLE), where the marker
+# comes back sample exact
+latency_configs = [
+    ("xk_316_mc", "2AMi8o8xxxxxx_latency_i2sloopback"),
+]
+
+
+def latency_uncollect(pytestconfig, board, config):
+    # Check if the configs are present for this test level
+    if (board, config) not in list_configs():
+        return True
+    # XTAG not present
+    if not get_xtag_dut(pytestconfig, board):
+        return True
+    # The vendor requests cannot be sent through the Thesycon driver
+    if platform.system() == "Windows":
+        return True
+    # Recording from Python is not possible under the MacOS privacy restrictions that need the
+    # xsig workaround
+    if platform.system() == "Darwin" and os.environ.get("USBA_MAC_PRIV_WORKAROUND", None) == "1":
+        return True
+    return False
+
+
+@pytest.mark.uncollect_if(func=latency_uncollect)
+@pytest.mark.parametrize(["board", "config"], latency_configs)
+def test_latency(pytestconfig, record_property, board, config):
+    features = get_config_features(board, config)
+    adapter_dut = get_xtag_dut(pytestconfig, board)
+    fail_str = ""
+
+    with XrunDut(adapter_dut, board, config) as dut:
+        stages = LatencyStages(features["pid"])
+
+        for fs in features["samp_freqs"]:
+            stages.arm()
+            frames = measure_round_trip(dut.dev_name, fs, features["chan_o"], features["chan_i"])
+            report = stages.read()
+            seen = report["stages"]
+
+            if frames is None:
+                fail_str += f"Marker not received at sample rate {fs}\n"
+                continue
+            if report["fs"] != fs:
+                fail_str += f"Device at {report['fs']} instead of sample rate {fs}\n"
+                continue
+            missing = [name for name in ["usb_out", "i2s_out", "i2s_in", "usb_in"] if name not in seen]
+            if missing:
+                fail_str += f"Marker not seen at {', '.join(missing)} at sample rate {fs}\n"
+                continue
+
+            device_frames = stage_frames(seen, "usb_out", "usb_in")
+            i2s_frames = stage_frames(seen, "i2s_out", "i2s_in")
+            if device_frames > frames:
+                fail_str += f"Device latency {device_frames} over the round trip {frames} at sample rate {fs}\n"
+
+            # The I2S loop with the firmware's own marker, which must match the host's
+            injected_frames = measure_injected(stages)
+            if injected_frames != i2s_frames:
+                fail_str += f"I2S loop {injected_frames} with injected marker, {i2s_frames} from host at sample rate {fs}\n"
+
+            # Recorded with the JUnit results, to follow the latency across releases
+            record_property(f"round_trip_frames_{fs}", frames)
+            record_property(f"device_frames_{fs}", device_frames)
+            record_property(f"i2s_loop_frames_{fs}", i2s_frames)
+
+    if fail_str:
+        pytest.fail(fail_str)
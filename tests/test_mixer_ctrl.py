@@ -328,3 +328,65 @@ def test_routing_daw_out_mix_input(pytestconfig, ctrl_app, board, config):
         fail_str += "xscope stdout\n"
         fail_str += "\n".join(xscope_lines)
         pytest.fail(fail_str)
+
+
+monitor_configs = [
+    ("xk_216_mc", "2AMi8o8xxxxxx_mon"),
+    ("xk_316_mc", "2AMi8o8xxxxxx_mon"),
+]
+
+# Direct monitor controls (shared/direct_monitor.h), driven with the mixer app's audio request options
+MONITOR_UNIT_ID = 0xD0
+MONITOR_CS_GAIN = 1
+MONITOR_CS_CYCLES = 2
+AUDIO_REQ_CUR = 1
+
+
+def set_monitor_gain(ctrl_app, num_outputs, input_chan, output_chan, gain):
+    # Gain is 2 bytes in 1/256 dB, 0x8000 (-inf) removes the route
+    value = 0x8000 if gain is None else int(gain * 256) & 0xFFFF
+    cn = (input_chan * num_outputs) + output_chan
+    mixer_cmd = [ctrl_app, "--vendor-audio-request-set", f"{AUDIO_REQ_CUR}", f"{MONITOR_CS_GAIN}", f"{cn}",
+                 f"{MONITOR_UNIT_ID}", f"{value & 0xFF}", f"{value >> 8}"]
+    return subprocess.run(mixer_cmd, timeout=10)
+
+
+@pytest.mark.uncollect_if(func=mixer_uncollect)
+@pytest.mark.parametrize(["board", "config"], monitor_configs)
+def test_direct_monitor(pytestconfig, ctrl_app, board, config):
+    features = get_config_features(board, config)
+    # The analyzer plays the input config sines into the analogue inputs
+    xsig_config_path = Path(__file__).parent / "xsig_configs" / "mc_analogue_input_8ch.json"
+    adapter_dut, adapter_harness = get_xtag_dut_and_harness(pytestconfig, board)
+    duration = 10
+    fail_str = ""
+
+    with (
+        XrunDut(adapter_dut, board, config) as dut,
+        AudioAnalyzerHarness(adapter_harness, xscope="io") as harness,
+    ):
+
+        # Monitor analogue input N on analogue output N at 0dB, with nothing playing from the host
+        num_chans = min(features["analogue_i"], features["analogue_o"])
+        for ch in range(num_chans):
+            ret = set_monitor_gain(ctrl_app, features["chan_o"], ch, ch, 0)
+            assert ret.returncode == 0, f"Setting monitor route {ch} failed"
+
+        time.sleep(duration)
+        harness.terminate()
+        xscope_lines = harness.get_output()
+
+        # The cycle cost must be readable while running
+        mixer_cmd = [ctrl_app, "--vendor-audio-request-get", f"{AUDIO_REQ_CUR}", f"{MONITOR_CS_CYCLES}", "0",
+                     f"{MONITOR_UNIT_ID}"]
+        ret = subprocess.run(mixer_cmd, capture_output=True, text=True, timeout=10)
+        assert ret.returncode == 0, f"Reading monitor cycle cost failed\n{ret.stdout}\n{ret.stderr}"
+
+    with open(xsig_config_path) as file:
+        xsig_json = json.load(file)
+    failures = check_analyzer_output(xscope_lines, xsig_json["in"][:num_chans])
+    if len(failures) > 0:
+        fail_str += "\n".join(failures) + "\n\n"
+        fail_str += "xscope stdout\n"
+        fail_str += "\n".join(xscope_lines)
+        pytest.fail(fail_str)
@@ -0,0 +1,80 @@
+from pathlib import Path
+import pytest
+import time
+import platform
+
+from usb_audio_test_utils import (
+    get_xtag_dut,
+    XrunCounters,
+    XrunDut,
+    XsigInput,
+)
+from conftest import list_configs, get_config_features
+
+
+# I2S loopback builds of the configs with the dropout counters (XRUN_ENABLE), so the audio goes
+# through both directions without the analyzer harness. xsig plays a sine, never silent, so a
+# silence gap in either direction is a dropout. The SW PLL config is only listed when
+# xk_316_mc_sw_pll_ref_link is set (see conftest.py)
+xrun_configs = [
+    ("xk_316_mc", "2AMi8o8xxxxxx_xrun_i2sloopback"),
+    ("xk_316_mc", "2SMi8o8xxxxxx_swpll_xrun_i2sloopback"),
+]
+
+# Time for the stream to start and the clocks to settle before the counters are reset
+XRUN_SETTLE_SECONDS = 2
+
+
+def xrun_uncollect(pytestconfig, board, config):
+    # Check if the configs are present for this test level
+    if (board, config) not in list_configs():
+        return True
+    # XTAG not present
+    if not get_xtag_dut(pytestconfig, board):
+        return True
+    # The vendor requests cannot be sent through the Thesycon driver
+    if platform.system() == "Windows":
+        return True
+    return False
+
+
+def xrun_duration(level):
+    if level == "weekend":
+        return 600
+    elif level == "nightly":
+        return 60
+    return 10
+
+
+@pytest.mark.uncollect_if(func=xrun_uncollect)
+@pytest.mark.parametrize(["board", "config"], xrun_configs)
+def test_xrun_counters(pytestconfig, board, config):
+    features = get_config_features(board, config)
+    xsig_config_path = Path(__file__).parent / "xsig_configs" / "mc_i2s_loopback_2ch.json"
+    adapter_dut = get_xtag_dut(pytestconfig, board)
+    duration = xrun_duration(pytestconfig.getoption("level"))
+    fail_str = ""
+
+    with XrunDut(adapter_dut, board, config) as dut:
+        counters = XrunCounters(features["pid"])
+
+        for fs in features["samp_freqs"]:
+            with XsigInput(fs, duration + XRUN_SETTLE_SECONDS, xsig_config_path, dut.dev_name):
+                time.sleep(XRUN_SETTLE_SECONDS)
+                counters.reset()
+
+                # Poll once a second, so a dropout fails the test within a second of it happening
+                for elapsed in range(duration):
+                    time.sleep(1)
+                    counts = counters.read()
+                    dropouts = counters.dropouts(counts)
+                    if dropouts:
+                        fail_str += f"Dropout at sample rate {fs} after {elapsed + 1}s\n"
+                        fail_str += "\n".join(f"{name}: {count}" for name, count in counts.items()) + "\n\n"
+                        break
+
+            if fail_str:
+                break
+
+    if fail_str:
+        pytest.fail(fail_str)
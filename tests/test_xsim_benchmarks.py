@@ -0,0 +1,151 @@
+from pathlib import Path
+import pytest
+import re
+import shutil
+import subprocess
+
+
+# Benchmarks are built from tests/xsim_benchmarks, one config per benchmark/parameter set
+bench_dir = Path(__file__).parent / "xsim_benchmarks"
+
+transport_configs = [f"transport_bs{bs}" for bs in [1, 2, 4, 8, 16]]
+eq_configs = [f"eq_ch{chans}" for chans in [2, 8, 16]]
+monitor_configs = [f"monitor_r{routes}" for routes in [0, 8, 16]]
+
+
+def run_xsim_benchmark(config):
+    if shutil.which("xsim") is None:
+        pytest.fail("xsim not found on the PATH")
+
+    xe = bench_dir / "bin" / config / f"xsim_benchmarks_{config}.xe"
+    if not xe.exists():
+        pytest.fail(f"Benchmark not built: {xe}")
+
+    ret = subprocess.run(["xsim", xe], capture_output=True, text=True, timeout=600)
+    results = []
+    for line in ret.stdout.splitlines():
+        if line.startswith("BENCH "):
+            fields = dict(re.findall(r"(\w+)=(\d+)", line))
+            results.append({k: int(v) for k, v in fields.items()})
+
+    if not results:
+        pytest.fail(f"No benchmark output from {xe}\n{ret.stdout}\n{ret.stderr}")
+
+    return results
+
+
+@pytest.mark.parametrize("config", transport_configs)
+def test_transport_cycles(config, record_property):
+    result = run_xsim_benchmark(config)[0]
+    record_property("ticks_per_frame", result["ticks_per_frame"])
+    record_property("ticks_max", result["ticks_max"])
+    print(
+        f"block size {result['block_size']}: {result['ticks_per_frame']} ticks per frame, "
+        f"{result['ticks_max']} ticks in the exchange frame"
+    )
+
+    # The whole block is exchanged in one call, which must still leave time in the frame for the
+    # rest of the audio thread
+    assert result["ticks_per_frame"] < result["frame_budget"]
+    assert result["ticks_max"] < result["frame_budget"]
+
+
+@pytest.mark.parametrize("config", eq_configs)
+def test_eq_cycles(config, record_property):
+    result = run_xsim_benchmark(config)[0]
+    record_property("ticks_per_frame", result["ticks_per_frame"])
+    record_property("ticks_per_section_x100", result["ticks_per_section_x100"])
+    print(
+        f"{result['chans']} chans x {result['sections']} sections: {result['ticks_per_frame']} ticks per frame, "
+        f"{result['ticks_per_section_x100'] / 100} ticks per channel-section"
+    )
+
+    # Vectorised, so up to 8 channels cost the same as one
+    if result["chans"] <= 8:
+        assert result["ticks_per_frame"] < result["frame_budget"]
+
+
+@pytest.mark.parametrize("suffix", ["", "_tdm16"])
+def test_extrai2s_ring_cycles(suffix, record_property):
+    chan = run_xsim_benchmark(f"extrai2s_chan{suffix}")[0]
+    ring = run_xsim_benchmark(f"extrai2s_ring{suffix}")[0]
+    record_property("ticks_per_call_chan", chan["ticks_per_call"])
+    record_property("ticks_per_call_ring", ring["ticks_per_call"])
+    print(
+        f"{ring['chans']} chans, 192kHz frame of {ring['frame_budget']} ticks: channel handshake {chan['ticks_per_call']} ticks, "
+        f"ring {ring['ticks_per_call']} ticks, {ring['ticks_returned'] - chan['ticks_returned']} ticks returned"
+    )
+
+    assert ring["ticks_per_call"] < chan["ticks_per_call"]
+
+
+def test_asrc_cycles(record_property):
+    results = run_xsim_benchmark("asrc")
+    by_chans = {r["chans"]: r for r in results}
+
+    # Coefficients are once per frame whatever the channel count, filtering is per channel
+    coefs = by_chans[1]["ticks_coefs_x100"] / 100
+    per_chan = (by_chans[8]["ticks_filter_x100"] - by_chans[1]["ticks_filter_x100"]) / (7 * 100)
+    record_property("ticks_coefs", coefs)
+    record_property("ticks_per_chan", per_chan)
+
+    for fs in [48000, 96000, 192000]:
+        period = 100_000_000 / fs
+        record_property(f"thread_percent_per_chan_{fs}", round(100 * per_chan / period, 1))
+        record_property(f"thread_percent_coefs_{fs}", round(100 * coefs / period, 1))
+        print(
+            f"{fs}Hz: {100 * per_chan / period:.1f}% of a thread per channel, "
+            f"plus {100 * coefs / period:.1f}% per frame shared across the ASRC threads"
+        )
+
+    # The default build (2 channels on 2 threads) must keep up at 192kHz
+    assert (coefs / 2) + per_chan < 100_000_000 / 192000
+
+
+@pytest.mark.parametrize("config", monitor_configs)
+def test_monitor_cycles(config, record_property):
+    result = run_xsim_benchmark(config)[0]
+    record_property("ticks_per_frame", result["ticks_per_frame"])
+    print(
+        f"{result['routes']} routes: {result['ticks_per_frame']} ticks per frame, "
+        f"reported avg {result['reported_avg']} max {result['reported_max']}"
+    )
+
+    # The cost reported over USB must agree with the measurement around the calls
+    assert result["reported_avg"] <= result["ticks_per_frame"]
+
+    # The full 16 routes must fit in a small part of a 192kHz frame
+    assert result["ticks_per_frame"] < result["frame_budget"] / 4
+
+
+def test_dyn_cycles(record_property):
+    results = run_xsim_benchmark("dyn")
+
+    for result in results:
+        name = f"{result['samp_freq']}_{'linked' if result['link'] else 'independent'}"
+        record_property(f"ticks_per_frame_{name}", result["ticks_per_frame"])
+        print(
+            f"{result['samp_freq']}Hz {result['chans']} chans {'linked' if result['link'] else 'independent'}: "
+            f"{result['ticks_per_frame']} ticks per frame, {100 * result['ticks_per_frame'] / result['frame_budget']:.1f}% of a thread"
+        )
+
+        # Cost is per frame, not per second, so one thread covers all 8 DAC outputs up to 96kHz.
+        # 192kHz needs the channels split over DSP threads (DSP_NUM_THREADS)
+        if result["samp_freq"] <= 96000:
+            assert result["ticks_per_frame"] < result["frame_budget"]
+        else:
+            assert result["ticks_per_frame"] < 4 * result["frame_budget"]
+
+
+def test_audiohw_service_cycles(record_property):
+    par = run_xsim_benchmark("audiohw_par")[0]
+    service = run_xsim_benchmark("audiohw_service")[0]
+    record_property("ticks_per_config_par", par["ticks_per_config"])
+    record_property("ticks_per_config_service", service["ticks_per_config"])
+    print(
+        f"{service['writes']} register writes ({service['bus_ticks']} ticks on the bus): I2C master per call "
+        f"{par['ticks_per_config']} ticks, codec service {service['ticks_per_config']} ticks"
+    )
+
+    # Sending the sequence to the service must cost no more than a small part of the bus time
+    assert service["ticks_per_config"] < service["bus_ticks"] * 1.01
@@ -9,6 +9,8 @@ import stat
 import re
 import shutil
 import socket
+import struct
+import usb.core
 
 from conftest import get_config_features
 
@@ -541,3 +543,57 @@ class XsigOutput(XsigProcess):
     """
 
     pass
+
+
+class XrunCounters:
+    """
+    Dropout counters of a device built with XRUN_ENABLE
+
+    The firmware counts I2S slips, silence gaps in the audio per direction, audio restarts and MCLK PLL
+    lock problems (app_usb_aud_xk_316_mc/src/extensions/xrun.h). They are read and reset with the
+    VENDOR_REQUEST_XRUN control request (shared/vendor_requests.h), so a test can check for
+    dropouts while the audio is running instead of after xsig has finished.
+
+    Vendor requests go to the device with pyusb, which needs access to the device: a udev rule
+    on Linux, and it is not possible through the Thesycon driver on Windows.
+    """
+
+    VENDOR_ID = 0x20B1
+    VENDOR_REQUEST_XRUN = 0x05
+    COUNTERS = [
+        "i2s_slips",
+        "frames_lost",
+        "out_silence_gaps",
+        "in_silence_gaps",
+        "restarts",
+        "pll_lock_fails",
+        "pll_slips",
+        "pll_unlocks",
+    ]
+
+    def __init__(self, pid):
+        self.dev = usb.core.find(idVendor=self.VENDOR_ID, idProduct=pid)
+        if self.dev is None:
+            pytest.fail(f"Device {self.VENDOR_ID:04x}:{pid:04x} not found for the dropout counters")
+
+    def read(self):
+        # Device to host, vendor, device recipient
+        data = self.dev.ctrl_transfer(0xC0, self.VENDOR_REQUEST_XRUN, 0, 0, 4 * len(self.COUNTERS), timeout=1000)
+        if len(data) != 4 * len(self.COUNTERS):
+            pytest.fail(f"Dropout counters: expected {4 * len(self.COUNTERS)} bytes, got {len(data)}")
+        return dict(zip(self.COUNTERS, struct.unpack(f"<{len(self.COUNTERS)}I", bytes(data))))
+
+    def reset(self):
+        # Host to device, no data stage
+        self.dev.ctrl_transfer(0x40, self.VENDOR_REQUEST_XRUN, 0, 0, None, timeout=1000)
+
+    def dropouts(self, counts=None):
+        """
+        Counters other than frames_lost that are non-zero, as a list of "name: count" strings
+
+        The silence gaps are dropouts only while the audio in that direction is never silent (see
+        xrun.h), so pass a signal without silence, as the xsig sine is.
+        """
+        if counts is None:
+            counts = self.read()
+        return [f"{name}: {count}" for name, count in counts.items() if count and name != "frames_lost"]
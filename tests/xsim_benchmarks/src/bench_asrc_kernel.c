@@ -0,0 +1,38 @@
+/* ASRC benchmark set-up and processing, in C as asrc_t is not usable from XC */
+#include "xua_conf.h"
+
+#if (BENCH_ASRC)
+#include "../../../app_usb_aud_xk_evk_xu316_extrai2s/src/extensions/asrc.c"
+
+static asrc_t g_asrc;
+static int32_t g_coefs[ASRC_TAPS];
+static int32_t g_frame[ASRC_MAX_CHANS];
+
+void bench_asrc_init(unsigned numChans)
+{
+    asrc_init_filter();
+    asrc_init(&g_asrc, numChans);
+
+    for(unsigned i = 0; i < ASRC_TAPS; i++)
+    {
+        for(unsigned ch = 0; ch < ASRC_MAX_CHANS; ch++)
+        {
+            g_frame[ch] = (int32_t)((i * ASRC_MAX_CHANS + ch) * 0x01234567);
+        }
+        asrc_push(&g_asrc, g_frame);
+    }
+}
+
+void bench_asrc_coefs(unsigned frame)
+{
+    /* A different phase each frame */
+    asrc_coefs(g_coefs, frame * 0x9E3779B9);
+}
+
+/* One output frame as the ASRC threads do it: push the input frame then filter */
+void bench_asrc_filter()
+{
+    asrc_push(&g_asrc, g_frame);
+    asrc_output(&g_asrc, g_coefs, g_frame);
+}
+#endif
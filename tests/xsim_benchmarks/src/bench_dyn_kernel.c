@@ -0,0 +1,38 @@
+/* Compressor/limiter benchmark set-up and processing, in C as dyn_t is not usable from XC */
+#include "xua_conf.h"
+
+#if (BENCH_DYN)
+#include <string.h>
+#include "../../../app_usb_aud_xk_316_mc/src/dsp/dynamics.c"
+
+/* Laid out as a DSP block, outputs followed by inputs */
+#define BENCH_DYN_STRIDE    (2 * BENCH_DYN_CHANS)
+
+static dyn_t g_dyn;
+static int32_t g_noise[BENCH_DYN_FRAMES * BENCH_DYN_STRIDE];
+static int32_t g_samples[BENCH_DYN_FRAMES * BENCH_DYN_STRIDE];
+
+void bench_dyn_init(unsigned samFreq, unsigned link)
+{
+    uint32_t seed = 1;
+
+    dyn_init(&g_dyn, BENCH_DYN_CHANS, samFreq);
+    dyn_set_param(&g_dyn, DYN_PARAM_LINK, link);
+
+    /* Makeup gain keeps the noise over the ceiling, so the limiter gain is calculated for every frame */
+    dyn_set_param(&g_dyn, DYN_PARAM_COMP_MAKEUP, 12 * 256);
+
+    for(unsigned i = 0; i < BENCH_DYN_FRAMES * BENCH_DYN_STRIDE; i++)
+    {
+        seed = (seed * 1664525) + 1013904223;
+        g_noise[i] = (int32_t) seed;
+    }
+}
+
+/* Includes copying in a fresh block, a small part of the total */
+void bench_dyn_process()
+{
+    memcpy(g_samples, g_noise, sizeof(g_samples));
+    dyn_process(&g_dyn, g_samples, BENCH_DYN_FRAMES, BENCH_DYN_STRIDE);
+}
+#endif
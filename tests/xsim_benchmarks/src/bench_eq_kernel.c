@@ -0,0 +1,46 @@
+/* EQ benchmark set-up and processing, in C as eq_t is not usable from XC */
+#include "xua_conf.h"
+
+#if (BENCH_EQ)
+#include "../../../app_usb_aud_xk_316_mc/src/dsp/eq.c"
+
+static eq_t g_eq;
+static int32_t g_samples[BENCH_EQ_FRAMES * EQ_MAX_CHANS];
+
+/* Every channel runs EQ_MAX_SECTIONS bands, the worst case */
+static const eq_band_t g_bands[] =
+{
+    {EQ_HIGHPASS,   20.0f,    0.707f, 0.0f},
+    {EQ_LOWSHELF,   120.0f,   0.707f, 3.0f},
+    {EQ_PEAKING,    500.0f,   1.0f,   -3.0f},
+    {EQ_PEAKING,    1000.0f,  1.0f,   2.0f},
+    {EQ_PEAKING,    2000.0f,  2.0f,   -6.0f},
+    {EQ_PEAKING,    4000.0f,  1.0f,   1.0f},
+    {EQ_HIGHSHELF,  10000.0f, 0.707f, -2.0f},
+    {EQ_LOWPASS,    20000.0f, 0.707f, 0.0f},
+};
+
+void bench_eq_init(unsigned samFreq)
+{
+    eq_chan_conf_t conf[EQ_MAX_CHANS];
+
+    for(unsigned ch = 0; ch < EQ_MAX_CHANS; ch++)
+    {
+        conf[ch].num_bands = EQ_MAX_SECTIONS;
+        conf[ch].bands = g_bands;
+    }
+
+    eq_init(&g_eq, EQ_MAX_CHANS, conf);
+    eq_set_samp_freq(&g_eq, samFreq);
+
+    for(unsigned i = 0; i < BENCH_EQ_FRAMES * EQ_MAX_CHANS; i++)
+    {
+        g_samples[i] = (int32_t)(i * 0x01234567);
+    }
+}
+
+void bench_eq_process()
+{
+    eq_process(&g_eq, g_samples, BENCH_EQ_FRAMES, EQ_MAX_CHANS);
+}
+#endif
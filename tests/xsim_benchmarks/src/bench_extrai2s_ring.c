@@ -0,0 +1,6 @@
+/* Code under test is built from the application sources */
+#include "xua_conf.h"
+
+#if (BENCH_EXTRAI2S) && (BENCH_EXTRAI2S_RING)
+#include "../../../app_usb_aud_xk_evk_xu316_extrai2s/src/extensions/extra_i2s_ring.c"
+#endif
@@ -0,0 +1,6 @@
+/* Code under test is built from the application sources */
+#include "xua_conf.h"
+
+#if (BENCH_TRANSPORT)
+#include "../../../app_usb_aud_xk_316_mc/src/dsp/dsp_process.c"
+#endif
@@ -0,0 +1,74 @@
+#ifndef _XUA_CONF_H_
+#define _XUA_CONF_H_
+
+/* Minimal stand-in for the application xua_conf.h, enough to build the code under test */
+
+#ifndef NUM_USB_CHAN_OUT
+#define NUM_USB_CHAN_OUT   (8)
+#endif
+
+#ifndef NUM_USB_CHAN_IN
+#define NUM_USB_CHAN_IN    (8)
+#endif
+
+#ifndef BENCH_TRANSPORT
+#define BENCH_TRANSPORT    (0)
+#endif
+
+#ifndef BENCH_EQ
+#define BENCH_EQ           (0)
+#endif
+
+/* Frames per eq_process() call */
+#ifndef BENCH_EQ_FRAMES
+#define BENCH_EQ_FRAMES    (4)
+#endif
+
+#ifndef BENCH_EXTRAI2S
+#define BENCH_EXTRAI2S     (0)
+#endif
+
+#ifndef BENCH_EXTRAI2S_RING
+#define BENCH_EXTRAI2S_RING (0)
+#endif
+
+#ifndef BENCH_ASRC
+#define BENCH_ASRC         (0)
+#endif
+
+#ifndef BENCH_MONITOR
+#define BENCH_MONITOR      (0)
+#endif
+
+/* Crosspoints set up for the direct monitor benchmark */
+#ifndef BENCH_MONITOR_ROUTES
+#define BENCH_MONITOR_ROUTES (0)
+#endif
+
+#ifndef BENCH_DYN
+#define BENCH_DYN          (0)
+#endif
+
+/* Channels and frames per dyn_process() call */
+#ifndef BENCH_DYN_CHANS
+#define BENCH_DYN_CHANS    (8)
+#endif
+
+#ifndef BENCH_DYN_FRAMES
+#define BENCH_DYN_FRAMES   (4)
+#endif
+
+#ifndef BENCH_AUDIOHW
+#define BENCH_AUDIOHW      (0)
+#endif
+
+/* Persistent codec service (1) or an I2C master per configuration (0) */
+#ifndef BENCH_AUDIOHW_SERVICE
+#define BENCH_AUDIOHW_SERVICE (0)
+#endif
+
+#define DSP_ENABLE         (BENCH_TRANSPORT)
+#define DSP_EQ_ENABLE      (BENCH_EQ)
+#define DSP_DYN_ENABLE     (BENCH_DYN)
+
+#endif